@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "TaskScheduler.h"
+
+#include "mesh_cooker.h"
+
+namespace
+{
+	struct CookJob
+	{
+		fs::path sourcePath;
+		fs::path outputPath;
+	};
+
+	// Cooked file is only rewritten when its source is newer, unless cooking is forced
+	bool IsUpToDate(const CookJob& job)
+	{
+		std::error_code ec;
+
+		const auto outputTime = fs::last_write_time(job.outputPath, ec);
+		if (ec)
+			return false;
+
+		const auto sourceTime = fs::last_write_time(job.sourcePath, ec);
+
+		return !ec && outputTime >= sourceTime;
+	}
+
+	// Gather jobs for input, directories are searched recursively & keep their layout under output path
+	void AddCookJobs(const fs::path& inputPath, const fs::path& outputDir, std::vector<CookJob>& jobs)
+	{
+		if (fs::is_directory(inputPath))
+		{
+			for (const auto& entry : fs::recursive_directory_iterator(inputPath))
+			{
+				if (entry.is_regular_file() && puffin::cook::IsMeshSourceFile(entry.path()))
+				{
+					fs::path outputPath = outputDir / entry.path().lexically_relative(inputPath);
+					outputPath.replace_extension(".pmesh");
+
+					jobs.push_back({ entry.path(), outputPath });
+				}
+			}
+		}
+		else if (puffin::cook::IsMeshSourceFile(inputPath))
+		{
+			fs::path outputPath = outputDir / inputPath.filename();
+			outputPath.replace_extension(".pmesh");
+
+			jobs.push_back({ inputPath, outputPath });
+		}
+		else
+		{
+			std::cout << "Skipping " << inputPath.string() << ", not a supported mesh format" << std::endl;
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	argparse::ArgumentParser parser("PuffinCook");
+
+	parser.add_argument("inputs")
+		.help("Mesh files (.gltf, .glb, .obj) or directories to cook")
+		.nargs(argparse::nargs_pattern::at_least_one);
+
+	parser.add_argument("-o", "--output")
+		.help("Directory cooked meshes are written to")
+		.required();
+
+	parser.add_argument("-j", "--threads")
+		.help("Number of threads to cook with, 0 to use every hardware thread")
+		.default_value(0u)
+		.scan<'u', uint32_t>();
+
+	parser.add_argument("-f", "--force")
+		.help("Cook files even if their cooked output is newer than them")
+		.default_value(false)
+		.implicit_value(true);
+
+	try
+	{
+		parser.parse_args(argc, argv);
+	}
+	catch (const std::exception& err)
+	{
+		std::cerr << err.what() << std::endl;
+		std::cerr << parser;
+		return 1;
+	}
+
+	const fs::path outputDir = parser.get<std::string>("--output");
+	const bool force = parser.get<bool>("--force");
+
+	std::vector<CookJob> jobs;
+
+	for (const auto& input : parser.get<std::vector<std::string>>("inputs"))
+	{
+		AddCookJobs(input, outputDir, jobs);
+	}
+
+	if (!force)
+	{
+		jobs.erase(std::remove_if(jobs.begin(), jobs.end(), IsUpToDate), jobs.end());
+	}
+
+	if (jobs.empty())
+	{
+		std::cout << "Nothing to cook" << std::endl;
+		return 0;
+	}
+
+	uint32_t threadCount = parser.get<uint32_t>("--threads");
+
+	if (threadCount == 0)
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+	enki::TaskScheduler taskScheduler;
+	taskScheduler.Initialize(threadCount);
+
+	std::atomic<uint32_t> failedCount = 0;
+
+	// Each file is cooked on its own, so files are spread over every thread one at a time
+	enki::TaskSet task(static_cast<uint32_t>(jobs.size()), [&](enki::TaskSetPartition range, uint32_t threadIdx)
+	{
+		for (uint32_t idx = range.start; idx < range.end; ++idx)
+		{
+			if (!puffin::cook::CookMesh(jobs[idx].sourcePath, jobs[idx].outputPath))
+				++failedCount;
+		}
+	});
+
+	task.m_MinRange = 1;
+
+	taskScheduler.AddTaskSetToPipe(&task);
+	taskScheduler.WaitforTask(&task);
+
+	taskScheduler.WaitforAllAndShutdown();
+
+	std::cout << "Cooked " << jobs.size() - failedCount << " of " << jobs.size() << " meshes" << std::endl;
+
+	return failedCount == 0 ? 0 : 1;
+}
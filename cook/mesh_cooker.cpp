@@ -0,0 +1,523 @@
+#include "mesh_cooker.h"
+
+#define TINYGLTF_IMPLEMENTATION
+#define TINYGLTF_NO_STB_IMAGE
+#define TINYGLTF_NO_STB_IMAGE_WRITE
+#define TINYGLTF_NO_EXTERNAL_IMAGE
+
+#define TINYOBJLOADER_IMPLEMENTATION
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include "tiny_gltf.h"
+#include "tinyobjloader/tiny_obj_loader.h"
+
+namespace puffin::cook
+{
+	namespace
+	{
+		// Images are never needed to cook meshes, so they are skipped rather than decoded
+		bool SkipGltfImage(tinygltf::Image*, const int, std::string*, std::string*, int, int, const unsigned char*, int, void*)
+		{
+			return true;
+		}
+
+		/*
+		 * Read each element of accessor into out, handles accessor offsets & interleaved buffer views,
+		 * returns false if accessor isn't of expected type or lies outside of its buffer
+		 */
+		template<typename T>
+		bool ReadGltfAccessor(const tinygltf::Model& model, int accessorIdx, int componentType, int type, std::vector<T>& out)
+		{
+			out.clear();
+
+			if (accessorIdx < 0 || accessorIdx >= static_cast<int>(model.accessors.size()))
+				return false;
+
+			const auto& accessor = model.accessors[accessorIdx];
+
+			if (accessor.componentType != componentType || accessor.type != type || accessor.sparse.isSparse
+				|| accessor.bufferView < 0 || accessor.bufferView >= static_cast<int>(model.bufferViews.size()))
+				return false;
+
+			const auto& bufferView = model.bufferViews[accessor.bufferView];
+
+			if (bufferView.buffer < 0 || bufferView.buffer >= static_cast<int>(model.buffers.size()))
+				return false;
+
+			const auto& buffer = model.buffers[bufferView.buffer];
+
+			const int byteStride = accessor.ByteStride(bufferView);
+			if (byteStride < static_cast<int>(sizeof(T)))
+				return false;
+
+			const size_t byteOffset = bufferView.byteOffset + accessor.byteOffset;
+
+			if (accessor.count > 0
+				&& byteOffset + (accessor.count - 1) * static_cast<size_t>(byteStride) + sizeof(T) > buffer.data.size())
+				return false;
+
+			out.resize(accessor.count);
+
+			// Packed data is copied with a single command, interleaved data one element at a time
+			if (byteStride == static_cast<int>(sizeof(T)))
+			{
+				std::memcpy(out.data(), buffer.data.data() + byteOffset, accessor.count * sizeof(T));
+			}
+			else
+			{
+				for (size_t idx = 0; idx < accessor.count; ++idx)
+				{
+					std::memcpy(&out[idx], buffer.data.data() + byteOffset + idx * byteStride, sizeof(T));
+				}
+			}
+
+			return true;
+		}
+
+		bool ReadGltfIndices(const tinygltf::Model& model, int accessorIdx, std::vector<uint32_t>& indices)
+		{
+			if (accessorIdx < 0 || accessorIdx >= static_cast<int>(model.accessors.size()))
+				return false;
+
+			switch (model.accessors[accessorIdx].componentType)
+			{
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+			{
+				std::vector<uint8_t> indices8;
+				if (!ReadGltfAccessor(model, accessorIdx, TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE, TINYGLTF_TYPE_SCALAR, indices8))
+					return false;
+
+				indices.assign(indices8.begin(), indices8.end());
+				return true;
+			}
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+			{
+				std::vector<uint16_t> indices16;
+				if (!ReadGltfAccessor(model, accessorIdx, TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, TINYGLTF_TYPE_SCALAR, indices16))
+					return false;
+
+				indices.assign(indices16.begin(), indices16.end());
+				return true;
+			}
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+				return ReadGltfAccessor(model, accessorIdx, TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT, TINYGLTF_TYPE_SCALAR, indices);
+			default:
+				return false;
+			}
+		}
+
+		void GenerateTangents(rendering::VertexPNTV32* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount)
+		{
+			std::vector<Vector3f> tangents(vertexCount);
+			std::vector<Vector3f> bitangents(vertexCount);
+
+			for (size_t idx = 0; idx + 2 < indexCount; idx += 3)
+			{
+				const uint32_t i1 = indices[idx];
+				const uint32_t i2 = indices[idx + 1];
+				const uint32_t i3 = indices[idx + 2];
+
+				const Vector3f& v1 = vertices[i1].pos;
+				const Vector3f& v2 = vertices[i2].pos;
+				const Vector3f& v3 = vertices[i3].pos;
+
+				const float x1 = v2.x - v1.x;
+				const float x2 = v3.x - v1.x;
+				const float y1 = v2.y - v1.y;
+				const float y2 = v3.y - v1.y;
+				const float z1 = v2.z - v1.z;
+				const float z2 = v3.z - v1.z;
+
+				const float s1 = vertices[i2].uvX - vertices[i1].uvX;
+				const float s2 = vertices[i3].uvX - vertices[i1].uvX;
+				const float t1 = vertices[i2].uvY - vertices[i1].uvY;
+				const float t2 = vertices[i3].uvY - vertices[i1].uvY;
+
+				// Triangles with degenerate uvs don't contribute
+				const float det = s1 * t2 - s2 * t1;
+				if (det == 0.0f)
+					continue;
+
+				const float r = 1.0f / det;
+
+				const Vector3f sdir((t2 * x1 - t1 * x2) * r, (t2 * y1 - t1 * y2) * r, (t2 * z1 - t1 * z2) * r);
+				const Vector3f tdir((s1 * x2 - s2 * x1) * r, (s1 * y2 - s2 * y1) * r, (s1 * z2 - s2 * z1) * r);
+
+				tangents[i1] += sdir;
+				tangents[i2] += sdir;
+				tangents[i3] += sdir;
+
+				bitangents[i1] += tdir;
+				bitangents[i2] += tdir;
+				bitangents[i3] += tdir;
+			}
+
+			for (size_t idx = 0; idx < vertexCount; ++idx)
+			{
+				const Vector3f& n = vertices[idx].normal;
+				const Vector3f& t = tangents[idx];
+
+				const Vector3f orthogonal = t - n * n.Dot(t);
+
+				if (orthogonal.LengthSq() > 1e-12f)
+				{
+					vertices[idx].tangent = orthogonal.Normalized();
+
+					// Mirrored uvs flip bitangent relative to cross(normal, tangent)
+					vertices[idx].tangentSign = n.Cross(t).Dot(bitangents[idx]) < 0.0f ? -1.0f : 1.0f;
+					continue;
+				}
+
+				// Vertices without uvs or only used by degenerate triangles get no tangent contribution,
+				// fall back to any unit vector perpendicular to the normal, using the axis least aligned with it
+				const Vector3f axis = std::abs(n.x) < 0.9f ? Vector3f(1.0f, 0.0f, 0.0f) : Vector3f(0.0f, 1.0f, 0.0f);
+				const Vector3f fallback = axis - n * n.Dot(axis);
+
+				vertices[idx].tangent = fallback.LengthSq() > 1e-12f ? fallback.Normalized() : axis;
+			}
+		}
+
+		bool ImportGltfMesh(const fs::path& sourcePath, CookedMesh& mesh)
+		{
+			tinygltf::TinyGLTF loader;
+			loader.SetImageLoader(SkipGltfImage, nullptr);
+
+			tinygltf::Model model;
+			std::string err;
+			std::string warn;
+
+			bool loaded = false;
+
+			if (sourcePath.extension() == ".gltf")
+				loaded = loader.LoadASCIIFromFile(&model, &err, &warn, sourcePath.string());
+			else
+				loaded = loader.LoadBinaryFromFile(&model, &err, &warn, sourcePath.string());
+
+			if (!warn.empty())
+				std::cout << "ImportGltfMesh - " << sourcePath.string() << ": " << warn << std::endl;
+
+			if (!loaded)
+			{
+				std::cout << "ImportGltfMesh - Failed to load " << sourcePath.string() << ": " << err << std::endl;
+				return false;
+			}
+
+			std::vector<std::array<float, 3>> positions;
+			std::vector<std::array<float, 3>> normals;
+			std::vector<std::array<float, 4>> tangents;
+			std::vector<std::array<float, 2>> uvs;
+			std::vector<uint32_t> primitiveIndices;
+
+			for (const auto& gltfMesh : model.meshes)
+			{
+				for (const auto& primitive : gltfMesh.primitives)
+				{
+					if (primitive.mode != -1 && primitive.mode != TINYGLTF_MODE_TRIANGLES)
+					{
+						std::cout << "ImportGltfMesh - Skipping non triangle primitive in " << gltfMesh.name << std::endl;
+						continue;
+					}
+
+					const auto positionIt = primitive.attributes.find("POSITION");
+
+					if (positionIt == primitive.attributes.end()
+						|| !ReadGltfAccessor(model, positionIt->second, TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3, positions))
+					{
+						std::cout << "ImportGltfMesh - Primitive in " << gltfMesh.name << " has no valid positions" << std::endl;
+						return false;
+					}
+
+					auto readAttribute = [&](const char* name, int type, auto& out)
+					{
+						const auto it = primitive.attributes.find(name);
+
+						if (it == primitive.attributes.end()
+							|| !ReadGltfAccessor(model, it->second, TINYGLTF_COMPONENT_TYPE_FLOAT, type, out)
+							|| out.size() != positions.size())
+							out.clear();
+					};
+
+					readAttribute("NORMAL", TINYGLTF_TYPE_VEC3, normals);
+					readAttribute("TANGENT", TINYGLTF_TYPE_VEC4, tangents);
+					readAttribute("TEXCOORD_0", TINYGLTF_TYPE_VEC2, uvs);
+
+					// Non indexed primitives draw their vertices in order
+					if (primitive.indices >= 0)
+					{
+						if (!ReadGltfIndices(model, primitive.indices, primitiveIndices))
+						{
+							std::cout << "ImportGltfMesh - Primitive in " << gltfMesh.name << " has invalid indices" << std::endl;
+							return false;
+						}
+					}
+					else
+					{
+						primitiveIndices.resize(positions.size());
+
+						for (size_t idx = 0; idx < positions.size(); ++idx)
+						{
+							primitiveIndices[idx] = static_cast<uint32_t>(idx);
+						}
+					}
+
+					for (const uint32_t index : primitiveIndices)
+					{
+						if (index >= positions.size())
+						{
+							std::cout << "ImportGltfMesh - Primitive in " << gltfMesh.name << " has out of range indices" << std::endl;
+							return false;
+						}
+					}
+
+					MeshBinarySubMesh subMesh;
+					subMesh.vertexOffset = mesh.vertices.size();
+					subMesh.indexOffset = mesh.indices.size();
+					subMesh.vertexCount = static_cast<uint32_t>(positions.size());
+					subMesh.indexCount = static_cast<uint32_t>(primitiveIndices.size());
+
+					for (size_t idx = 0; idx < positions.size(); ++idx)
+					{
+						rendering::VertexPNTV32 vertex {};
+
+						vertex.pos = { positions[idx][0], positions[idx][1], positions[idx][2] };
+
+						if (!normals.empty())
+							vertex.normal = { normals[idx][0], normals[idx][1], normals[idx][2] };
+
+						// Tangent w is handedness of tangent space, +1 or -1
+						if (!tangents.empty())
+						{
+							vertex.tangent = { tangents[idx][0], tangents[idx][1], tangents[idx][2] };
+							vertex.tangentSign = tangents[idx][3] < 0.0f ? -1.0f : 1.0f;
+						}
+
+						if (!uvs.empty())
+						{
+							vertex.uvX = uvs[idx][0];
+							vertex.uvY = uvs[idx][1];
+						}
+
+						mesh.vertices.push_back(vertex);
+					}
+
+					mesh.indices.insert(mesh.indices.end(), primitiveIndices.begin(), primitiveIndices.end());
+
+					if (tangents.empty())
+					{
+						GenerateTangents(mesh.vertices.data() + subMesh.vertexOffset, subMesh.vertexCount,
+							mesh.indices.data() + subMesh.indexOffset, subMesh.indexCount);
+					}
+
+					mesh.subMeshes.push_back(subMesh);
+				}
+			}
+
+			return true;
+		}
+
+		bool ImportObjMesh(const fs::path& sourcePath, CookedMesh& mesh)
+		{
+			tinyobj::ObjReaderConfig config;
+			config.triangulate = true; // Triangulate meshes so all polygons only have three vertices
+			config.vertex_color = false;
+
+			tinyobj::ObjReader reader;
+
+			if (!reader.ParseFromFile(sourcePath.string(), config))
+			{
+				std::cout << "ImportObjMesh - Failed to load " << sourcePath.string() << ": " << reader.Error() << std::endl;
+				return false;
+			}
+
+			if (!reader.Warning().empty())
+				std::cout << "ImportObjMesh - " << sourcePath.string() << ": " << reader.Warning() << std::endl;
+
+			const auto& attrib = reader.GetAttrib();
+
+			// Indices are read as is from file, so are checked against attribute arrays before they are used
+			auto isValidIndex = [](int index, size_t componentCount, const std::vector<tinyobj::real_t>& values)
+			{
+				return index >= 0 && componentCount * static_cast<size_t>(index) + componentCount <= values.size();
+			};
+
+			std::unordered_map<rendering::VertexPNTV32, uint32_t> vertexIndices;
+
+			for (const auto& shape : reader.GetShapes())
+			{
+				MeshBinarySubMesh subMesh;
+				subMesh.vertexOffset = mesh.vertices.size();
+				subMesh.indexOffset = mesh.indices.size();
+
+				vertexIndices.clear();
+
+				for (const auto& idx : shape.mesh.indices)
+				{
+					if (!isValidIndex(idx.vertex_index, 3, attrib.vertices)
+						|| (idx.normal_index >= 0 && !isValidIndex(idx.normal_index, 3, attrib.normals))
+						|| (idx.texcoord_index >= 0 && !isValidIndex(idx.texcoord_index, 2, attrib.texcoords)))
+					{
+						std::cout << "ImportObjMesh - Shape " << shape.name << " in " << sourcePath.string() << " has out of range indices" << std::endl;
+						return false;
+					}
+
+					rendering::VertexPNTV32 vertex {};
+
+					vertex.pos.x = attrib.vertices[3 * static_cast<size_t>(idx.vertex_index) + 0];
+					vertex.pos.y = attrib.vertices[3 * static_cast<size_t>(idx.vertex_index) + 1];
+					vertex.pos.z = attrib.vertices[3 * static_cast<size_t>(idx.vertex_index) + 2];
+
+					// Negative index means vertex has no normal/uv
+					if (idx.normal_index >= 0)
+					{
+						vertex.normal.x = attrib.normals[3 * static_cast<size_t>(idx.normal_index) + 0];
+						vertex.normal.y = attrib.normals[3 * static_cast<size_t>(idx.normal_index) + 1];
+						vertex.normal.z = attrib.normals[3 * static_cast<size_t>(idx.normal_index) + 2];
+					}
+
+					if (idx.texcoord_index >= 0)
+					{
+						vertex.uvX = attrib.texcoords[2 * static_cast<size_t>(idx.texcoord_index) + 0];
+						vertex.uvY = attrib.texcoords[2 * static_cast<size_t>(idx.texcoord_index) + 1];
+					}
+
+					// Vertices shared between faces are only stored once
+					if (const auto it = vertexIndices.find(vertex); it != vertexIndices.end())
+					{
+						mesh.indices.push_back(it->second);
+					}
+					else
+					{
+						vertexIndices.emplace(vertex, subMesh.vertexCount);
+
+						mesh.vertices.push_back(vertex);
+						mesh.indices.push_back(subMesh.vertexCount);
+
+						subMesh.vertexCount++;
+					}
+				}
+
+				subMesh.indexCount = static_cast<uint32_t>(mesh.indices.size() - subMesh.indexOffset);
+
+				GenerateTangents(mesh.vertices.data() + subMesh.vertexOffset, subMesh.vertexCount,
+					mesh.indices.data() + subMesh.indexOffset, subMesh.indexCount);
+
+				mesh.subMeshes.push_back(subMesh);
+			}
+
+			return true;
+		}
+
+		void AppendTable(std::vector<uint8_t>& data, const void* table, size_t size, MeshBinaryRange& range)
+		{
+			range.offset = AlignMeshBinaryOffset(data.size());
+			range.size = size;
+
+			data.resize(range.offset + size);
+
+			if (size > 0)
+				std::memcpy(data.data() + range.offset, table, size);
+		}
+	}
+
+	bool IsMeshSourceFile(const fs::path& sourcePath)
+	{
+		const auto extension = sourcePath.extension();
+
+		return extension == ".gltf" || extension == ".glb" || extension == ".obj";
+	}
+
+	bool ImportMesh(const fs::path& sourcePath, CookedMesh& mesh)
+	{
+		mesh = {};
+
+		if (sourcePath.extension() == ".gltf" || sourcePath.extension() == ".glb")
+			return ImportGltfMesh(sourcePath, mesh);
+
+		if (sourcePath.extension() == ".obj")
+			return ImportObjMesh(sourcePath, mesh);
+
+		std::cout << "ImportMesh - Unsupported format " << sourcePath.string() << std::endl;
+
+		return false;
+	}
+
+	bool WriteCookedMesh(const fs::path& outputPath, const CookedMesh& mesh)
+	{
+		MeshBinaryHeader header;
+		header.vertexFormat = static_cast<uint8_t>(rendering::VertexFormat::PNTV32);
+		header.subMeshCount = static_cast<uint32_t>(mesh.subMeshes.size());
+		header.vertexCount = mesh.vertices.size();
+		header.indexCount = mesh.indices.size();
+
+		// Indices are relative to their sub mesh, so 16 bits are enough as long as no sub mesh has more vertices
+		uint32_t maxSubMeshVertexCount = 0;
+
+		for (const auto& subMesh : mesh.subMeshes)
+		{
+			maxSubMeshVertexCount = std::max(maxSubMeshVertexCount, subMesh.vertexCount);
+		}
+
+		header.indexSize = maxSubMeshVertexCount <= UINT16_MAX + 1 ? 2 : 4;
+
+		std::vector<uint8_t> data(sizeof(MeshBinaryHeader), 0);
+
+		AppendTable(data, mesh.subMeshes.data(), mesh.subMeshes.size() * sizeof(MeshBinarySubMesh), header.subMeshes);
+		AppendTable(data, mesh.vertices.data(), mesh.vertices.size() * sizeof(rendering::VertexPNTV32), header.vertices);
+
+		if (header.indexSize == 2)
+		{
+			std::vector<uint16_t> indices16(mesh.indices.begin(), mesh.indices.end());
+
+			AppendTable(data, indices16.data(), indices16.size() * sizeof(uint16_t), header.indices);
+		}
+		else
+		{
+			AppendTable(data, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t), header.indices);
+		}
+
+		header.fileSize = data.size();
+		std::memcpy(data.data(), &header, sizeof(MeshBinaryHeader));
+
+		if (outputPath.has_parent_path())
+		{
+			std::error_code ec;
+			fs::create_directories(outputPath.parent_path(), ec);
+		}
+
+		std::ofstream os(outputPath, std::ios::out | std::ios::binary | std::ios::trunc);
+
+		if (!os.is_open())
+		{
+			std::cout << "WriteCookedMesh - Failed to open " << outputPath.string() << std::endl;
+			return false;
+		}
+
+		os.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+		return static_cast<bool>(os);
+	}
+
+	bool CookMesh(const fs::path& sourcePath, const fs::path& outputPath)
+	{
+		CookedMesh mesh;
+
+		if (!ImportMesh(sourcePath, mesh))
+			return false;
+
+		if (mesh.subMeshes.empty())
+		{
+			std::cout << "CookMesh - " << sourcePath.string() << " has no meshes" << std::endl;
+			return false;
+		}
+
+		return WriteCookedMesh(outputPath, mesh);
+	}
+}
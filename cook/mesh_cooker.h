@@ -0,0 +1,35 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "resource/mesh_binary.h"
+#include "types/vertex.h"
+
+namespace fs = std::filesystem;
+
+namespace puffin::cook
+{
+	// Mesh imported from a source file, in engine vertex format
+	struct CookedMesh
+	{
+		std::vector<rendering::VertexPNTV32> vertices;
+		std::vector<uint32_t> indices; // Relative to first vertex of their sub mesh
+		std::vector<MeshBinarySubMesh> subMeshes;
+	};
+
+	// Whether file is a mesh format which can be cooked (.gltf, .glb, .obj)
+	bool IsMeshSourceFile(const fs::path& sourcePath);
+
+	/*
+	 * Import every mesh in source file into one cooked mesh, each glTF primitive or OBJ shape becomes a sub mesh.
+	 * Tangents are generated for sub meshes which don't provide them
+	 */
+	bool ImportMesh(const fs::path& sourcePath, CookedMesh& mesh);
+
+	// Write mesh in cooked mesh format, see mesh_binary.h
+	bool WriteCookedMesh(const fs::path& outputPath, const CookedMesh& mesh);
+
+	// Import & write mesh, safe to call for different files from multiple threads at once
+	bool CookMesh(const fs::path& sourcePath, const fs::path& outputPath);
+}
@@ -80,6 +80,8 @@ namespace puffin::ui
 			// File Dialog - Load Scene
 			if (mLoadScene)
 			{
+				m_engine->GetSubsystem<scene::SceneSerializationSubsystem>()->WaitForSave();
+
 				const auto sceneData = m_engine->GetSubsystem<scene::SceneSerializationSubsystem>()->GetCurrentSceneData();
 
 				sceneData->SetPath(selectedPath);
@@ -145,9 +147,27 @@ namespace puffin::ui
 		// Update Scene Data if any changes were made to an entity, and game is not currently playing
 		if (mWindowNodeEditor->GetSceneChanged() && m_engine->GetPlayState() == core::PlayState::Stopped)
 		{
-			const auto sceneData = m_engine->GetSubsystem<scene::SceneSerializationSubsystem>()->GetCurrentSceneData();
+			const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
+
+			// Node editor may write components in place, which dirty tracking can't see
+			if (enttSubsystem->IsEntityValid(mEntity))
+				enttSubsystem->MarkDirty(mEntity);
+
+			m_engine->GetSubsystem<scene::SceneSerializationSubsystem>()->UpdateSceneData();
+		}
+
+		// Autosave only writes what changed since last save to a recovery file, so it doesn't stall editor on large
+		// scenes & scene isn't changed on disk until it is saved
+		if (m_engine->GetPlayState() == core::PlayState::Stopped)
+		{
+			mTimeSinceAutosave += deltaTime;
+
+			if (mTimeSinceAutosave >= gAutosaveInterval)
+			{
+				m_engine->GetSubsystem<scene::SceneSerializationSubsystem>()->SaveRecovery();
 
-			sceneData->UpdateData(m_engine);
+				mTimeSinceAutosave = 0.0;
+			}
 		}
 
 		//ImGui_ImplVulkan_NewFrame();
@@ -265,6 +285,8 @@ namespace puffin::ui
 				const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
 				const auto sceneGraph = m_engine->GetSubsystem<scene::SceneGraphSubsystem>();
 
+				m_engine->GetSubsystem<scene::SceneSerializationSubsystem>()->WaitForSave();
+
 				sceneData->UpdateData(m_engine);
 				sceneData->Save();
 
@@ -333,13 +355,8 @@ namespace puffin::ui
 
 				if (ImGui::MenuItem("Save Scene"))
 				{
-					const auto sceneData = m_engine->GetSubsystem<scene::SceneSerializationSubsystem>()->GetCurrentSceneData();
-
-					const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
-					const auto sceneGraph = m_engine->GetSubsystem<scene::SceneGraphSubsystem>();
-
-					sceneData->UpdateData(m_engine);
-					sceneData->Save();
+					// Scene is written in background so editor doesn't stall on large scenes
+					m_engine->GetSubsystem<scene::SceneSerializationSubsystem>()->SaveAsync();
 				}
 
 				if (ImGui::MenuItem("Save Scene As"))
@@ -347,6 +364,22 @@ namespace puffin::ui
 					mSaveScene = true;
 				}
 
+				if (ImGui::MenuItem("Recover Autosave"))
+				{
+					m_engine->GetSubsystem<scene::SceneSerializationSubsystem>()->WaitForSave();
+
+					const auto sceneData = m_engine->GetSubsystem<scene::SceneSerializationSubsystem>()->GetCurrentSceneData();
+
+					// Recovery is applied on top of scene as it was last saved, then scene is set up from it
+					if (fs::exists(sceneData->GetRecoveryPath()))
+					{
+						sceneData->Load(true);
+						sceneData->LoadRecovery();
+
+						m_engine->Restart();
+					}
+				}
+
 				ImGui::Text("---Other---");
 
 				if (ImGui::BeginMenu("Import"))
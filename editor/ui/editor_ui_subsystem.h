@@ -26,6 +26,8 @@ namespace puffin
 		class UIWindowViewport;
 		class UIWindow;
 
+		constexpr double gAutosaveInterval = 60.0; // Seconds between autosaves of current scene while editing
+
 		enum class ImportAssetUI
 		{
 			Default,
@@ -61,6 +63,7 @@ namespace puffin
 
 			bool mSaveScene = false;
 			bool mLoadScene = false;
+			double mTimeSinceAutosave = 0.0;
 			ImportAssetUI mImportAssetUI = ImportAssetUI::Default;
 
 			UUID mEntity = gInvalidID;
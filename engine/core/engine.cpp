@@ -4,7 +4,9 @@
 
 #include "audio/audio_subsystem.h"
 #include "core/engine_helpers.h"
+#include "core/enkits_subsystem.h"
 #include "core/settings_manager.h"
+#include "ecs/entt_subsystem.h"
 #include "input/input_subsystem.h"
 #include "scene/scene_serialization_subsystem.h"
 #include "window/window_subsystem.h"
@@ -114,6 +116,11 @@ namespace puffin::core
 
 		mSubsystemManager->CreateAndInitializeEngineSubsystems();
 
+		if (const auto enkiTSSubsystem = GetSubsystem<core::EnkiTSSubsystem>())
+		{
+			mResourceManager->StartAsyncLoading(enkiTSSubsystem->GetTaskScheduler().get(), enkiTSSubsystem->GetIOThreadNum());
+		}
+
 		// Initialize engine subsystems
 		if (mPlatform)
 		{
@@ -257,6 +264,15 @@ namespace puffin::core
 
 		const auto audioSubsystem = GetSubsystem<audio::AudioSubsystem>();
 
+		// Finalize resources loaded in background
+		{
+			benchmarkManager->Begin("ResourceUpdate");
+
+			mResourceManager->Update();
+
+			benchmarkManager->End("ResourceUpdate");
+		}
+
 		// Execute engine updates
 		{
 			auto* engineUpdateBenchmark = benchmarkManager->Begin("EngineUpdate");
@@ -287,6 +303,12 @@ namespace puffin::core
 			benchmarkManager->End("EngineUpdate");
 		}
 
+		// Engine subsystems have read last frame's changes by now, render reads this frame's changes before next clear
+		if (auto enttSubsystem = GetSubsystem<ecs::EnTTSubsystem>())
+		{
+			enttSubsystem->ClearChanged();
+		}
+
 		// Call system start functions to prepare for gameplay
 		if (mPlayState == PlayState::BeginPlay)
 		{
@@ -440,6 +462,9 @@ namespace puffin::core
 			EndPlay();
 		}
 
+		// Loads in flight need task scheduler to finish
+		mResourceManager->StopAsyncLoading();
+
 		// Cleanup all engine subsystems
 		mSubsystemManager->DeinitializeAndDestroyEngineSubsystems();
 
@@ -539,6 +564,8 @@ namespace puffin::core
 		mFramerateLimit = settingsManager->Get<int>("general", "framerate_limit").value_or(0);
 
 		UpdatePhysicsTickRate(settingsManager->Get<uint16_t>("physics", "ticks_per_second").value_or(60));
+
+		UpdateResourceMemoryBudget(settingsManager->Get<uint32_t>("general", "resource_memory_budget_mb").value_or(0));
 	}
 
 	void Engine::InitSignals()
@@ -560,6 +587,14 @@ namespace puffin::core
 
 				UpdatePhysicsTickRate(settingsManager->Get<uint16_t>("physics", "ticks_per_second").value_or(60));
 			}));
+
+		auto resourceMemoryBudgetSignal = signalSubsystem->GetOrCreateSignal("general_resource_memory_budget_mb");
+		resourceMemoryBudgetSignal->Connect(std::function([&]
+			{
+				auto settingsManager = GetSubsystem<core::SettingsManager>();
+
+				UpdateResourceMemoryBudget(settingsManager->Get<uint32_t>("general", "resource_memory_budget_mb").value_or(0));
+			}));
 	}
 
 	void Engine::EndPlay() const
@@ -599,4 +634,9 @@ namespace puffin::core
 		mPhysicsTicksPerSecond = ticksPerSecond;
 		mTimeStepFixed = 1.0 / mPhysicsTicksPerSecond;
 	}
+
+	void Engine::UpdateResourceMemoryBudget(uint32_t budgetMB) const
+	{
+		mResourceManager->SetMemoryBudget(static_cast<size_t>(budgetMB) * 1024 * 1024);
+	}
 }
@@ -148,6 +148,7 @@ namespace puffin::core
 
 		void UpdateDeltaTime(double sampledTime);
 		void UpdatePhysicsTickRate(uint16_t ticksPerSecond);
+		void UpdateResourceMemoryBudget(uint32_t budgetMB) const;
 
 		bool mRunning = true;
 		bool mLoadSceneOnLaunch = false;
@@ -297,7 +297,8 @@ namespace puffin::core
 		{
 			for (int i = 1; i <= wallCountX; i++)
 			{
-				auto* floor = sceneGraph->AddNode<physics::Rigidbody2DNode>("Floor #" + std::to_string(i));
+				auto* floor = sceneGraph->AddNode<physics::Rigidbody2DNode>("Floor");
+				floor->SetNameSuffix(i);
 				floor->SetGlobalPosition({ (-wallHalfExtent.x + wallHalfLength * i), wallHalfExtent.y});
 
 				auto* floorBox = sceneGraph->AddChildNode<physics::Box2DNode>("Box", floor->GetID());
@@ -345,7 +346,8 @@ namespace puffin::core
 		{
 			for (int i = 1; i <= wallCountX; i++)
 			{
-				auto* ceiling = sceneGraph->AddNode<physics::Rigidbody2DNode>("Ceiling #" + std::to_string(i));
+				auto* ceiling = sceneGraph->AddNode<physics::Rigidbody2DNode>("Ceiling");
+				ceiling->SetNameSuffix(i);
 				ceiling->SetGlobalPosition({ (-wallHalfExtent.x + wallHalfLength * i), -wallHalfExtent.y });
 
 				auto* ceilingBox = sceneGraph->AddChildNode<physics::Box2DNode>("Box", ceiling->GetID());
@@ -383,7 +385,8 @@ namespace puffin::core
 
 			for (int i = 0; i < numBodies; ++i)
 			{
-				auto* body = sceneGraph->AddNode<physics::Rigidbody2DNode>("Body #" + std::to_string(i));
+				auto* body = sceneGraph->AddNode<physics::Rigidbody2DNode>("Body");
+				body->SetNameSuffix(i);
 				body->SetGlobalPosition({ posXDist(mt), posYDist(mt) });
 				body->SetBodyType(physics::BodyType::Dynamic);
 				body->SetFriction(0.0f);
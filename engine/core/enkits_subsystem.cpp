@@ -1,5 +1,7 @@
 #include "core/enkits_subsystem.h"
 
+#include <iostream>
+
 #include "core/engine.h"
 #include "core/settings_manager.h"
 
@@ -17,15 +19,37 @@ namespace puffin::core
 		auto* settingsManager = subsystemManager->CreateAndInitializeSubsystem<SettingsManager>();
 
 		mThreadCount = settingsManager->Get<uint32_t>("general", "thread_count").value_or(4);
-		
+
+		// Main thread alone can't run resource decodes while it is busy with a frame, so keep at least one worker
+		if (mThreadCount < 2)
+		{
+			std::cout << "EnkiTSSubsystem::Initialize - Thread count of " << mThreadCount << " is too low, using 2 threads" << std::endl;
+			mThreadCount = 2;
+		}
+
+		// One extra thread is created for I/O, so blocking reads don't take a worker away from task sets
 		mTaskScheduler = std::make_shared<enki::TaskScheduler>();
-		mTaskScheduler->Initialize(mThreadCount);
+		mTaskScheduler->Initialize(mThreadCount + 1);
+
+		mIOThreadNum = mTaskScheduler->GetNumTaskThreads() - 1;
+
+		mIOTaskLoop = std::make_unique<PinnedTaskLoop>(mTaskScheduler.get(), mIOThreadNum);
+		mTaskScheduler->AddPinnedTask(mIOTaskLoop.get());
 	}
 
 	void EnkiTSSubsystem::Deinitialize()
 	{
+		// Empty pinned task wakes loop so it sees it should stop
+		mIOTaskLoop->running = false;
+
+		enki::LambdaPinnedTask wakeTask(mIOThreadNum, [] {});
+		mTaskScheduler->AddPinnedTask(&wakeTask);
+		mTaskScheduler->WaitforTask(&wakeTask);
+		mTaskScheduler->WaitforTask(mIOTaskLoop.get());
+
 		mTaskScheduler->WaitforAllAndShutdown();
 		mTaskScheduler = nullptr;
+		mIOTaskLoop = nullptr;
 	}
 
 	std::string_view EnkiTSSubsystem::GetName() const
@@ -42,4 +66,23 @@ namespace puffin::core
 	{
 		return mThreadCount;
 	}
+
+	uint32_t EnkiTSSubsystem::GetIOThreadNum() const
+	{
+		return mIOThreadNum;
+	}
+
+	EnkiTSSubsystem::PinnedTaskLoop::PinnedTaskLoop(enki::TaskScheduler* taskScheduler, uint32_t threadNum)
+		: enki::IPinnedTask(threadNum), mTaskScheduler(taskScheduler)
+	{
+	}
+
+	void EnkiTSSubsystem::PinnedTaskLoop::Execute()
+	{
+		while (running)
+		{
+			mTaskScheduler->WaitForNewPinnedTasks();
+			mTaskScheduler->RunPinnedTasks();
+		}
+	}
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <thread>
 
@@ -26,11 +27,33 @@ namespace puffin
 			std::shared_ptr<enki::TaskScheduler> GetTaskScheduler();
 			uint32_t GetThreadCount() const;
 
+			// Thread reserved for blocking file reads, only runs pinned tasks so it never stalls task sets
+			uint32_t GetIOThreadNum() const;
+
 		private:
 
+			// Keeps I/O thread waiting on & running pinned tasks until scheduler is shut down
+			class PinnedTaskLoop : public enki::IPinnedTask
+			{
+			public:
+
+				PinnedTaskLoop(enki::TaskScheduler* taskScheduler, uint32_t threadNum);
+
+				void Execute() override;
+
+				std::atomic<bool> running = true;
+
+			private:
+
+				enki::TaskScheduler* mTaskScheduler = nullptr;
+
+			};
+
 			std::shared_ptr<enki::TaskScheduler> mTaskScheduler;
+			std::unique_ptr<PinnedTaskLoop> mIOTaskLoop;
 
 			uint32_t mThreadCount = 0;
+			uint32_t mIOThreadNum = 0;
 
 		};
 	}
@@ -124,6 +124,7 @@ namespace puffin::core
 			generalSettings.Set("framerate_limit", 60);
 			generalSettings.Set("unit_scale", 1.0);
 			generalSettings.Set("mouse_sensitivity", 0.05);
+			generalSettings.Set("resource_memory_budget_mb", 0);
 		}
 
 		// Editor
@@ -16,13 +16,21 @@ namespace puffin::ecs
 		Subsystem::Initialize(subsystemManager);
 
 		m_registry = std::make_shared<entt::registry>();
+		m_entityInfos = &m_registry->storage<EntityInfoComponent>();
+
+		ConnectDirtySignals();
 	}
 
 	void EnTTSubsystem::Deinitialize()
 	{
 		Subsystem::Deinitialize();
 
+		m_entityInfos = nullptr;
 		m_registry = nullptr;
+
+		m_dirtySignalTypeCount = 0;
+		m_dirtyIDs.clear();
+		m_removedIDs.clear();
 	}
 
 	void EnTTSubsystem::EndPlay()
@@ -30,8 +38,8 @@ namespace puffin::ecs
 		m_registry->clear();
 
 		m_idToEntity.clear();
-		m_shouldBeSerialized.clear();
-		m_entityToId.clear();
+
+		ClearChanged();
 	}
 
 	std::string_view EnTTSubsystem::GetName() const
@@ -41,39 +49,49 @@ namespace puffin::ecs
 
 	UUID EnTTSubsystem::AddEntity(bool shouldBeSerialized)
 	{
-		const auto entity = m_registry->create();
 		const auto id = GenerateId();
 
-		m_idToEntity.emplace(id, entity);
-		m_entityToId.emplace(entity, id);
-
-		if (shouldBeSerialized)
-			m_shouldBeSerialized.emplace(id);
+		CreateEntity(id, shouldBeSerialized);
 
 		return id;
 	}
 
 	entt::entity EnTTSubsystem::AddEntity(UUID id, bool shouldBeSerialized)
 	{
-		if (IsEntityValid(id))
-			return m_idToEntity.at(id);
+		if (const auto it = m_idToEntity.find(id); it != m_idToEntity.end())
+			return it->second;
 
-		const auto entity = m_registry->create();
+		return CreateEntity(id, shouldBeSerialized);
+	}
 
-		m_idToEntity.emplace(id, entity);
-		m_entityToId.emplace(entity, id);
+	void EnTTSubsystem::RemoveEntity(UUID id)
+	{
+		const auto it = m_idToEntity.find(id);
+		if (it == m_idToEntity.end())
+			return;
 
-		if (shouldBeSerialized)
-			m_shouldBeSerialized.emplace(id);
+		const bool shouldBeSerialized = ShouldEntityBeSerialized(it->second);
 
-		return entity;
+		// Entity info is removed along with entity
+		m_registry->destroy(it->second);
+
+		m_idToEntity.erase(it);
+
+		if (m_dirtyTrackingEnabled && shouldBeSerialized)
+		{
+			m_dirtyIDs.erase(id);
+			m_removedIDs.insert(id);
+		}
 	}
 
-	void EnTTSubsystem::RemoveEntity(UUID id)
+	void EnTTSubsystem::Reserve(size_t count)
 	{
-		m_registry->destroy(m_idToEntity[id]);
+		const size_t newSize = m_idToEntity.size() + count;
 
-		m_idToEntity.erase(id);
+		m_registry->storage<entt::entity>().reserve(newSize);
+		m_entityInfos->reserve(newSize);
+
+		m_idToEntity.reserve(newSize);
 	}
 
 	bool EnTTSubsystem::IsEntityValid(const UUID id) const
@@ -92,24 +110,116 @@ namespace puffin::ecs
 
 	UUID EnTTSubsystem::GetID(entt::entity entity) const
 	{
-		if (m_entityToId.count(entity) != 0)
-			return m_entityToId.at(entity);
+		if (m_entityInfos->contains(entity))
+			return m_entityInfos->get(entity).id;
 
 		return gInvalidID;
 	}
 
 	bool EnTTSubsystem::ShouldEntityBeSerialized(const UUID& id) const
 	{
-		if (m_shouldBeSerialized.find(id) != m_shouldBeSerialized.end())
-		{
-			return true;
-		}
+		if (const auto it = m_idToEntity.find(id); it != m_idToEntity.end())
+			return ShouldEntityBeSerialized(it->second);
 
 		return false;
 	}
 
+	bool EnTTSubsystem::ShouldEntityBeSerialized(entt::entity entity) const
+	{
+		return m_entityInfos->contains(entity) && (m_entityInfos->get(entity).flags & gEntityFlagShouldBeSerialized) != 0;
+	}
+
 	std::shared_ptr<entt::registry> EnTTSubsystem::GetRegistry()
 	{
 		return m_registry;
 	}
+
+	void EnTTSubsystem::ClearChanged()
+	{
+		// Sets are kept so their memory is reused next frame
+		for (auto& [typeID, changed] : m_changedSets)
+		{
+			changed.clear();
+		}
+	}
+
+	void EnTTSubsystem::SetDirtyTrackingEnabled(bool enabled)
+	{
+		m_dirtyTrackingEnabled = enabled;
+	}
+
+	bool EnTTSubsystem::IsDirtyTrackingEnabled() const
+	{
+		return m_dirtyTrackingEnabled;
+	}
+
+	void EnTTSubsystem::MarkDirty(UUID id)
+	{
+		if (m_dirtyTrackingEnabled && ShouldEntityBeSerialized(id))
+			m_dirtyIDs.insert(id);
+	}
+
+	void EnTTSubsystem::MarkDirty(entt::entity entity)
+	{
+		// Entity info may already be gone when components are destroyed along with their entity
+		if (m_dirtyTrackingEnabled && ShouldEntityBeSerialized(entity))
+			m_dirtyIDs.insert(m_entityInfos->get(entity).id);
+	}
+
+	const std::unordered_set<UUID>& EnTTSubsystem::GetDirtyIDs() const
+	{
+		return m_dirtyIDs;
+	}
+
+	const std::unordered_set<UUID>& EnTTSubsystem::GetRemovedIDs() const
+	{
+		return m_removedIDs;
+	}
+
+	void EnTTSubsystem::ClearDirty()
+	{
+		m_dirtyIDs.clear();
+		m_removedIDs.clear();
+
+		ConnectDirtySignals();
+	}
+
+	void EnTTSubsystem::OnComponentChanged(entt::registry& registry, entt::entity entity)
+	{
+		MarkDirty(entity);
+	}
+
+	void EnTTSubsystem::ConnectDirtySignals()
+	{
+		if (!m_registry)
+			return;
+
+		const auto& typeFuncs = serialization::ComponentRegistry::Get()->GetTypeFuncs();
+
+		for (; m_dirtySignalTypeCount < typeFuncs.size(); ++m_dirtySignalTypeCount)
+		{
+			typeFuncs[m_dirtySignalTypeCount].connectChangeListener(*m_registry, *this);
+		}
+	}
+
+	entt::entity EnTTSubsystem::CreateEntity(UUID id, bool shouldBeSerialized)
+	{
+		const auto entity = m_registry->create();
+
+		EntityInfoComponent entityInfo;
+		entityInfo.id = id;
+		entityInfo.flags = shouldBeSerialized ? gEntityFlagShouldBeSerialized : 0;
+
+		m_entityInfos->emplace(entity, entityInfo);
+
+		m_idToEntity.emplace(id, entity);
+
+		if (m_dirtyTrackingEnabled && shouldBeSerialized)
+		{
+			m_dirtyIDs.insert(id);
+			m_removedIDs.erase(id);
+		}
+
+		return entity;
+	}
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cassert>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -7,12 +8,24 @@
 #include "types/uuid.h"
 #include "core/engine.h"
 #include "entt/entity/registry.hpp"
+#include "serialization/component_serialization.h"
 
 namespace puffin
 {
 	namespace ecs
 	{
-		class EnTTSubsystem : public core::EngineSubsystem
+		constexpr uint8_t gEntityFlagShouldBeSerialized = 1 << 0;
+
+		/*
+		 * Id & flags of an entity, stored in registry so looking them up from an entity is a sparse set access
+		 */
+		struct EntityInfoComponent
+		{
+			UUID id = gInvalidID;
+			uint8_t flags = 0;
+		};
+
+		class EnTTSubsystem : public core::EngineSubsystem, public serialization::IComponentChangeListener
 		{
 		public:
 
@@ -33,22 +46,127 @@ namespace puffin
 
 			void RemoveEntity(UUID id);
 
+			// Reserve space for count additional entities, use before adding entities in bulk
+			void Reserve(size_t count);
+
 			bool IsEntityValid(UUID id) const;
 
 			[[nodiscard]] entt::entity GetEntity(UUID id) const;
 			[[nodiscard]] UUID GetID(entt::entity entity) const;
 
 			[[nodiscard]] bool ShouldEntityBeSerialized(const UUID& id) const;
+			[[nodiscard]] bool ShouldEntityBeSerialized(entt::entity entity) const;
 
 			std::shared_ptr<entt::registry> GetRegistry();
 
+			/*
+			 * Declare an owning group for a hot component combination, owned storages are kept packed so entities in
+			 * group are iterated in lockstep without per entity checks
+			 *
+			 * Call from subsystem Initialize, a storage can only be owned by one group (or a set of nested groups), so
+			 * anything other subsystems also iterate should be passed as a get type rather than owned.
+			 * Fetch group later with registry->group using the same signature
+			 */
+			template<typename... Owned, typename... Get>
+			auto RegisterGroup(entt::get_t<Get...> get = entt::get_t<Get...>{})
+			{
+				assert(m_registry && "EnTTSubsystem::RegisterGroup - Registry has not been created yet");
+
+				return m_registry->group<Owned...>(get);
+			}
+
+			/*
+			 * Mark component of entity as changed, an alternative to registry->patch for bulk writers which doesn't fire
+			 * on_update signals, consumers read changed entities with GetChanged
+			 *
+			 * Changes are cleared once per frame after engine subsystems have updated, so engine subsystems see changes
+			 * made during previous frame's fixed update/update, and render sees changes made this frame
+			 *
+			 * Change sets are kept apart from save dirty tracking, as they're mostly written during play (i.e. physics)
+			 * when nothing is saved. Writers which modify saved components in place outside of play should call MarkDirty as well
+			 *
+			 * Not thread safe, collect entities from parallel writers and mark them once writes are complete
+			 */
+			template<typename CompT>
+			void MarkChanged(entt::entity entity)
+			{
+				auto& changed = GetChangedSet<CompT>();
+
+				if (!changed.contains(entity))
+					changed.push(entity);
+			}
+
+			template<typename CompT, typename It>
+			void MarkChanged(It first, It last)
+			{
+				auto& changed = GetChangedSet<CompT>();
+
+				for (; first != last; ++first)
+				{
+					if (!changed.contains(*first))
+						changed.push(*first);
+				}
+			}
+
+			// Packed set of entities whose CompT component was marked as changed, may hold entities destroyed since they were marked
+			template<typename CompT>
+			[[nodiscard]] const entt::sparse_set& GetChanged() const
+			{
+				static const entt::sparse_set emptySet;
+
+				if (const auto it = m_changedSets.find(entt::type_hash<CompT>::value()); it != m_changedSets.end())
+					return it->second;
+
+				return emptySet;
+			}
+
+			void ClearChanged();
+
+			/*
+			 * Dirty tracking, ids of serialized entities which were added, had a component of a registered type
+			 * constructed, replaced, patched or removed, and ids of removed entities. Unlike changed sets these persist
+			 * across frames until ClearDirty is called, so scene saves only rewrite what has changed.
+			 *
+			 * Components written in place through get/view or marked with MarkChanged aren't seen, use patch or MarkDirty for those
+			 */
+			void SetDirtyTrackingEnabled(bool enabled);
+			[[nodiscard]] bool IsDirtyTrackingEnabled() const;
+
+			// Mark entity as dirty for changes which registry signals don't see, nodes share their id with their entity
+			void MarkDirty(UUID id);
+			void MarkDirty(entt::entity entity);
+
+			[[nodiscard]] const std::unordered_set<UUID>& GetDirtyIDs() const;
+			[[nodiscard]] const std::unordered_set<UUID>& GetRemovedIDs() const;
+
+			// Clear dirty & removed ids, component types registered since tracking was last cleared are tracked from now on
+			void ClearDirty();
+
+			void OnComponentChanged(entt::registry& registry, entt::entity entity) override;
+
 		private:
 
+			template<typename CompT>
+			entt::sparse_set& GetChangedSet()
+			{
+				return m_changedSets[entt::type_hash<CompT>::value()];
+			}
+
+			entt::entity CreateEntity(UUID id, bool shouldBeSerialized);
+
+			// Connect change signals of component types registered since signals were last connected
+			void ConnectDirtySignals();
+
 			std::shared_ptr<entt::registry> m_registry = nullptr;
+			entt::storage_for_t<EntityInfoComponent>* m_entityInfos = nullptr; // Cached so id lookups skip registry storage lookup
 
 			std::unordered_map<UUID, entt::entity> m_idToEntity;
-			std::unordered_map<entt::entity, UUID> m_entityToId;
-			std::unordered_set<UUID> m_shouldBeSerialized;
+			std::unordered_map<entt::id_type, entt::sparse_set> m_changedSets; // Entities marked as changed, per component type
+
+			bool m_dirtyTrackingEnabled = true;
+			size_t m_dirtySignalTypeCount = 0; // Number of registered component types whose signals are connected
+			std::unordered_set<UUID> m_dirtyIDs;
+			std::unordered_set<UUID> m_removedIDs;
 
 		};
 	}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "TaskScheduler.h"
+#include "entt/entity/entity.hpp"
+
+namespace puffin
+{
+	namespace ecs
+	{
+		constexpr uint32_t gDefaultParallelGrainSize = 256; // Min number of entities processed by a single task
+
+		/*
+		 * Call fn(entity, threadIdx) for every entity in an EnTT view or group, split into chunks of at least grainSize
+		 * entities which are run as an enkiTS task set, blocks until all chunks have completed
+		 *
+		 * threadIdx is in range [0, scheduler.GetNumTaskThreads()), use it to index per thread scratch space,
+		 * fn must not add/remove components or entities or patch components, as registry signals aren't thread safe
+		 *
+		 * Groups and single component views are split in place, multi component views are copied to a list of
+		 * entities first as their iterators can't be indexed
+		 */
+		template<typename ViewT, typename FuncT>
+		void ParallelEach(enki::TaskScheduler& scheduler, const ViewT& view, FuncT&& fn, uint32_t grainSize = gDefaultParallelGrainSize)
+		{
+			using IteratorT = decltype(view.begin());
+			using IteratorCategoryT = typename std::iterator_traits<IteratorT>::iterator_category;
+
+			grainSize = std::max(grainSize, 1u);
+
+			auto run = [&](auto begin, uint32_t count)
+			{
+				if (count == 0)
+					return;
+
+				// Not worth scheduling a task set for a single chunk
+				if (count <= grainSize || scheduler.GetNumTaskThreads() <= 1)
+				{
+					const uint32_t threadIdx = scheduler.GetThreadNum();
+
+					for (uint32_t idx = 0; idx < count; ++idx)
+					{
+						fn(*(begin + idx), threadIdx);
+					}
+
+					return;
+				}
+
+				enki::TaskSet task(count, [&](enki::TaskSetPartition range, uint32_t threadIdx)
+				{
+					for (uint32_t idx = range.start; idx < range.end; ++idx)
+					{
+						fn(*(begin + idx), threadIdx);
+					}
+				});
+
+				task.m_MinRange = grainSize;
+
+				scheduler.AddTaskSetToPipe(&task);
+				scheduler.WaitforTask(&task);
+			};
+
+			if constexpr (std::is_base_of_v<std::random_access_iterator_tag, IteratorCategoryT>)
+			{
+				run(view.begin(), static_cast<uint32_t>(std::distance(view.begin(), view.end())));
+			}
+			else
+			{
+				std::vector<entt::entity> entities(view.begin(), view.end());
+
+				run(entities.cbegin(), static_cast<uint32_t>(entities.size()));
+			}
+		}
+	}
+}
@@ -0,0 +1,94 @@
+#include "ecs/registry_snapshot.h"
+
+#include "ecs/entt_subsystem.h"
+#include "serialization/component_serialization.h"
+
+namespace puffin::ecs
+{
+	void RegistrySnapshot::Capture(EnTTSubsystem* enttSubsystem)
+	{
+		Clear();
+
+		const auto registry = enttSubsystem->GetRegistry();
+
+		std::vector<entt::entity> srcEntities;
+
+		for (const auto entity : registry->view<entt::entity>())
+		{
+			if (!enttSubsystem->ShouldEntityBeSerialized(entity))
+				continue;
+
+			srcEntities.push_back(entity);
+			mIDs.push_back(enttSubsystem->GetID(entity));
+		}
+
+		mRegistry = std::make_shared<entt::registry>();
+
+		mEntities.resize(srcEntities.size());
+		mRegistry->create(mEntities.begin(), mEntities.end());
+
+		CopyComponents(registry, srcEntities, mRegistry, mEntities);
+
+		mHasData = true;
+	}
+
+	void RegistrySnapshot::Restore(EnTTSubsystem* enttSubsystem) const
+	{
+		assert(mHasData && "RegistrySnapshot::Restore - No snapshot has been captured");
+
+		enttSubsystem->Reserve(mIDs.size());
+
+		std::vector<entt::entity> dstEntities;
+		dstEntities.reserve(mIDs.size());
+
+		for (const auto& id : mIDs)
+		{
+			dstEntities.push_back(enttSubsystem->AddEntity(id));
+		}
+
+		CopyComponents(mRegistry, mEntities, enttSubsystem->GetRegistry(), dstEntities);
+	}
+
+	void RegistrySnapshot::Clear()
+	{
+		mIDs.clear();
+		mEntities.clear();
+		mRegistry = nullptr;
+
+		mHasData = false;
+	}
+
+	bool RegistrySnapshot::HasData() const
+	{
+		return mHasData;
+	}
+
+	size_t RegistrySnapshot::Count() const
+	{
+		return mIDs.size();
+	}
+
+	const std::vector<UUID>& RegistrySnapshot::GetIDs() const
+	{
+		return mIDs;
+	}
+
+	const std::vector<entt::entity>& RegistrySnapshot::GetEntities() const
+	{
+		return mEntities;
+	}
+
+	const std::shared_ptr<entt::registry>& RegistrySnapshot::GetRegistry() const
+	{
+		return mRegistry;
+	}
+
+	void RegistrySnapshot::CopyComponents(const std::shared_ptr<entt::registry>& srcRegistry, const std::vector<entt::entity>& srcEntities,
+		const std::shared_ptr<entt::registry>& dstRegistry, const std::vector<entt::entity>& dstEntities)
+	{
+		for (const auto& funcs : serialization::ComponentRegistry::Get()->GetTypeFuncs())
+		{
+			funcs.copyComponents(*srcRegistry, srcEntities, *dstRegistry, dstEntities);
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "entt/entity/registry.hpp"
+
+#include "types/uuid.h"
+
+namespace puffin
+{
+	namespace ecs
+	{
+		class EnTTSubsystem;
+
+		/*
+		 * In memory copy of all serializable entities & their components
+		 *
+		 * Components are copied storage to storage into a private registry, one batch per component type, so a
+		 * registry can be captured & restored without going through json
+		 */
+		class RegistrySnapshot
+		{
+		public:
+
+			RegistrySnapshot() = default;
+			~RegistrySnapshot() = default;
+
+			// Copy serializable entities & components from entt subsystem, replacing any previous snapshot
+			void Capture(EnTTSubsystem* enttSubsystem);
+
+			// Add captured entities & components back to entt subsystem, entities keep their ids
+			void Restore(EnTTSubsystem* enttSubsystem) const;
+
+			void Clear();
+
+			[[nodiscard]] bool HasData() const;
+			[[nodiscard]] size_t Count() const;
+
+			// Captured ids & their entity in snapshot registry, in same order
+			[[nodiscard]] const std::vector<UUID>& GetIDs() const;
+			[[nodiscard]] const std::vector<entt::entity>& GetEntities() const;
+			[[nodiscard]] const std::shared_ptr<entt::registry>& GetRegistry() const;
+
+		private:
+
+			static void CopyComponents(const std::shared_ptr<entt::registry>& srcRegistry, const std::vector<entt::entity>& srcEntities,
+				const std::shared_ptr<entt::registry>& dstRegistry, const std::vector<entt::entity>& dstEntities);
+
+			bool mHasData = false;
+
+			std::vector<UUID> mIDs;
+			std::vector<entt::entity> mEntities; // Entity of each id in snapshot registry, same order as mIDs
+			std::shared_ptr<entt::registry> mRegistry = nullptr;
+
+		};
+	}
+}
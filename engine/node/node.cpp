@@ -17,11 +17,13 @@ namespace puffin
 
 		if (name.empty())
 		{
-			mName = "Node";
+			static const StringID defaultNameID = InternString("Node");
+
+			SetName(defaultNameID);
 		}
 		else
 		{
-			mName = name;
+			SetName(name);
 		}
 	}
 
@@ -30,6 +32,9 @@ namespace puffin
 		mRegistry = nullptr;
 		mEngine = nullptr;
 		mNodeID = gInvalidID;
+
+		mNameID = gEmptyStringID;
+		mNameSuffix = gNoNameSuffix;
 	}
 
 	void Node::Initialize()
@@ -79,6 +84,10 @@ namespace puffin
 	{
 	}
 
+	void Node::CopyFrom(const Node& node)
+	{
+	}
+
 	std::string_view Node::GetTypeString() const
 	{
 		return reflection::GetTypeString<Node>();
@@ -99,14 +108,70 @@ namespace puffin
 		return mEntity;
 	}
 
-	const std::string& Node::GetName() const
+	std::string Node::GetName() const
 	{
-		return mName;
+		return BuildName(mNameID, mNameSuffix);
 	}
 
 	void Node::SetName(const std::string& name)
 	{
-		mName = name;
+		StringID nameID;
+		uint32_t nameSuffix;
+		SplitName(name, nameID, nameSuffix);
+
+		SetName(nameID, nameSuffix);
+	}
+
+	void Node::SetName(StringID nameID, uint32_t nameSuffix)
+	{
+		mNameID = nameID;
+		mNameSuffix = nameSuffix;
+	}
+
+	StringID Node::GetNameID() const
+	{
+		return mNameID;
+	}
+
+	uint32_t Node::GetNameSuffix() const
+	{
+		return mNameSuffix;
+	}
+
+	void Node::SetNameSuffix(uint32_t nameSuffix)
+	{
+		SetName(mNameID, nameSuffix);
+	}
+
+	std::string Node::BuildName(StringID nameID, uint32_t nameSuffix)
+	{
+		if (nameSuffix == gNoNameSuffix)
+			return ResolveString(nameID);
+
+		return ResolveString(nameID) + " #" + std::to_string(nameSuffix);
+	}
+
+	void Node::SplitName(const std::string& name, StringID& nameID, uint32_t& nameSuffix)
+	{
+		// Split numbered names ("Body #123") so base name can be shared between nodes, suffixes with leading zeros are kept in base name
+		const size_t separatorIdx = name.rfind(" #");
+
+		if (separatorIdx != std::string::npos && separatorIdx + 2 < name.size() && name.size() <= separatorIdx + 12
+			&& (name[separatorIdx + 2] != '0' || name.size() == separatorIdx + 3)
+			&& name.find_first_not_of("0123456789", separatorIdx + 2) == std::string::npos)
+		{
+			const uint64_t suffix = std::stoull(name.substr(separatorIdx + 2));
+
+			if (suffix < gNoNameSuffix)
+			{
+				nameID = InternString(std::string_view(name).substr(0, separatorIdx));
+				nameSuffix = static_cast<uint32_t>(suffix);
+				return;
+			}
+		}
+
+		nameID = InternString(name);
+		nameSuffix = gNoNameSuffix;
 	}
 
 	void Node::QueueDestroy() const
@@ -128,14 +193,8 @@ namespace puffin
 
 	void Node::Reparent(const UUID& id)
 	{
-		if (mParentID != gInvalidID)
-		{
-			auto parent = GetParent();
-			if (parent)
-				parent->RemoveChildID(mNodeID);
-		}
-
-		SetParentID(id);
+		const auto sceneGraph = mEngine->GetSubsystem<scene::SceneGraphSubsystem>();
+		sceneGraph->ReparentNode(mNodeID, id);
 	}
 
 	void Node::GetChildren(std::vector<Node*>& children) const
@@ -194,4 +253,9 @@ namespace puffin
 	{
 		mChildIDs.remove(id);
 	}
+
+	void Node::RemoveChildIDs(const std::unordered_set<UUID>& ids)
+	{
+		mChildIDs.remove_if([&ids](const UUID& id) { return ids.find(id) != ids.end(); });
+	}
 }
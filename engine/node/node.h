@@ -2,9 +2,11 @@
 
 #include <list>
 #include <memory>
+#include <unordered_set>
 #include <entt/entity/registry.hpp>
 
 #include "types/uuid.h"
+#include "types/string_intern.h"
 #include "utility/reflection.h"
 #include "utility/serialization.h"
 
@@ -27,6 +29,8 @@ namespace puffin
 
 	const std::string gNodeTypeString = "Node";
 
+	constexpr uint32_t gNoNameSuffix = UINT32_MAX; // Node name has no numbered suffix
+
 	// PFN_TODO_SERIALIZATION - Remove as part of node serialization rework
 	struct NodeCustomData
 	{
@@ -35,6 +39,28 @@ namespace puffin
 		std::string nodeTypeString;
 	};
 
+	/*
+	 * How nodes of a type are scheduled when updated by the scene graph
+	 */
+	enum class NodeUpdateMode : uint8_t
+	{
+		Hierarchy, // Updated in scene graph order, parents before children
+		Serial, // Updated in pool order on the main thread, hierarchy order is not guaranteed
+		Parallel // Updated in pool order across enkiTS worker threads, Update/FixedUpdate must only modify the node itself, not allowed for Transform2DNode types
+	};
+
+	/*
+	 * Update scheduling for a node type, specialize for types which don't depend on hierarchy order
+	 * Traits are not inherited, a type derived from a serial/parallel type is updated in hierarchy order unless specialized as well.
+	 * Serial types wait for all previously queued parallel node updates
+	 */
+	template<typename T>
+	struct NodeUpdateTraits
+	{
+		static constexpr NodeUpdateMode updateMode = NodeUpdateMode::Hierarchy;
+		static constexpr bool updateBarrier = false; // Wait for all previously queued parallel node updates before updating this type
+	};
+
 	class Node
 	{
 	public:
@@ -76,6 +102,12 @@ namespace puffin
 		virtual void Serialize(nlohmann::json& json) const;
 		virtual void Deserialize(const nlohmann::json& json);
 
+		/*
+		 * Copy data written by Serialize from a node of the same type, so nodes can be instanced from template nodes
+		 * without going through json. Id, name, entity & hierarchy are left as they are
+		 */
+		virtual void CopyFrom(const Node& node);
+
 		/*
 		 * Return type string associated with this node type
 		 * This should be be overriden by inheriting types
@@ -91,8 +123,24 @@ namespace puffin
 		[[nodiscard]] UUID GetID() const;
 		[[nodiscard]] entt::entity GetEntity() const;
 
-		[[nodiscard]] const std::string& GetName() const;
+		/*
+		 * Name of node, only interned base name & suffix are stored on node, so names with a numbered
+		 * suffix ("Body #123") are built each time they are requested, use GetNameID/GetNameSuffix where possible
+		 */
+		[[nodiscard]] std::string GetName() const;
 		void SetName(const std::string& name);
+		void SetName(StringID nameID, uint32_t nameSuffix = gNoNameSuffix);
+
+		// Interned base name of node & numbered suffix, gNoNameSuffix if name doesn't have one
+		[[nodiscard]] StringID GetNameID() const;
+		[[nodiscard]] uint32_t GetNameSuffix() const;
+		void SetNameSuffix(uint32_t nameSuffix);
+
+		// Build full name from base name & suffix
+		static std::string BuildName(StringID nameID, uint32_t nameSuffix);
+
+		// Split name into interned base name & numbered suffix, suffix is gNoNameSuffix if name doesn't end in " #<number>"
+		static void SplitName(const std::string& name, StringID& nameID, uint32_t& nameSuffix);
 
 		/*
 		 * Queues node to be destroyed, will also destroy all child nodes
@@ -119,6 +167,9 @@ namespace puffin
 		// Remove a child id, for internal use only, use remove_child instead
 		void RemoveChildID(UUID id);
 
+		// Remove all child ids contained in ids, for internal use only
+		void RemoveChildIDs(const std::unordered_set<UUID>& ids);
+
 		template<typename T>
 		T& GetComponent()
 		{
@@ -152,7 +203,8 @@ namespace puffin
 	protected:
 
 		UUID mNodeID = gInvalidID;
-		std::string mName;
+		StringID mNameID = gEmptyStringID;
+		uint32_t mNameSuffix = gNoNameSuffix;
 
 		entt::entity mEntity;
 
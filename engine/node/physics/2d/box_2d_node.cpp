@@ -23,6 +23,16 @@ namespace puffin::physics
 		mHalfExtent = serialization::Deserialize<Vector2f>(boxJson["halfExtent"]);
 	}
 
+	void Box2DNode::CopyFrom(const Node& node)
+	{
+		Shape2DNode::CopyFrom(node);
+
+		const auto& boxNode = static_cast<const Box2DNode&>(node);
+
+		SetCentreOfMass(boxNode.GetCentreOfMass());
+		mHalfExtent = boxNode.mHalfExtent;
+	}
+
 	std::string_view Box2DNode::GetTypeString() const
 	{
 		return reflection::GetTypeString<Box2DNode>();
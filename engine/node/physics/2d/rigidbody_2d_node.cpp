@@ -33,6 +33,21 @@ namespace puffin::physics
 		mAngularVelocity = rigidbodyJson["angularVelocity"];
 	}
 
+	void Rigidbody2DNode::CopyFrom(const Node& node)
+	{
+		Transform2DNode::CopyFrom(node);
+
+		const auto& rigidbodyNode = static_cast<const Rigidbody2DNode&>(node);
+
+		mBodyType = rigidbodyNode.mBodyType;
+		mMass = rigidbodyNode.mMass;
+		mDensity = rigidbodyNode.mDensity;
+		mElasticity = rigidbodyNode.mElasticity;
+		mFriction = rigidbodyNode.mFriction;
+		mLinearVelocity = rigidbodyNode.mLinearVelocity;
+		mAngularVelocity = rigidbodyNode.mAngularVelocity;
+	}
+
 	std::string_view Rigidbody2DNode::GetTypeString() const
 	{
 		return reflection::GetTypeString<Rigidbody2DNode>();
@@ -35,6 +35,16 @@ namespace puffin::rendering
 		mOffset = serialization::Deserialize<Vector2f>(spriteJson["offset"]);
 	}
 
+	void Sprite2DNode::CopyFrom(const Node& node)
+	{
+		Transform2DNode::CopyFrom(node);
+
+		const auto& spriteNode = static_cast<const Sprite2DNode&>(node);
+
+		mColour = spriteNode.mColour;
+		mOffset = spriteNode.mOffset;
+	}
+
 	std::string_view Sprite2DNode::GetTypeString() const
 	{
 		return reflection::GetTypeString<Sprite2DNode>();
@@ -19,6 +19,7 @@ namespace puffin
 
 			void Serialize(nlohmann::json& json) const override;
 			void Deserialize(const nlohmann::json& json) override;
+			void CopyFrom(const Node& node) override;
 
 			[[nodiscard]] std::string_view GetTypeString() const override;
 			[[nodiscard]] entt::id_type GetTypeID() const override;
@@ -38,6 +38,13 @@ namespace puffin::rendering
 		mCastShadows = json["castShadows"];
 	}
 
+	void LightNode3D::CopyFrom(const Node& node)
+	{
+		TransformNode3D::CopyFrom(node);
+
+		mCastShadows = static_cast<const LightNode3D&>(node).mCastShadows;
+	}
+
 	std::string_view LightNode3D::GetTypeString() const
 	{
 		return gLightNode3DTypeString;
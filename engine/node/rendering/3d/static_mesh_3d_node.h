@@ -35,6 +35,18 @@ namespace puffin
 		};
 	}
 
+	/*
+	 * Static meshes have no per frame update of their own, they inherit Node's no-op Update/FixedUpdate, so they are safe to
+	 * update in parallel & are kept out of hierarchy order updates. Any Update/FixedUpdate override added to them must only
+	 * modify the node itself, or this specialization has to be removed
+	 */
+	template<>
+	struct NodeUpdateTraits<rendering::StaticMeshNode3D>
+	{
+		static constexpr NodeUpdateMode updateMode = NodeUpdateMode::Parallel;
+		static constexpr bool updateBarrier = false;
+	};
+
 	template<>
 	inline void reflection::RegisterType<rendering::StaticMeshNode3D>()
 	{
@@ -29,19 +29,6 @@ namespace puffin
 		mShouldUpdateGlobalTransform = false;
 	}
 
-	void Transform2DNode::Update(double deltaTime)
-	{
-		Node::Update(deltaTime);
-
-		UpdateLocalTransform();
-		UpdateGlobalTransform();
-	}
-
-	bool Transform2DNode::ShouldUpdate() const
-	{
-		return true;
-	}
-
 	void Transform2DNode::Serialize(nlohmann::json& json) const
 	{
 		Node::Serialize(json);
@@ -69,6 +56,17 @@ namespace puffin
 		UpdateGlobalTransform(true);
 	}
 
+	void Transform2DNode::CopyFrom(const Node& node)
+	{
+		Node::CopyFrom(node);
+
+		const auto& transformNode = static_cast<const Transform2DNode&>(node);
+
+		mLocalTransform = transformNode.mLocalTransform;
+
+		UpdateGlobalTransform(true);
+	}
+
 	std::string_view Transform2DNode::GetTypeString() const
 	{
 		return reflection::GetTypeString<Transform2DNode>();
@@ -175,7 +173,9 @@ namespace puffin
 	{
 		UpdateGlobalTransform();
 		NotifyLocalTransformShouldUpdate();
-		
+
+		++mGlobalTransformVersion;
+
 		return mGlobalTransform;
 	}
 
@@ -184,6 +184,8 @@ namespace puffin
 		NotifyLocalTransformShouldUpdate();
 
 		mGlobalTransform = transform;
+
+		++mGlobalTransformVersion;
 	}
 
 #ifdef PFN_DOUBLE_PRECISION
@@ -248,6 +250,30 @@ namespace puffin
 		GlobalTransform().scale = scale;
 	}
 
+	void Transform2DNode::UpdateTransforms(const Transform2D& parentGlobalTransform)
+	{
+		if (mShouldUpdateLocalTransform)
+		{
+			mLocalTransform = ApplyGlobalToLocalTransform(mGlobalTransform, parentGlobalTransform);
+
+			mShouldUpdateLocalTransform = false;
+		}
+
+		if (mShouldUpdateGlobalTransform)
+		{
+			mGlobalTransform = ApplyLocalToGlobalTransform(mLocalTransform, parentGlobalTransform);
+
+			mShouldUpdateGlobalTransform = false;
+
+			++mGlobalTransformVersion;
+		}
+	}
+
+	uint32_t Transform2DNode::GetGlobalTransformVersion() const
+	{
+		return mGlobalTransformVersion;
+	}
+
 	void Transform2DNode::NotifyLocalTransformShouldUpdate()
 	{
 		mShouldUpdateLocalTransform = true;
@@ -316,5 +342,7 @@ namespace puffin
 		}
 	
 		mShouldUpdateGlobalTransform = false;
+
+		++mGlobalTransformVersion;
 	}
 }
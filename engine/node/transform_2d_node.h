@@ -21,11 +21,9 @@ namespace puffin
 		void Initialize() override;
 		void Deinitialize() override;
 
-		void Update(double deltaTime) override;
-		bool ShouldUpdate() const override;
-
 		void Serialize(nlohmann::json& json) const override;
 		void Deserialize(const nlohmann::json& json) override;
+		void CopyFrom(const Node& node) override;
 
 		std::string_view GetTypeString() const override;
 		entt::id_type GetTypeID() const override;
@@ -74,6 +72,18 @@ namespace puffin
 		Vector2f& GlobalScale();
 		void SetGlobalScale(const Vector2f& scale);
 
+		/*
+		 * Update any out of date local/global transforms from an already up to date parent transform,
+		 * called by scene graph when propagating transforms through hierarchy
+		 */
+		void UpdateTransforms(const Transform2D& parentGlobalTransform);
+
+		/*
+		 * Version of global transform, incremented each time it is recalculated or modified,
+		 * used by scene graph to tell which nodes need updating in spatial index
+		 */
+		[[nodiscard]] uint32_t GetGlobalTransformVersion() const;
+
 	protected:
 
 		void NotifyLocalTransformShouldUpdate();
@@ -97,7 +107,9 @@ namespace puffin
 		Transform2D mGlobalTransform = Transform2D();
 
 		bool mShouldUpdateLocalTransform = false;
-		bool mShouldUpdateGlobalTransform = false;		
+		bool mShouldUpdateGlobalTransform = false;
+
+		uint32_t mGlobalTransformVersion = 0;
 
 	};
 
@@ -37,7 +37,7 @@ namespace puffin
 
 	TransformComponent3D& TransformNode3D::Transform()
 	{
-		mEngine->GetSubsystem<scene::SceneGraphSubsystem>()->NotifyTransformChanged(mNodeID);
+		NotifyTransformChanged();
 
 		return GetComponent<TransformComponent3D>();
 	}
@@ -47,6 +47,16 @@ namespace puffin
 		return mEngine->GetSubsystem<scene::SceneGraphSubsystem>()->GetNodeGlobalTransform3D(mNodeID);
 	}
 
+	uint32_t TransformNode3D::GetTransformVersion() const
+	{
+		return mTransformVersion;
+	}
+
+	void TransformNode3D::NotifyTransformChanged()
+	{
+		++mTransformVersion;
+	}
+
 	/*TransformComponent3D& TransformNode3D::GlobalTransform()
 	{
 		
@@ -68,7 +78,7 @@ namespace puffin
 	{
 		mRegistry->patch<TransformComponent3D>(mEntity, [&position](auto& transform) { transform.position = position; });
 
-		mEngine->GetSubsystem<scene::SceneGraphSubsystem>()->NotifyTransformChanged(mNodeID);
+		NotifyTransformChanged();
 	}
 #else
 	const Vector3f& TransformNode3D::GetPosition() const
@@ -85,7 +95,7 @@ namespace puffin
 	{
 		mRegistry->patch<TransformComponent3D>(mEntity, [&position](auto& transform) { transform.position = position; });
 
-		mEngine->GetSubsystem<scene::SceneGraphSubsystem>()->NotifyTransformChanged(mNodeID);
+		NotifyTransformChanged();
 	}
 #endif
 
@@ -103,7 +113,7 @@ namespace puffin
 	{
 		mRegistry->patch<TransformComponent3D>(mEntity, [&orientation](auto& transform) { transform.orientationQuat = orientation; });
 
-		mEngine->GetSubsystem<scene::SceneGraphSubsystem>()->NotifyTransformChanged(mNodeID);
+		NotifyTransformChanged();
 	}
 
 	const maths::EulerAngles& TransformNode3D::GetOrientationEulerAngles() const
@@ -120,7 +130,7 @@ namespace puffin
 	{
 		mRegistry->patch<TransformComponent3D>(mEntity, [&eulerAngles](auto& transform) { transform.orientationEulerAngles = eulerAngles; });
 
-		mEngine->GetSubsystem<scene::SceneGraphSubsystem>()->NotifyTransformChanged(mNodeID);
+		NotifyTransformChanged();
 	}
 
 	const Vector3f& TransformNode3D::SetScale() const
@@ -137,6 +147,6 @@ namespace puffin
 	{
 		mRegistry->patch<TransformComponent3D>(mEntity, [&scale](auto& transform) { transform.scale = scale; });
 
-		mEngine->GetSubsystem<scene::SceneGraphSubsystem>()->NotifyTransformChanged(mNodeID);
+		NotifyTransformChanged();
 	}
 }
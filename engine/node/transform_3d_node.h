@@ -32,6 +32,13 @@ namespace puffin
 		[[nodiscard]] const TransformComponent3D& GetGlobalTransform() const;
 		//[[nodiscard]] TransformComponent3D& GlobalTransform();
 
+		/*
+		 * Version of local transform, incremented each time it is modified,
+		 * used by scene graph to tell which global transforms need recalculating
+		 */
+		[[nodiscard]] uint32_t GetTransformVersion() const;
+		void NotifyTransformChanged();
+
 #ifdef PFN_DOUBLE_PRECISION
 		[[nodiscard]] const Vector3d& GetPosition() const;
 		[[nodiscard]] Vector3d& Position();
@@ -56,6 +63,10 @@ namespace puffin
 
 	protected:
 
+	private:
+
+		uint32_t mTransformVersion = 0;
+
 	};
 
 	template<>
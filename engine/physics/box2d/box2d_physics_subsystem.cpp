@@ -70,6 +70,9 @@ namespace puffin::physics
 
 		InitConnections();
 		InitSettingsAndSignals();
+
+		// Bodies are written back every tick, keep their components packed together
+		m_engine->GetSubsystem<ecs::EnTTSubsystem>()->RegisterGroup<RigidbodyComponent2D, TransformComponent2D, VelocityComponent2D>();
 	}
 
 	void Box2DPhysicsSubsystem::Deinitialize()
@@ -452,9 +455,12 @@ namespace puffin::physics
 		const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
 		const auto registry = enttSubsystem->GetRegistry();
 
-		const auto& view = registry->view<RigidbodyComponent2D>();
+		const auto group = registry->group<RigidbodyComponent2D, TransformComponent2D, VelocityComponent2D>();
+
+		// Write directly & mark changes in bulk, rather than firing update signals for every body
+		mUpdatedEntities.clear();
 
-		for (auto& [entity, rb] : view.each())
+		for (auto [entity, rb, transform, velocity] : group.each())
 		{
 			const auto id = enttSubsystem->GetID(entity);
 
@@ -466,36 +472,45 @@ namespace puffin::physics
 			b2Vec2 pos = b2Body_GetPosition(bodyData.bodyID);
 			b2Vec2 vel = b2Body_GetLinearVelocity(bodyData.bodyID);
 
-			if (registry->all_of<TransformComponent2D, VelocityComponent2D>(entity))
-			{
-				registry->patch<TransformComponent2D>(entity, [&](auto& transform)
-				{
-					transform.position.x = pos.x;
-					transform.position.y = pos.y;
-				});
+			transform.position.x = pos.x;
+			transform.position.y = pos.y;
 
-				registry->patch<VelocityComponent2D>(entity, [&](auto& velocity)
-				{
-					velocity.linear.x = vel.x;
-					velocity.linear.y = vel.y;
-				});
-			}
+			velocity.linear.x = vel.x;
+			velocity.linear.y = vel.y;
 
-			if (registry->all_of<TransformComponent3D, VelocityComponent3D>(entity))
-			{
-				registry->patch<TransformComponent3D>(entity, [&](auto& transform)
-				{
-					transform.position.x = pos.x;
-					transform.position.y = pos.y;
-				});
+			mUpdatedEntities.push_back(entity);
+		}
 
-				registry->patch<VelocityComponent3D>(entity, [&](auto& velocity)
-				{
-					velocity.linear.x = vel.x;
-					velocity.linear.y = vel.y;
-				});
-			}
+		enttSubsystem->MarkChanged<TransformComponent2D>(mUpdatedEntities.begin(), mUpdatedEntities.end());
+		enttSubsystem->MarkChanged<VelocityComponent2D>(mUpdatedEntities.begin(), mUpdatedEntities.end());
+
+		mUpdatedEntities.clear();
+
+		const auto view3D = registry->view<const RigidbodyComponent2D, TransformComponent3D, VelocityComponent3D>();
+
+		for (auto [entity, rb, transform, velocity] : view3D.each())
+		{
+			const auto id = enttSubsystem->GetID(entity);
+
+			if (mBodyData.find(id) == mBodyData.end())
+				continue;
+
+			const auto& bodyData = mBodyData.at(id);
+
+			b2Vec2 pos = b2Body_GetPosition(bodyData.bodyID);
+			b2Vec2 vel = b2Body_GetLinearVelocity(bodyData.bodyID);
+
+			transform.position.x = pos.x;
+			transform.position.y = pos.y;
+
+			velocity.linear.x = vel.x;
+			velocity.linear.y = vel.y;
+
+			mUpdatedEntities.push_back(entity);
 		}
+
+		enttSubsystem->MarkChanged<TransformComponent3D>(mUpdatedEntities.begin(), mUpdatedEntities.end());
+		enttSubsystem->MarkChanged<VelocityComponent3D>(mUpdatedEntities.begin(), mUpdatedEntities.end());
 	}
 
 	void Box2DPhysicsSubsystem::CreateBodyComponent(UUID id)
@@ -171,6 +171,8 @@ namespace puffin
 			RingBuffer<ShapeDestroyEvent> mShapeDestroyEvents;
 
 			std::vector<entt::connection> mConnections;
+
+			std::vector<entt::entity> mUpdatedEntities; // Entities written back this tick, reused to avoid reallocating
 		};
 	}
 
@@ -49,6 +49,9 @@ namespace puffin::physics
 		mOnDestroySphereConnection = registry->on_destroy<SphereComponent3D>().connect<&JoltPhysicsSubsystem::OnDestroySphere>(this);
 
 		mShapeRefs.Reserve(gMaxShapes);
+
+		// Bodies are written back every tick, keep their components packed together
+		enttSubsystem->RegisterGroup<RigidbodyComponent3D, TransformComponent3D, VelocityComponent3D>();
 		
 		InitSettingsAndSignals();
 	}
@@ -127,29 +130,28 @@ namespace puffin::physics
 		const auto registry = mEngine->GetSubsystem<ecs::EnTTSubsystem>()->GetRegistry();
 
 		// Updated entity position/rotation from simulation
-		const auto bodyView = registry->view<TransformComponent3D, VelocityComponent3D, const RigidbodyComponent3D>();
+		const auto bodyGroup = registry->group<RigidbodyComponent3D, TransformComponent3D, VelocityComponent3D>();
 
-		for (auto [entity, transform, velocity, rb] : bodyView.each())
+		for (auto [entity, rb, transform, velocity] : bodyGroup.each())
 		{
 			const auto& id = mEngine->GetSubsystem<ecs::EnTTSubsystem>()->GetID(entity);
 
 			// Update Transform from Rigidbody Position
-			registry->patch<TransformComponent3D>(entity, [&](auto& transform)
-			{
-				transform.position.x = mBodies[id]->GetCenterOfMassPosition().GetX();
-				transform.position.y = mBodies[id]->GetCenterOfMassPosition().GetY();
-				transform.position.z = mBodies[id]->GetCenterOfMassPosition().GetZ();
-				//transform.rotation = maths::radToDeg(-mBodies[id]->GetAngle());
-			});
-
-			// Update Velocity with Linear/Angular Velocity#
-			registry->patch<VelocityComponent3D>(entity, [&](auto& velocity)
-			{
-				velocity.linear.x = mBodies[id]->GetLinearVelocity().GetX();
-				velocity.linear.y = mBodies[id]->GetLinearVelocity().GetY();
-				velocity.linear.z = mBodies[id]->GetLinearVelocity().GetZ();
-			});
+			transform.position.x = mBodies[id]->GetCenterOfMassPosition().GetX();
+			transform.position.y = mBodies[id]->GetCenterOfMassPosition().GetY();
+			transform.position.z = mBodies[id]->GetCenterOfMassPosition().GetZ();
+			//transform.rotation = maths::radToDeg(-mBodies[id]->GetAngle());
+
+			// Update Velocity with Linear/Angular Velocity
+			velocity.linear.x = mBodies[id]->GetLinearVelocity().GetX();
+			velocity.linear.y = mBodies[id]->GetLinearVelocity().GetY();
+			velocity.linear.z = mBodies[id]->GetLinearVelocity().GetZ();
 		}
+
+		// Every body in group was written, so mark them all at once rather than firing update signals per body
+		const auto enttSubsystem = mEngine->GetSubsystem<ecs::EnTTSubsystem>();
+		enttSubsystem->MarkChanged<TransformComponent3D>(bodyGroup.begin(), bodyGroup.end());
+		enttSubsystem->MarkChanged<VelocityComponent3D>(bodyGroup.begin(), bodyGroup.end());
 	}
 
 	bool JoltPhysicsSubsystem::ShouldFixedUpdate()
@@ -335,12 +335,12 @@ namespace puffin
 			//enkiTSSubSystem->getTaskScheduler()->AddTaskSetToPipe(&transformTask);
 			//enkiTSSubSystem->getTaskScheduler()->WaitforTask(&transformTask);
 
+			// Transforms are written in place, so mark them changed in bulk once all threads are done rather than firing update signals per body
+			const auto enttSubsystem = mEngine->GetSubsystem<ecs::EnTTSubsystem>();
+
 			for (auto& entities : updatedEntities)
 			{
-				for (const auto& entity : entities)
-				{
-					registry->patch<TransformComponent2D>(entity, [](auto& transform) {});
-				}
+				enttSubsystem->MarkChanged<TransformComponent2D>(entities.begin(), entities.end());
 
 				entities.clear();
 			}
@@ -419,7 +419,8 @@ namespace puffin
 
 		void OnagerPhysicsSubystem2D::collisionResponse() const
 		{
-			const auto registry = mEngine->GetSubsystem<ecs::EnTTSubsystem>()->GetRegistry();
+			const auto enttSubsystem = mEngine->GetSubsystem<ecs::EnTTSubsystem>();
+			const auto registry = enttSubsystem->GetRegistry();
 
 			for (const collision2D::Contact& contact : mCollisionContacts)
 			{
@@ -461,15 +462,11 @@ namespace puffin
 
 					const Vector2 ds = (contact.pointOnB - contact.pointOnA) * contact.normal.Abs();
 
-					registry->patch<TransformComponent2D>(entityA, [&](auto& transform)
-					{
-						transform.position += ds * tA;
-					});
+					registry->get<TransformComponent2D>(entityA).position += ds * tA;
+					registry->get<TransformComponent2D>(entityB).position -= ds * tB;
 
-					registry->patch<TransformComponent2D>(entityB, [&](auto& transform)
-					{
-						transform.position -= ds * tB;
-					});
+					enttSubsystem->MarkChanged<TransformComponent2D>(entityA);
+					enttSubsystem->MarkChanged<TransformComponent2D>(entityB);
 				}
 			}
 		}
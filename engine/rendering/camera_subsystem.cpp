@@ -5,7 +5,9 @@
 #include "component/transform_component_3d.h"
 #include "component/rendering/3d/camera_component_3d.h"
 #include "core/settings_manager.h"
+#include "core/enkits_subsystem.h"
 #include "ecs/entt_subsystem.h"
+#include "ecs/parallel_each.h"
 #include "scene/scene_graph_subsystem.h"
 #include "core/signal_subsystem.h"
 
@@ -23,6 +25,7 @@ namespace puffin::rendering
 		auto* enttSubsystem = subsystemManager->CreateAndInitializeSubsystem<ecs::EnTTSubsystem>();
 		subsystemManager->CreateAndInitializeSubsystem<core::SignalSubsystem>();
 		subsystemManager->CreateAndInitializeSubsystem<core::SettingsManager>();
+		subsystemManager->CreateAndInitializeSubsystem<core::EnkiTSSubsystem>();
 
         const auto registry = enttSubsystem->GetRegistry();
 
@@ -176,18 +179,20 @@ namespace puffin::rendering
 
         const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
         const auto registry = enttSubsystem->GetRegistry();
+		const auto taskScheduler = m_engine->GetSubsystem<core::EnkiTSSubsystem>()->GetTaskScheduler();
 
+		// Cameras only write to their own component, so can be updated in parallel
 		const auto camera2DView = registry->view<const TransformComponent2D, CameraComponent2D>();
-		for (auto [entity, transform, camera] : camera2DView.each())
+		ecs::ParallelEach(*taskScheduler, camera2DView, [&](entt::entity entity, uint32_t threadIdx)
 		{
-			UpdateCameraComponent2D(transform, camera);
-		}
+			UpdateCameraComponent2D(camera2DView.get<const TransformComponent2D>(entity), camera2DView.get<CameraComponent2D>(entity));
+		}, gCameraUpdateGrainSize);
 
 		const auto camera3DView = registry->view<const TransformComponent3D, CameraComponent3D>();
-		for (auto [entity, transform, camera] : camera3DView.each())
+		ecs::ParallelEach(*taskScheduler, camera3DView, [&](entt::entity entity, uint32_t threadIdx)
 		{
-			UpdateCameraComponent3D(transform, camera);
-		}
+			UpdateCameraComponent3D(camera3DView.get<const TransformComponent3D>(entity), camera3DView.get<CameraComponent3D>(entity));
+		}, gCameraUpdateGrainSize);
 	}
 
 	void CameraSubsystem::UpdateCameraComponent2D(const TransformComponent2D& transform, CameraComponent2D& camera)
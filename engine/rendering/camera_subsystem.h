@@ -14,6 +14,8 @@ namespace puffin
 
 	namespace rendering
 	{
+		constexpr uint32_t gCameraUpdateGrainSize = 64;
+
 		struct CameraComponent2D;
 		struct CameraComponent3D;
 
@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include <cstdint>
+
+namespace puffin
+{
+	/*
+	 * Layout of cooked mesh files (.pmesh), written offline by PuffinCook so meshes are loaded without parsing
+	 * glTF/OBJ or json at runtime
+	 *
+	 * File starts with a header holding the location of each table, tables are aligned to gMeshBinaryAlignment so
+	 * vertex & index data can be uploaded straight from file contents. Indices of each sub mesh are relative to its
+	 * first vertex, they are stored as 16 bit when every sub mesh has few enough vertices, 32 bit otherwise
+	 */
+	constexpr uint32_t gMeshBinaryMagic = 0x48534D50; // "PMSH"
+	constexpr uint32_t gMeshBinaryVersion = 1;
+	constexpr uint32_t gMeshBinaryAlignment = 16;
+
+	// Location of a table within file
+	struct MeshBinaryRange
+	{
+		uint64_t offset = 0;
+		uint64_t size = 0; // Size in bytes
+	};
+
+	struct MeshBinaryHeader
+	{
+		uint32_t magic = gMeshBinaryMagic;
+		uint32_t version = gMeshBinaryVersion;
+		uint64_t fileSize = 0;
+
+		uint8_t vertexFormat = 0; // rendering::VertexFormat
+		uint8_t indexSize = 0; // Bytes per index, 2 or 4
+		uint16_t padding = 0;
+		uint32_t subMeshCount = 0;
+		uint64_t vertexCount = 0;
+		uint64_t indexCount = 0;
+
+		MeshBinaryRange subMeshes; // MeshBinarySubMesh per sub mesh
+		MeshBinaryRange vertices;
+		MeshBinaryRange indices;
+	};
+
+	struct MeshBinarySubMesh
+	{
+		uint64_t vertexOffset = 0; // Index of first vertex in vertex table
+		uint64_t indexOffset = 0; // Index of first index in index table
+		uint32_t vertexCount = 0;
+		uint32_t indexCount = 0;
+	};
+
+	constexpr uint64_t AlignMeshBinaryOffset(uint64_t offset)
+	{
+		return (offset + gMeshBinaryAlignment - 1) & ~static_cast<uint64_t>(gMeshBinaryAlignment - 1);
+	}
+}
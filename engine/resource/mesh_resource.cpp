@@ -0,0 +1,133 @@
+﻿#include "resource/mesh_resource.h"
+
+#include <cstring>
+#include <iostream>
+
+namespace puffin
+{
+	namespace
+	{
+		// Whether range lies inside a file of fileSize bytes
+		bool IsRangeInFile(const MeshBinaryRange& range, uint64_t fileSize)
+		{
+			return range.offset <= fileSize && range.size <= fileSize - range.offset;
+		}
+	}
+
+	MeshResource::MeshResource(fs::path path)
+		: Resource(std::move(path))
+	{
+	}
+
+	size_t MeshResource::GetMemoryUsage() const
+	{
+		return mVertexData.size() + mIndexData.size() + mSubMeshes.size() * sizeof(MeshBinarySubMesh);
+	}
+
+	rendering::VertexFormat MeshResource::GetVertexFormat() const
+	{
+		return mVertexFormat;
+	}
+
+	uint32_t MeshResource::GetVertexSize() const
+	{
+		return rendering::parseVertexSizeFromFormat(mVertexFormat);
+	}
+
+	uint64_t MeshResource::GetVertexCount() const
+	{
+		return mVertexCount;
+	}
+
+	const std::vector<uint8_t>& MeshResource::GetVertexData() const
+	{
+		return mVertexData;
+	}
+
+	uint8_t MeshResource::GetIndexSize() const
+	{
+		return mIndexSize;
+	}
+
+	uint64_t MeshResource::GetIndexCount() const
+	{
+		return mIndexCount;
+	}
+
+	const std::vector<uint8_t>& MeshResource::GetIndexData() const
+	{
+		return mIndexData;
+	}
+
+	const std::vector<MeshBinarySubMesh>& MeshResource::GetSubMeshes() const
+	{
+		return mSubMeshes;
+	}
+
+	bool MeshResource::Decode(std::vector<uint8_t>& fileData)
+	{
+		MeshBinaryHeader header;
+
+		if (fileData.size() < sizeof(MeshBinaryHeader))
+			return false;
+
+		std::memcpy(&header, fileData.data(), sizeof(MeshBinaryHeader));
+
+		if (header.magic != gMeshBinaryMagic || header.version != gMeshBinaryVersion || header.fileSize != fileData.size())
+		{
+			std::cout << "MeshResource::Decode - " << GetPath().string() << " is not a valid cooked mesh" << std::endl;
+			return false;
+		}
+
+		const auto vertexFormat = static_cast<rendering::VertexFormat>(header.vertexFormat);
+		const uint32_t vertexSize = rendering::parseVertexSizeFromFormat(vertexFormat);
+
+		if (vertexSize == 0 || (header.indexSize != 2 && header.indexSize != 4)
+			|| !IsRangeInFile(header.subMeshes, fileData.size()) || !IsRangeInFile(header.vertices, fileData.size())
+			|| !IsRangeInFile(header.indices, fileData.size())
+			|| header.subMeshes.size != header.subMeshCount * sizeof(MeshBinarySubMesh)
+			|| header.vertices.size != header.vertexCount * vertexSize
+			|| header.indices.size != header.indexCount * header.indexSize)
+		{
+			std::cout << "MeshResource::Decode - " << GetPath().string() << " has invalid tables" << std::endl;
+			return false;
+		}
+
+		mSubMeshes.resize(header.subMeshCount);
+		std::memcpy(mSubMeshes.data(), fileData.data() + header.subMeshes.offset, header.subMeshes.size);
+
+		for (const auto& subMesh : mSubMeshes)
+		{
+			if (subMesh.vertexOffset > header.vertexCount || subMesh.vertexCount > header.vertexCount - subMesh.vertexOffset
+				|| subMesh.indexOffset > header.indexCount || subMesh.indexCount > header.indexCount - subMesh.indexOffset)
+			{
+				std::cout << "MeshResource::Decode - " << GetPath().string() << " has invalid sub meshes" << std::endl;
+
+				mSubMeshes = {};
+				return false;
+			}
+		}
+
+		mVertexFormat = vertexFormat;
+		mVertexCount = header.vertexCount;
+		mIndexSize = header.indexSize;
+		mIndexCount = header.indexCount;
+
+		mVertexData.assign(fileData.begin() + header.vertices.offset, fileData.begin() + header.vertices.offset + header.vertices.size);
+		mIndexData.assign(fileData.begin() + header.indices.offset, fileData.begin() + header.indices.offset + header.indices.size);
+
+		return true;
+	}
+
+	void MeshResource::Release()
+	{
+		mVertexFormat = rendering::VertexFormat::Unknown;
+		mVertexCount = 0;
+		mIndexSize = 0;
+		mIndexCount = 0;
+
+		mVertexData = {};
+		mIndexData = {};
+		mSubMeshes = {};
+	}
+}
@@ -0,0 +1,51 @@
+﻿#pragma once
+
+#include <vector>
+
+#include "resource/mesh_binary.h"
+#include "resource/resource.h"
+#include "types/vertex.h"
+
+namespace puffin
+{
+	/*
+	 * Mesh loaded from a cooked mesh file, see mesh_binary.h
+	 */
+	class MeshResource : public Resource
+	{
+	public:
+
+		explicit MeshResource(fs::path path);
+		~MeshResource() override = default;
+
+		[[nodiscard]] size_t GetMemoryUsage() const override;
+
+		[[nodiscard]] rendering::VertexFormat GetVertexFormat() const;
+		[[nodiscard]] uint32_t GetVertexSize() const;
+		[[nodiscard]] uint64_t GetVertexCount() const;
+		[[nodiscard]] const std::vector<uint8_t>& GetVertexData() const;
+
+		[[nodiscard]] uint8_t GetIndexSize() const;
+		[[nodiscard]] uint64_t GetIndexCount() const;
+		[[nodiscard]] const std::vector<uint8_t>& GetIndexData() const;
+
+		[[nodiscard]] const std::vector<MeshBinarySubMesh>& GetSubMeshes() const;
+
+	protected:
+
+		bool Decode(std::vector<uint8_t>& fileData) override;
+		void Release() override;
+
+	private:
+
+		rendering::VertexFormat mVertexFormat = rendering::VertexFormat::Unknown;
+		uint64_t mVertexCount = 0;
+		uint8_t mIndexSize = 0;
+		uint64_t mIndexCount = 0;
+
+		std::vector<uint8_t> mVertexData;
+		std::vector<uint8_t> mIndexData;
+		std::vector<MeshBinarySubMesh> mSubMeshes;
+
+	};
+}
@@ -1,7 +1,11 @@
 ﻿#include "resource/resource.h"
 
+#include <cassert>
+#include <fstream>
+
 #include "resource/resource_data.h"
 #include "resource/resource_loader.h"
+#include "resource/resource_manager.h"
 
 namespace puffin
 {
@@ -18,12 +22,93 @@ namespace puffin
 		mPath.clear();
 	}
 
-	bool Resource::IsLoaded() const
+	bool Resource::Load()
+	{
+		const ResourceLoadState loadState = GetLoadState();
+
+		assert(loadState != ResourceLoadState::Queued && loadState != ResourceLoadState::Decoding && loadState != ResourceLoadState::Finalizing
+			&& "Resource::Load - Resource is already being loaded asynchronously");
+
+		if (loadState == ResourceLoadState::Loaded)
+			return true;
+
+		std::vector<uint8_t> fileData;
+
+		{
+			std::ifstream is(mPath, std::ios::in | std::ios::binary | std::ios::ate);
+
+			if (!is.is_open())
+			{
+				SetLoadState(ResourceLoadState::Failed);
+				return false;
+			}
+
+			fileData.resize(static_cast<size_t>(is.tellg()));
+
+			is.seekg(0);
+			is.read(reinterpret_cast<char*>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+		}
+
+		SetLoadState(ResourceLoadState::Decoding);
+
+		if (!Decode(fileData) || !Finalize())
+		{
+			Release();
+
+			SetLoadState(ResourceLoadState::Failed);
+			return false;
+		}
+
+		SetLoadState(ResourceLoadState::Loaded);
+
+		return true;
+	}
+
+	bool Resource::Unload()
 	{
-		if (!mResourceData)
+		const ResourceLoadState loadState = GetLoadState();
+
+		assert(loadState != ResourceLoadState::Queued && loadState != ResourceLoadState::Decoding && loadState != ResourceLoadState::Finalizing
+			&& "Resource::Unload - Resource is still being loaded asynchronously, unload it through resource manager instead");
+
+		if (loadState != ResourceLoadState::Loaded)
 			return false;
 
-		return mResourceData->IsLoaded();
+		Release();
+
+		SetLoadState(ResourceLoadState::Unloaded);
+
+		return true;
+	}
+
+	bool Resource::IsLoaded() const
+	{
+		return GetLoadState() == ResourceLoadState::Loaded;
+	}
+
+	ResourceLoadState Resource::GetLoadState() const
+	{
+		return mLoadState.load(std::memory_order_acquire);
+	}
+
+	const fs::path& Resource::GetPath() const
+	{
+		return mPath;
+	}
+
+	ResourceID Resource::GetID() const
+	{
+		return mID;
+	}
+
+	uint32_t Resource::GetRefCount() const
+	{
+		return mRefCount;
+	}
+
+	bool Resource::IsHandleManaged() const
+	{
+		return mHandleManaged;
 	}
 
 	ResourceData* Resource::GetResourceData() const
@@ -35,4 +120,37 @@ namespace puffin
 	{
 		return mResourceLoader.get();
 	}
+
+	void Resource::SetLoadState(ResourceLoadState loadState)
+	{
+		const ResourceLoadState previousLoadState = mLoadState.exchange(loadState, std::memory_order_acq_rel);
+
+		if (!mResourceManager || previousLoadState == loadState)
+			return;
+
+		// Resources only enter & leave loaded state on main thread
+		if (loadState == ResourceLoadState::Loaded)
+			mResourceManager->OnResourceLoaded(this);
+		else if (previousLoadState == ResourceLoadState::Loaded)
+			mResourceManager->OnResourceUnloaded(this);
+	}
+
+	void Resource::AddRef()
+	{
+		++mRefCount;
+		mHandleManaged = true;
+
+		if (mRefCount == 1 && mResourceManager)
+			mResourceManager->OnResourceReferenced(this);
+	}
+
+	void Resource::RemoveRef()
+	{
+		assert(mRefCount > 0 && "Resource::RemoveRef - Resource has no references to remove");
+
+		--mRefCount;
+
+		if (mRefCount == 0 && mResourceManager)
+			mResourceManager->OnResourceUnreferenced(this);
+	}
 }
@@ -1,6 +1,12 @@
 ﻿#pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "resource/resource_id.h"
 
 namespace fs = std::filesystem;
 
@@ -8,11 +14,29 @@ namespace puffin
 {
 	class ResourceLoader;
 	class ResourceData;
+	class ResourceManager;
+
+	template<typename T>
+	class ResourceHandle;
+
+	enum class ResourceLoadState : uint8_t
+	{
+		Unloaded,
+		Queued, // Waiting for file to be read on I/O thread
+		Decoding,
+		Finalizing, // Decoded, waiting for main thread
+		Loaded,
+		Failed
+	};
 
 	/*
 	 * Representation of an asset or file loaded from disk, such as a mesh or image
 	 * cano be used on its own for inline loading of a resource, or in conjunction
 	 * with a resource manager for managed lifetime
+	 *
+	 * Loading is split into stages so resource manager can run them asynchronously, file is read on I/O thread,
+	 * Decode is called on a worker thread with file contents, then Finalize on main thread for work which has to
+	 * happen there, such as uploading to GPU
 	 */
 	class Resource
 	{
@@ -21,19 +45,42 @@ namespace puffin
 		Resource(fs::path path);
 		virtual ~Resource();
 
-		virtual bool Load() = 0;
-		virtual bool LoadAsync() = 0;
-		virtual bool Unload() = 0;
-		virtual bool UnloadAsync() = 0;
+		// Read, decode & finalize resource on calling thread, file is read straight from disk
+		bool Load();
+		bool Unload();
+
+		[[nodiscard]] bool IsLoaded() const;
+		[[nodiscard]] ResourceLoadState GetLoadState() const;
+
+		[[nodiscard]] const fs::path& GetPath() const;
+
+		// Id resource was registered under by its resource manager, invalid for resources used on their own
+		[[nodiscard]] ResourceID GetID() const;
+
+		// Bytes of memory held by loaded resource, read by resource manager once resource has loaded
+		[[nodiscard]] virtual size_t GetMemoryUsage() const { return 0; }
+
+		// Number of handles referencing resource, resources without any are candidates for eviction
+		[[nodiscard]] uint32_t GetRefCount() const;
 
-		bool IsLoaded() const;
+		// Whether resource has been referenced by a handle, only such resources are ever evicted
+		[[nodiscard]] bool IsHandleManaged() const;
 
 	protected:
 
+		// Decode file contents into resource data, called from worker threads so must only touch this resource
+		virtual bool Decode(std::vector<uint8_t>& fileData) = 0;
+
+		// Finish loading on main thread, once decoding has succeeded
+		virtual bool Finalize() { return true; }
+
+		// Free decoded data, called on main thread
+		virtual void Release() = 0;
+
 		template<typename T>
 		T* GetResourceData() const
 		{
-			return dynamic_cast<T*>(mResourceData);
+			return dynamic_cast<T*>(mResourceData.get());
 		}
 
 		ResourceData* GetResourceData() const;
@@ -41,16 +88,36 @@ namespace puffin
 		template<typename T>
 		T* GetResourceLoader() const
 		{
-			return dynamic_cast<T*>(mResourceLoader);
+			return dynamic_cast<T*>(mResourceLoader.get());
 		}
 
 		ResourceLoader* GetResourceLoader() const;
 
 	private:
 
+		friend class ResourceManager;
+
+		template<typename T>
+		friend class ResourceHandle;
+
+		// Loaded/unloaded transitions are reported to owning resource manager for memory accounting
+		void SetLoadState(ResourceLoadState loadState);
+
+		// Handles are expected to be copied & released on main thread, along with other resource manager calls
+		void AddRef();
+		void RemoveRef();
+
 		fs::path mPath;
-		std::unique_ptr<ResourceData> mResourceData = nullptr;
-		std::unique_ptr<ResourceLoader> mResourceLoader = nullptr;
+		ResourceID mID = gInvalidResourceID;
+		std::unique_ptr<ResourceData> mResourceData;
+		std::unique_ptr<ResourceLoader> mResourceLoader;
+
+		std::atomic<ResourceLoadState> mLoadState = ResourceLoadState::Unloaded;
+
+		ResourceManager* mResourceManager = nullptr; // Set if resource is owned by a resource manager
+		uint32_t mRefCount = 0;
+		bool mHandleManaged = false; // Set once first handle references resource & never cleared
+		size_t mAccountedMemory = 0; // Memory usage recorded by resource manager when resource loaded
 
 	};
-}
\ No newline at end of file
+}
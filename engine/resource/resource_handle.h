@@ -0,0 +1,124 @@
+﻿#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "resource/resource.h"
+
+namespace puffin
+{
+	/*
+	 * Typed reference to a resource owned by a resource manager, keeps resource from being evicted while any handle
+	 * to it exists. Handles must be released before the resource manager that created them is destroyed
+	 */
+	template<typename T>
+	class ResourceHandle
+	{
+	public:
+
+		static_assert(std::is_base_of_v<Resource, T>, "ResourceHandle - T must derive from Resource");
+
+		ResourceHandle() = default;
+
+		~ResourceHandle()
+		{
+			Reset();
+		}
+
+		ResourceHandle(const ResourceHandle& other)
+			: mResource(other.mResource)
+		{
+			if (mResource)
+				static_cast<Resource*>(mResource)->AddRef();
+		}
+
+		ResourceHandle(ResourceHandle&& other) noexcept
+			: mResource(std::exchange(other.mResource, nullptr))
+		{
+		}
+
+		ResourceHandle& operator=(const ResourceHandle& other)
+		{
+			if (this != &other)
+			{
+				// Reference new resource first, so reassigning a handle to the same resource never drops it to zero
+				if (other.mResource)
+					static_cast<Resource*>(other.mResource)->AddRef();
+
+				Reset();
+
+				mResource = other.mResource;
+			}
+
+			return *this;
+		}
+
+		ResourceHandle& operator=(ResourceHandle&& other) noexcept
+		{
+			if (this != &other)
+			{
+				Reset();
+
+				mResource = std::exchange(other.mResource, nullptr);
+			}
+
+			return *this;
+		}
+
+		// Release reference to resource, leaving handle empty
+		void Reset()
+		{
+			if (mResource)
+				static_cast<Resource*>(std::exchange(mResource, nullptr))->RemoveRef();
+		}
+
+		[[nodiscard]] T* Get() const
+		{
+			return mResource;
+		}
+
+		[[nodiscard]] bool IsLoaded() const
+		{
+			return mResource && mResource->IsLoaded();
+		}
+
+		T* operator->() const
+		{
+			return mResource;
+		}
+
+		T& operator*() const
+		{
+			return *mResource;
+		}
+
+		explicit operator bool() const
+		{
+			return mResource != nullptr;
+		}
+
+		bool operator==(const ResourceHandle& other) const
+		{
+			return mResource == other.mResource;
+		}
+
+		bool operator!=(const ResourceHandle& other) const
+		{
+			return mResource != other.mResource;
+		}
+
+	private:
+
+		friend class ResourceManager;
+
+		explicit ResourceHandle(T* resource)
+			: mResource(resource)
+		{
+			if (mResource)
+				static_cast<Resource*>(mResource)->AddRef();
+		}
+
+		T* mResource = nullptr;
+
+	};
+}
@@ -0,0 +1,14 @@
+﻿#pragma once
+
+#include <cstdint>
+
+namespace puffin
+{
+	/*
+	 * Id of a resource, hash of its normalized path so the same path always gets the same id, matches id of
+	 * its entry in resource packs
+	 */
+	using ResourceID = uint64_t;
+
+	constexpr ResourceID gInvalidResourceID = 0;
+}
@@ -1,9 +1,74 @@
 ﻿#include "resource/resource_manager.h"
 
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "TaskScheduler.h"
+
 #include "resource/resource.h"
+#include "resource/resource_pack.h"
 
 namespace puffin
 {
+	namespace
+	{
+		enki::TaskPriority GetTaskPriority(ResourceLoadPriority priority)
+		{
+			switch (priority)
+			{
+			case ResourceLoadPriority::High:
+				return enki::TASK_PRIORITY_HIGH;
+			case ResourceLoadPriority::Low:
+				return enki::TASK_PRIORITY_LOW;
+			default:
+				return enki::TASK_PRIORITY_MED;
+			}
+		}
+	}
+
+	struct ResourceManager::IOTask : enki::IPinnedTask
+	{
+		IOTask(ResourceManager* manager, uint32_t threadNum)
+			: enki::IPinnedTask(threadNum), manager(manager)
+		{
+		}
+
+		void Execute() override
+		{
+			manager->RunIOStage();
+		}
+
+		ResourceManager* manager = nullptr;
+	};
+
+	/*
+	 * One async load, owned by main thread while in flight, I/O thread & workers only touch it between
+	 * being handed it through a queue and handing it on
+	 */
+	struct ResourceManager::LoadRequest
+	{
+		Resource* resource = nullptr;
+		ResourceLoadPriority priority = ResourceLoadPriority::Normal;
+		std::vector<ResourceLoadCallback> callbacks;
+
+		std::atomic<bool> cancelled = false;
+		bool skipped = false; // A stage saw request cancelled & skipped its work
+		bool read = false;
+		bool decoded = false; // Decode was run, resource may hold data to release even if it failed
+		bool decodeSucceeded = false;
+
+		std::vector<uint8_t> fileData;
+
+		std::unique_ptr<IOTask> ioTask;
+		std::unique_ptr<enki::TaskSet> decodeTask;
+
+		std::atomic<bool> decodeQueued = false; // Set once file has been read & decode task is about to be added
+		std::atomic<bool> stagesDone = false; // Set once request has been pushed to decoded requests
+	};
+
 	ResourceManager::ResourceManager()
 	{
 		
@@ -11,13 +76,17 @@ namespace puffin
 
 	ResourceManager::~ResourceManager()
 	{
-		for (auto& [path, resource] : mResources)
+		StopAsyncLoading();
+
+		for (auto& [id, resource] : mResources)
 		{
 			if (resource->IsLoaded())
 				resource->Unload();
 		}
 
 		mResources.clear();
+
+		mPacks.clear();
 	}
 
 	void ResourceManager::Initialize(const io::ProjectFile& projectFile, const fs::path& projectPath)
@@ -26,34 +95,379 @@ namespace puffin
 		mProjectPath = projectPath;
 		mProjectPath.remove_filename();
 
+		mRegistry.SetRootPath(mProjectPath);
+
 		mEnginePath = FindEngineRoot(fs::current_path());
 	}
 
-	Resource* ResourceManager::GetResource(fs::path resourcePath)
+	ResourceID ResourceManager::RegisterResourcePath(const fs::path& resourcePath)
 	{
-		// PUFFIN_TODO - Implement
-		return nullptr;
+		return mRegistry.Register(resourcePath);
 	}
 
-	Resource* ResourceManager::LoadResource(fs::path resourcePath)
+	ResourceID ResourceManager::GetResourceID(const fs::path& resourcePath) const
 	{
-		// PUFFIN_TODO - Implement
-		return nullptr;
+		return mRegistry.GetID(resourcePath);
 	}
 
-	void ResourceManager::LoadResourceAsync(fs::path resourcePath)
+	const ResourceRegistry& ResourceManager::GetRegistry() const
 	{
-		// PUFFIN_TODO - Implement
+		return mRegistry;
 	}
 
-	void ResourceManager::UnloadResource(fs::path resourcePath)
+	Resource* ResourceManager::GetResource(ResourceID id)
 	{
-		// PUFFIN_TODO - Implement
+		const auto it = mResources.find(id);
+
+		return it != mResources.end() ? it->second.get() : nullptr;
 	}
 
-	void ResourceManager::UnloadResourceAsync(fs::path resourcePath)
+	Resource* ResourceManager::LoadResource(ResourceID id)
 	{
-		// PUFFIN_TODO - Implement
+		Resource* resource = GetResource(id);
+		if (!resource)
+			return nullptr;
+
+		assert((!resource->IsHandleManaged() || resource->GetRefCount() > 0)
+			&& "ResourceManager::LoadResource - Resource is managed through handles, acquire a handle to it before loading it so it isn't evicted");
+
+		if (const auto it = mLoadRequests.find(id); it != mLoadRequests.end())
+			WaitForRequest(it->second.get());
+
+		if (!resource->IsLoaded() && !LoadResourceImmediate(resource))
+			return nullptr;
+
+		return resource;
+	}
+
+	bool ResourceManager::LoadResourceAsync(ResourceID id, ResourceLoadPriority priority, ResourceLoadCallback callback)
+	{
+		Resource* resource = GetResource(id);
+		if (!resource)
+			return false;
+
+		// Share load already in flight, cancelled requests are restarted once their stages have seen cancellation
+		if (const auto it = mLoadRequests.find(id); it != mLoadRequests.end())
+		{
+			auto& request = it->second;
+
+			request->cancelled = false;
+
+			if (callback)
+				request->callbacks.push_back(std::move(callback));
+
+			return true;
+		}
+
+		mPendingUnloads.erase(std::remove(mPendingUnloads.begin(), mPendingUnloads.end(), id), mPendingUnloads.end());
+
+		if (resource->IsLoaded())
+		{
+			if (callback)
+				mPendingCallbacks.emplace_back(resource, std::move(callback));
+
+			return true;
+		}
+
+		auto request = std::make_unique<LoadRequest>();
+		request->resource = resource;
+		request->priority = priority;
+
+		if (callback)
+			request->callbacks.push_back(std::move(callback));
+
+		StartRequest(std::move(request));
+
+		return true;
+	}
+
+	void ResourceManager::CancelLoad(ResourceID id)
+	{
+		if (const auto it = mLoadRequests.find(id); it != mLoadRequests.end())
+			it->second->cancelled = true;
+	}
+
+	void ResourceManager::UnloadResource(ResourceID id)
+	{
+		Resource* resource = GetResource(id);
+		if (!resource)
+			return;
+
+		if (const auto it = mLoadRequests.find(id); it != mLoadRequests.end())
+		{
+			LoadRequest* request = it->second.get();
+			request->cancelled = true;
+
+			WaitForRequest(request);
+		}
+
+		mPendingUnloads.erase(std::remove(mPendingUnloads.begin(), mPendingUnloads.end(), id), mPendingUnloads.end());
+
+		if (resource->IsLoaded())
+			resource->Unload();
+	}
+
+	void ResourceManager::UnloadResourceAsync(ResourceID id)
+	{
+		Resource* resource = GetResource(id);
+		if (!resource)
+			return;
+
+		CancelLoad(id);
+
+		if (resource->IsLoaded() && std::find(mPendingUnloads.begin(), mPendingUnloads.end(), id) == mPendingUnloads.end())
+			mPendingUnloads.push_back(id);
+	}
+
+	bool ResourceManager::IsLoaded(ResourceID id) const
+	{
+		const auto it = mResources.find(id);
+
+		return it != mResources.end() && it->second->IsLoaded();
+	}
+
+	ResourceLoadState ResourceManager::GetLoadState(ResourceID id) const
+	{
+		const auto it = mResources.find(id);
+
+		return it != mResources.end() ? it->second->GetLoadState() : ResourceLoadState::Unloaded;
+	}
+
+	void ResourceManager::StartAsyncLoading(enki::TaskScheduler* taskScheduler, uint32_t ioThreadNum)
+	{
+		assert(taskScheduler && "ResourceManager::StartAsyncLoading - Task scheduler is null");
+		assert(ioThreadNum < taskScheduler->GetNumTaskThreads() && "ResourceManager::StartAsyncLoading - Invalid I/O thread");
+
+		StopAsyncLoading();
+
+		mTaskScheduler = taskScheduler;
+		mIOThreadNum = ioThreadNum;
+	}
+
+	void ResourceManager::StopAsyncLoading()
+	{
+		for (auto& [id, request] : mLoadRequests)
+		{
+			request->cancelled = true;
+		}
+
+		while (!mLoadRequests.empty())
+		{
+			WaitForRequest(mLoadRequests.begin()->second.get());
+		}
+
+		if (mTaskScheduler)
+		{
+			for (const auto& request : mRetiredRequests)
+			{
+				if (request->ioTask)
+					mTaskScheduler->WaitforTask(request->ioTask.get());
+
+				if (request->decodeTask)
+					mTaskScheduler->WaitforTask(request->decodeTask.get());
+			}
+		}
+
+		mRetiredRequests.clear();
+
+		// Callbacks of cancelled requests may have queued new ones, those are dropped
+		mPendingCallbacks.clear();
+
+		mTaskScheduler = nullptr;
+	}
+
+	void ResourceManager::Update()
+	{
+		if (!mPendingCallbacks.empty())
+		{
+			auto pendingCallbacks = std::move(mPendingCallbacks);
+			mPendingCallbacks.clear();
+
+			for (auto& [resource, callback] : pendingCallbacks)
+			{
+				callback(resource, resource->IsLoaded());
+			}
+		}
+
+		std::vector<LoadRequest*> decodedRequests;
+
+		{
+			std::lock_guard lock(mDecodedMutex);
+			decodedRequests.swap(mDecodedRequests);
+		}
+
+		for (auto* request : decodedRequests)
+		{
+			FinalizeRequest(request);
+		}
+
+		if (!mPendingUnloads.empty())
+		{
+			auto pendingUnloads = std::move(mPendingUnloads);
+			mPendingUnloads.clear();
+
+			for (const ResourceID id : pendingUnloads)
+			{
+				// Resource may have been requested again since
+				if (mLoadRequests.find(id) != mLoadRequests.end())
+					continue;
+
+				if (Resource* resource = GetResource(id); resource && resource->IsLoaded())
+					resource->Unload();
+			}
+		}
+
+		EvictUnreferencedResources();
+
+		// Tasks signal completion after their last access to request, so only free them once they have
+		mRetiredRequests.erase(std::remove_if(mRetiredRequests.begin(), mRetiredRequests.end(), [](const auto& request)
+		{
+			return (!request->ioTask || request->ioTask->GetIsComplete())
+				&& (!request->decodeTask || request->decodeTask->GetIsComplete());
+		}), mRetiredRequests.end());
+	}
+
+	void ResourceManager::SetMemoryBudget(size_t memoryBudget)
+	{
+		mMemoryBudget = memoryBudget;
+	}
+
+	size_t ResourceManager::GetMemoryBudget() const
+	{
+		return mMemoryBudget;
+	}
+
+	size_t ResourceManager::GetMemoryUsage() const
+	{
+		return mMemoryUsage;
+	}
+
+	size_t ResourceManager::GetTypeMemoryUsage(std::type_index type) const
+	{
+		const auto it = mTypeMemoryUsage.find(type);
+
+		return it != mTypeMemoryUsage.end() ? it->second : 0;
+	}
+
+	bool ResourceManager::MountPack(const fs::path& packPath)
+	{
+		assert(mLoadRequests.empty() && "ResourceManager::MountPack - Packs cannot be mounted while resources are loading");
+
+		auto pack = std::make_unique<ResourcePack>();
+
+		if (!pack->Open(packPath))
+		{
+			std::cout << "ResourceManager::MountPack - Failed to mount " << packPath.string() << std::endl;
+			return false;
+		}
+
+		// Remounting a pack moves it to the back, so it takes priority again
+		UnmountPack(packPath);
+
+		// Intern entry paths up front, entries added under explicit ids rather than their path are left out
+		const ResourcePackEntry* entries = pack->GetEntries();
+
+		for (size_t idx = 0; idx < pack->GetEntryCount(); ++idx)
+		{
+			const fs::path entryPath = pack->GetEntryPath(entries[idx]);
+
+			if (!entryPath.empty() && mRegistry.GetID(entryPath) == entries[idx].id)
+				mRegistry.Register(entryPath);
+		}
+
+		mPacks.push_back(std::move(pack));
+
+		return true;
+	}
+
+	void ResourceManager::UnmountPack(const fs::path& packPath)
+	{
+		assert(mLoadRequests.empty() && "ResourceManager::UnmountPack - Packs cannot be unmounted while resources are loading");
+
+		mPacks.erase(std::remove_if(mPacks.begin(), mPacks.end(), [&](const auto& pack)
+		{
+			return pack->GetPath() == packPath;
+		}), mPacks.end());
+	}
+
+	bool ResourceManager::ReadResourceFile(ResourceID id, std::vector<uint8_t>& data) const
+	{
+		const ResourcePackEntry* entry = nullptr;
+
+		if (const ResourcePack* pack = FindPack(id, entry))
+			return pack->Read(*entry, data);
+
+		const fs::path filePath = mRegistry.GetFilePath(id);
+
+		if (filePath.empty())
+		{
+			data.clear();
+			return false;
+		}
+
+		return ReadLooseFile(filePath, data);
+	}
+
+	bool ResourceManager::ReadResourceFile(const fs::path& resourcePath, std::vector<uint8_t>& data) const
+	{
+		const ResourcePackEntry* entry = nullptr;
+
+		if (const ResourcePack* pack = FindPack(mRegistry.GetID(resourcePath), entry))
+			return pack->Read(*entry, data);
+
+		return ReadLooseFile(resourcePath, data);
+	}
+
+	bool ResourceManager::ReadResourceFiles(const std::vector<fs::path>& resourcePaths, std::vector<std::vector<uint8_t>>& data,
+		enki::TaskScheduler* taskScheduler) const
+	{
+		data.clear();
+		data.resize(resourcePaths.size());
+
+		// Lookups are done up front, so workers only decompress
+		std::vector<const ResourcePack*> packs(resourcePaths.size(), nullptr);
+		std::vector<const ResourcePackEntry*> entries(resourcePaths.size(), nullptr);
+
+		if (!mPacks.empty())
+		{
+			for (size_t idx = 0; idx < resourcePaths.size(); ++idx)
+			{
+				packs[idx] = FindPack(mRegistry.GetID(resourcePaths[idx]), entries[idx]);
+			}
+		}
+
+		std::vector<uint8_t> results(resourcePaths.size(), 0);
+
+		auto readFile = [&](size_t idx)
+		{
+			if (packs[idx])
+				results[idx] = packs[idx]->Read(*entries[idx], data[idx]);
+			else
+				results[idx] = ReadLooseFile(resourcePaths[idx], data[idx]);
+		};
+
+		if (taskScheduler && resourcePaths.size() > 1)
+		{
+			enki::TaskSet task(static_cast<uint32_t>(resourcePaths.size()), [&](enki::TaskSetPartition range, uint32_t threadIdx)
+			{
+				for (uint32_t idx = range.start; idx < range.end; ++idx)
+				{
+					readFile(idx);
+				}
+			});
+
+			taskScheduler->AddTaskSetToPipe(&task);
+			taskScheduler->WaitforTask(&task);
+		}
+		else
+		{
+			for (size_t idx = 0; idx < resourcePaths.size(); ++idx)
+			{
+				readFile(idx);
+			}
+		}
+
+		return std::all_of(results.begin(), results.end(), [](uint8_t result) { return result != 0; });
 	}
 
 	fs::path ResourceManager::GetProjectPath() const
@@ -66,6 +480,330 @@ namespace puffin
 		return mEnginePath;
 	}
 
+	const ResourcePack* ResourceManager::FindPack(ResourceID id, const ResourcePackEntry*& entry) const
+	{
+		for (auto it = mPacks.rbegin(); it != mPacks.rend(); ++it)
+		{
+			if ((entry = (*it)->FindEntry(id)))
+				return it->get();
+		}
+
+		entry = nullptr;
+		return nullptr;
+	}
+
+	bool ResourceManager::ReadLooseFile(const fs::path& resourcePath, std::vector<uint8_t>& data) const
+	{
+		data.clear();
+
+		const fs::path filePath = resourcePath.is_absolute() ? resourcePath : mProjectPath / resourcePath;
+
+		std::ifstream is(filePath, std::ios::in | std::ios::binary | std::ios::ate);
+
+		if (!is.is_open())
+			return false;
+
+		data.resize(static_cast<size_t>(is.tellg()));
+
+		is.seekg(0);
+		is.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+		return static_cast<bool>(is);
+	}
+
+	void ResourceManager::OnResourceLoaded(Resource* resource)
+	{
+		resource->mAccountedMemory = resource->GetMemoryUsage();
+
+		mMemoryUsage += resource->mAccountedMemory;
+		mTypeMemoryUsage[std::type_index(typeid(*resource))] += resource->mAccountedMemory;
+
+		// Loading counts as a use, so freshly loaded resources are evicted last. Resources only ever used through
+		// raw pointers are never evicted, as there is no way to tell whether they are still in use
+		if (resource->mHandleManaged && resource->mRefCount == 0)
+			AddUnreferencedResource(resource);
+	}
+
+	void ResourceManager::OnResourceUnloaded(Resource* resource)
+	{
+		mMemoryUsage -= resource->mAccountedMemory;
+		mTypeMemoryUsage[std::type_index(typeid(*resource))] -= resource->mAccountedMemory;
+
+		resource->mAccountedMemory = 0;
+
+		RemoveUnreferencedResource(resource);
+	}
+
+	void ResourceManager::OnResourceReferenced(Resource* resource)
+	{
+		RemoveUnreferencedResource(resource);
+	}
+
+	void ResourceManager::OnResourceUnreferenced(Resource* resource)
+	{
+		if (resource->IsLoaded())
+			AddUnreferencedResource(resource);
+	}
+
+	void ResourceManager::AddUnreferencedResource(Resource* resource)
+	{
+		RemoveUnreferencedResource(resource);
+
+		mUnreferencedPositions.emplace(resource, mUnreferencedResources.insert(mUnreferencedResources.end(), resource));
+	}
+
+	void ResourceManager::RemoveUnreferencedResource(Resource* resource)
+	{
+		if (const auto it = mUnreferencedPositions.find(resource); it != mUnreferencedPositions.end())
+		{
+			mUnreferencedResources.erase(it->second);
+			mUnreferencedPositions.erase(it);
+		}
+	}
+
+	void ResourceManager::EvictUnreferencedResources()
+	{
+		if (mMemoryBudget == 0)
+			return;
+
+		// Unloading removes resource from unreferenced list
+		while (mMemoryUsage > mMemoryBudget && !mUnreferencedResources.empty())
+		{
+			mUnreferencedResources.front()->Unload();
+		}
+	}
+
+	void ResourceManager::RunIOStage()
+	{
+		LoadRequest* request = nullptr;
+
+		{
+			std::lock_guard lock(mIOMutex);
+
+			for (auto& queue : mIOQueues)
+			{
+				if (!queue.empty())
+				{
+					request = queue.front();
+					queue.pop_front();
+					break;
+				}
+			}
+		}
+
+		if (!request)
+			return;
+
+		if (request->cancelled)
+		{
+			request->skipped = true;
+		}
+		else
+		{
+			request->read = ReadResourceFile(request->resource->GetID(), request->fileData);
+
+			if (request->read)
+			{
+				request->resource->SetLoadState(ResourceLoadState::Decoding);
+
+				// Set before adding task, request may be finalized & freed as soon as task is added
+				request->decodeQueued.store(true, std::memory_order_release);
+
+				mTaskScheduler->AddTaskSetToPipe(request->decodeTask.get());
+				return;
+			}
+		}
+
+		PushDecodedRequest(request);
+	}
+
+	void ResourceManager::RunDecodeStage(LoadRequest* request)
+	{
+		if (request->cancelled)
+			request->skipped = true;
+		else
+		{
+			request->decoded = true;
+			request->decodeSucceeded = request->resource->Decode(request->fileData);
+		}
+
+		request->fileData.clear();
+		request->fileData.shrink_to_fit();
+
+		PushDecodedRequest(request);
+	}
+
+	void ResourceManager::PushDecodedRequest(LoadRequest* request)
+	{
+		request->resource->SetLoadState(ResourceLoadState::Finalizing);
+
+		std::lock_guard lock(mDecodedMutex);
+
+		mDecodedRequests.push_back(request);
+		request->stagesDone.store(true, std::memory_order_release);
+	}
+
+	void ResourceManager::FinalizeRequest(LoadRequest* request)
+	{
+		Resource* resource = request->resource;
+
+		const auto it = mLoadRequests.find(resource->GetID());
+		assert(it != mLoadRequests.end() && it->second.get() == request && "ResourceManager::FinalizeRequest - Request is not in flight");
+
+		std::unique_ptr<LoadRequest> ownedRequest = std::move(it->second);
+		mLoadRequests.erase(it);
+
+		const bool cancelled = request->cancelled;
+
+		// Request was cancelled then requested again after a stage had already skipped its work, load it again
+		if (!cancelled && request->skipped)
+		{
+			if (request->decoded)
+				resource->Release();
+
+			auto restartedRequest = std::make_unique<LoadRequest>();
+			restartedRequest->resource = resource;
+			restartedRequest->priority = request->priority;
+			restartedRequest->callbacks = std::move(request->callbacks);
+
+			mRetiredRequests.push_back(std::move(ownedRequest));
+
+			StartRequest(std::move(restartedRequest));
+			return;
+		}
+
+		bool loaded = false;
+
+		if (cancelled)
+		{
+			if (request->decoded)
+				resource->Release();
+
+			resource->SetLoadState(ResourceLoadState::Unloaded);
+		}
+		else if (request->decodeSucceeded && resource->Finalize())
+		{
+			resource->SetLoadState(ResourceLoadState::Loaded);
+			loaded = true;
+		}
+		else
+		{
+			if (request->decoded)
+				resource->Release();
+
+			resource->SetLoadState(ResourceLoadState::Failed);
+
+			std::cout << "ResourceManager::FinalizeRequest - Failed to load " << resource->GetPath().string() << std::endl;
+		}
+
+		auto callbacks = std::move(request->callbacks);
+
+		mRetiredRequests.push_back(std::move(ownedRequest));
+
+		// Called last, as callbacks are free to request loads again
+		for (auto& callback : callbacks)
+		{
+			callback(resource, loaded);
+		}
+	}
+
+	void ResourceManager::WaitForRequest(LoadRequest* request)
+	{
+		// Once file has been read, wait on decode task so calling thread runs it if no worker has picked it up,
+		// waiting returns straight away if task hasn't been added yet, in which case it is tried again
+		while (!request->stagesDone.load(std::memory_order_acquire))
+		{
+			if (request->decodeQueued.load(std::memory_order_acquire))
+				mTaskScheduler->WaitforTask(request->decodeTask.get());
+			else
+				std::this_thread::yield();
+		}
+
+		{
+			std::lock_guard lock(mDecodedMutex);
+
+			mDecodedRequests.erase(std::remove(mDecodedRequests.begin(), mDecodedRequests.end(), request), mDecodedRequests.end());
+		}
+
+		FinalizeRequest(request);
+	}
+
+	void ResourceManager::StartRequest(std::unique_ptr<LoadRequest> request)
+	{
+		LoadRequest* requestPtr = request.get();
+		Resource* resource = request->resource;
+
+		resource->SetLoadState(ResourceLoadState::Queued);
+
+		mLoadRequests.emplace(resource->GetID(), std::move(request));
+
+		if (!mTaskScheduler)
+		{
+			requestPtr->read = ReadResourceFile(resource->GetID(), requestPtr->fileData);
+
+			if (requestPtr->read)
+			{
+				resource->SetLoadState(ResourceLoadState::Decoding);
+
+				RunDecodeStage(requestPtr);
+			}
+			else
+			{
+				PushDecodedRequest(requestPtr);
+			}
+
+			return;
+		}
+
+		const enki::TaskPriority taskPriority = GetTaskPriority(requestPtr->priority);
+
+		requestPtr->ioTask = std::make_unique<IOTask>(this, mIOThreadNum);
+		requestPtr->ioTask->m_Priority = taskPriority;
+
+		requestPtr->decodeTask = std::make_unique<enki::TaskSet>(1, [this, requestPtr](enki::TaskSetPartition range, uint32_t threadIdx)
+		{
+			RunDecodeStage(requestPtr);
+		});
+		requestPtr->decodeTask->m_Priority = taskPriority;
+
+		{
+			std::lock_guard lock(mIOMutex);
+
+			mIOQueues[static_cast<size_t>(requestPtr->priority)].push_back(requestPtr);
+		}
+
+		// Each pinned task reads whichever request has highest priority when it runs, not necessarily its own
+		mTaskScheduler->AddPinnedTask(requestPtr->ioTask.get());
+	}
+
+	bool ResourceManager::LoadResourceImmediate(Resource* resource)
+	{
+		std::vector<uint8_t> fileData;
+
+		if (!ReadResourceFile(resource->GetID(), fileData))
+		{
+			resource->SetLoadState(ResourceLoadState::Failed);
+
+			std::cout << "ResourceManager::LoadResource - Failed to read " << resource->GetPath().string() << std::endl;
+			return false;
+		}
+
+		resource->SetLoadState(ResourceLoadState::Decoding);
+
+		if (!resource->Decode(fileData) || !resource->Finalize())
+		{
+			resource->Release();
+			resource->SetLoadState(ResourceLoadState::Failed);
+
+			std::cout << "ResourceManager::LoadResource - Failed to load " << resource->GetPath().string() << std::endl;
+			return false;
+		}
+
+		resource->SetLoadState(ResourceLoadState::Loaded);
+
+		return true;
+	}
+
 	fs::path ResourceManager::FindEngineRoot(const fs::path& currentPath)
 	{
 		bool cmakeListsInDir = false;
@@ -1,12 +1,40 @@
 ﻿#pragma once
 
+#include <array>
+#include <cassert>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <type_traits>
+#include <typeindex>
 #include <unordered_set>
+#include <vector>
 
 #include "project_settings.h"
+#include "resource/resource_handle.h"
+#include "resource/resource_id.h"
+#include "resource/resource_registry.h"
+
+namespace enki
+{
+	class TaskScheduler;
+}
 
 namespace puffin
 {
-	class Resource;
+	class ResourcePack;
+	struct ResourcePackEntry;
+
+	enum class ResourceLoadPriority : uint8_t
+	{
+		High,
+		Normal,
+		Low
+	};
+
+	// Called on main thread once an async load has finished, loaded is false if load failed or was cancelled
+	using ResourceLoadCallback = std::function<void(Resource* resource, bool loaded)>;
 
 	/*
 	 * Manages the lifetime of any resources created by it and ensures
@@ -21,26 +49,218 @@ namespace puffin
 
 		void Initialize(const io::ProjectFile& projectFile, const fs::path& projectPath);
 
-		Resource* GetResource(fs::path resourcePath);
+		// Register path & add resource of type T for it, see AddResource by id, nullptr if path's id collides with another path
+		template<typename T>
+		T* AddResource(const fs::path& resourcePath)
+		{
+			const ResourceID id = mRegistry.Register(resourcePath);
+
+			if (id == gInvalidResourceID)
+				return nullptr;
+
+			return AddResource<T>(id);
+		}
+
+		// Add resource of type T for registered id, resource starts unloaded, existing resource is returned if id already has one
+		template<typename T>
+		T* AddResource(ResourceID id)
+		{
+			static_assert(std::is_base_of_v<Resource, T>, "ResourceManager::AddResource - T must derive from Resource");
+
+			assert(mRegistry.IsRegistered(id) && "ResourceManager::AddResource - Resource id is not registered");
+
+			if (const auto it = mResources.find(id); it != mResources.end())
+				return dynamic_cast<T*>(it->second.get());
+
+			auto resource = std::make_unique<T>(mRegistry.GetFilePath(id));
+			T* resourcePtr = resource.get();
+
+			static_cast<Resource*>(resourcePtr)->mID = id;
+			static_cast<Resource*>(resourcePtr)->mResourceManager = this;
+
+			mResources.emplace(id, std::move(resource));
+
+			return resourcePtr;
+		}
+
+		// Get handle to resource of type T, adding resource if it doesn't exist yet, resource is not loaded
+		template<typename T>
+		ResourceHandle<T> AcquireResource(const fs::path& resourcePath)
+		{
+			return ResourceHandle<T>(AddResource<T>(resourcePath));
+		}
+
+		template<typename T>
+		ResourceHandle<T> AcquireResource(ResourceID id)
+		{
+			return ResourceHandle<T>(AddResource<T>(id));
+		}
+
+		// Intern path into id, done once when a resource is imported rather than on every lookup
+		ResourceID RegisterResourcePath(const fs::path& resourcePath);
+
+		// Id path has, without registering it
+		[[nodiscard]] ResourceID GetResourceID(const fs::path& resourcePath) const;
+
+		// Registry of every path interned so far, for tools which need to map ids back to paths
+		[[nodiscard]] const ResourceRegistry& GetRegistry() const;
+
+		/*
+		 * Raw pointers stay valid while resource is loaded. Resources which have never been acquired through a handle
+		 * are never evicted, once a resource has been acquired anyone using it must hold a handle to it
+		 */
+		Resource* GetResource(ResourceID id);
+
+		// Load resource on calling thread, waits for any async load of it already in flight, see GetResource
+		Resource* LoadResource(ResourceID id);
+
+		/*
+		 * Queue resource to be read on I/O thread & decoded on a worker, callback is called from Update once it has
+		 * been finalized, or on next update if resource is already loaded. Requests for a resource already in flight
+		 * share its load, returns false if no resource exists for id
+		 */
+		bool LoadResourceAsync(ResourceID id, ResourceLoadPriority priority = ResourceLoadPriority::Normal,
+			ResourceLoadCallback callback = nullptr);
+
+		// Cancel async load of resource, callbacks waiting on it are called with loaded set to false
+		void CancelLoad(ResourceID id);
+
+		void UnloadResource(ResourceID id);
+
+		// Cancel any load in flight & release resource on next update
+		void UnloadResourceAsync(ResourceID id);
+
+		[[nodiscard]] bool IsLoaded(ResourceID id) const;
+		[[nodiscard]] ResourceLoadState GetLoadState(ResourceID id) const;
+
+		/*
+		 * Async loading runs file reads as pinned tasks on ioThreadNum & decoding on other scheduler threads, without
+		 * a task scheduler async loads are done in full on request & only callbacks are deferred to update
+		 */
+		void StartAsyncLoading(enki::TaskScheduler* taskScheduler, uint32_t ioThreadNum);
 
-		Resource* LoadResource(fs::path resourcePath);
-		void LoadResourceAsync(fs::path resourcePath);
+		// Cancel & wait for any loads in flight, called before task scheduler is shut down
+		void StopAsyncLoading();
 
-		void UnloadResource(fs::path resourcePath);
-		void UnloadResourceAsync(fs::path resourcePath);
+		// Finalize decoded resources & call their load callbacks, called once per frame on main thread
+		void Update();
+
+		/*
+		 * Budget in bytes for memory held by loaded resources, 0 for no budget. While over budget, loaded resources
+		 * which were acquired through handles but no handle references any more are unloaded on update, least recently used first
+		 */
+		void SetMemoryBudget(size_t memoryBudget);
+		[[nodiscard]] size_t GetMemoryBudget() const;
+
+		// Memory held by loaded resources, as reported by each resource when it loaded
+		[[nodiscard]] size_t GetMemoryUsage() const;
+		[[nodiscard]] size_t GetTypeMemoryUsage(std::type_index type) const;
+
+		template<typename T>
+		[[nodiscard]] size_t GetTypeMemoryUsage() const
+		{
+			return GetTypeMemoryUsage(std::type_index(typeid(T)));
+		}
+
+		/*
+		 * Mount pack file, resource files it holds are read from pack rather than from disk,
+		 * packs mounted later take priority over those mounted before them
+		 */
+		bool MountPack(const fs::path& packPath);
+		void UnmountPack(const fs::path& packPath);
+
+		// Read contents of a resource file, from last mounted pack holding it, or from disk if no pack holds it
+		bool ReadResourceFile(ResourceID id, std::vector<uint8_t>& data) const;
+		bool ReadResourceFile(const fs::path& resourcePath, std::vector<uint8_t>& data) const;
+
+		/*
+		 * Read contents of many resource files at once, pack entries are decompressed on task scheduler workers when one
+		 * is provided, returns false if any file could not be read
+		 */
+		bool ReadResourceFiles(const std::vector<fs::path>& resourcePaths, std::vector<std::vector<uint8_t>>& data,
+			enki::TaskScheduler* taskScheduler = nullptr) const;
 
 		fs::path GetProjectPath() const;
 		fs::path GetEnginePath() const;
 
 	private:
 
+		friend class Resource;
+
+		struct LoadRequest;
+		struct IOTask;
+
+		// Called by resources as they change load state or gain/lose their first/last handle
+		void OnResourceLoaded(Resource* resource);
+		void OnResourceUnloaded(Resource* resource);
+		void OnResourceReferenced(Resource* resource);
+		void OnResourceUnreferenced(Resource* resource);
+
+		void AddUnreferencedResource(Resource* resource);
+		void RemoveUnreferencedResource(Resource* resource);
+
+		// Unload unreferenced resources until memory usage is within budget
+		void EvictUnreferencedResources();
+
+		// Pop highest priority request & read its file, run as pinned task on I/O thread
+		void RunIOStage();
+
+		// Run on worker once file has been read
+		void RunDecodeStage(LoadRequest* request);
+
+		// Hand request to main thread for finalization
+		void PushDecodedRequest(LoadRequest* request);
+
+		// Finalize request on main thread & call its callbacks, request is retired once its tasks are complete
+		void FinalizeRequest(LoadRequest* request);
+
+		// Block until request has been through its I/O & decode stages, then finalize it
+		void WaitForRequest(LoadRequest* request);
+
+		void StartRequest(std::unique_ptr<LoadRequest> request);
+
+		// Read, decode & finalize resource on calling thread
+		bool LoadResourceImmediate(Resource* resource);
+
 		static fs::path FindEngineRoot(const fs::path& currentPath);
 
+		// Pack holding id which was mounted last, nullptr if no pack holds it
+		const ResourcePack* FindPack(ResourceID id, const ResourcePackEntry*& entry) const;
+
+		// Read resource file straight from disk, paths are relative to project
+		bool ReadLooseFile(const fs::path& resourcePath, std::vector<uint8_t>& data) const;
+
 		std::string mProjectName;
 		fs::path mProjectPath;
 		fs::path mEnginePath;
 
-		std::unordered_map<fs::path, std::unique_ptr<Resource>> mResources;
+		ResourceRegistry mRegistry;
+
+		std::unordered_map<ResourceID, std::unique_ptr<Resource>> mResources;
+
+		std::vector<std::unique_ptr<ResourcePack>> mPacks; // Mounted packs, in mount order
+
+		enki::TaskScheduler* mTaskScheduler = nullptr;
+		uint32_t mIOThreadNum = 0;
+
+		std::unordered_map<ResourceID, std::unique_ptr<LoadRequest>> mLoadRequests; // Requests in flight
+		std::vector<std::unique_ptr<LoadRequest>> mRetiredRequests; // Finalized, waiting for their tasks to complete
+
+		std::mutex mIOMutex;
+		std::array<std::deque<LoadRequest*>, 3> mIOQueues; // Per priority, waiting to be read
+
+		std::mutex mDecodedMutex;
+		std::vector<LoadRequest*> mDecodedRequests; // Waiting to be finalized on main thread
+
+		std::vector<std::pair<Resource*, ResourceLoadCallback>> mPendingCallbacks; // For resources already loaded when requested
+		std::vector<ResourceID> mPendingUnloads;
+
+		size_t mMemoryBudget = 0;
+		size_t mMemoryUsage = 0;
+		std::unordered_map<std::type_index, size_t> mTypeMemoryUsage;
+
+		std::list<Resource*> mUnreferencedResources; // Loaded & without handles, least recently used first
+		std::unordered_map<Resource*, std::list<Resource*>::iterator> mUnreferencedPositions;
 
 	};
 }
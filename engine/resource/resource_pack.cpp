@@ -0,0 +1,378 @@
+﻿#include "resource/resource_pack.h"
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+
+#include "lz4.h"
+#include "TaskScheduler.h"
+
+namespace puffin
+{
+	namespace
+	{
+		// Whether range lies inside a file of fileSize bytes
+		bool IsRangeInFile(uint64_t offset, uint64_t size, uint64_t fileSize)
+		{
+			return offset <= fileSize && size <= fileSize - offset;
+		}
+	}
+
+	uint64_t HashResourcePath(const fs::path& path)
+	{
+		// FNV-1a, path is only lowercased where file system is case insensitive, elsewhere paths which only
+		// differ by case are different files & must get different ids
+		constexpr uint64_t fnvOffsetBasis = 14695981039346656037ull;
+		constexpr uint64_t fnvPrime = 1099511628211ull;
+
+		uint64_t hash = fnvOffsetBasis;
+
+		for (const char c : path.lexically_normal().generic_string())
+		{
+#ifdef _WIN32
+			const char folded = c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+#else
+			const char folded = c;
+#endif
+
+			hash ^= static_cast<uint8_t>(folded);
+			hash *= fnvPrime;
+		}
+
+		return hash;
+	}
+
+	ResourcePack::ResourcePack(const fs::path& path)
+	{
+		Open(path);
+	}
+
+	bool ResourcePack::Open(const fs::path& path)
+	{
+		Close();
+
+		if (!mFile.Open(path))
+			return false;
+
+		const uint64_t fileSize = mFile.Size();
+
+		if (fileSize < sizeof(ResourcePackHeader))
+		{
+			Close();
+			return false;
+		}
+
+		const auto& header = *reinterpret_cast<const ResourcePackHeader*>(mFile.Data());
+
+		if (header.magic != gResourcePackMagic || header.version != gResourcePackVersion || header.fileSize != fileSize
+			|| header.entryCount > fileSize / sizeof(ResourcePackEntry)
+			|| !IsRangeInFile(header.tocOffset, header.entryCount * sizeof(ResourcePackEntry), fileSize)
+			|| !IsRangeInFile(header.pathsOffset, header.pathsSize, fileSize))
+		{
+			std::cout << "ResourcePack::Open - Unsupported or truncated pack file: " << path.string() << std::endl;
+
+			Close();
+			return false;
+		}
+
+		mPath = path;
+
+		mEntries = reinterpret_cast<const ResourcePackEntry*>(mFile.Data() + header.tocOffset);
+		mEntryCount = static_cast<size_t>(header.entryCount);
+
+		mPaths = reinterpret_cast<const char*>(mFile.Data() + header.pathsOffset);
+		mPathsSize = header.pathsSize;
+
+		return true;
+	}
+
+	void ResourcePack::Close()
+	{
+		mFile.Close();
+
+		mPath.clear();
+
+		mEntries = nullptr;
+		mEntryCount = 0;
+
+		mPaths = nullptr;
+		mPathsSize = 0;
+	}
+
+	bool ResourcePack::IsOpen() const
+	{
+		return mFile.IsOpen();
+	}
+
+	const fs::path& ResourcePack::GetPath() const
+	{
+		return mPath;
+	}
+
+	const ResourcePackEntry* ResourcePack::FindEntry(uint64_t id) const
+	{
+		const auto* end = mEntries + mEntryCount;
+
+		const auto* entry = std::lower_bound(mEntries, end, id, [](const ResourcePackEntry& lhs, uint64_t rhs)
+		{
+			return lhs.id < rhs;
+		});
+
+		if (entry != end && entry->id == id)
+			return entry;
+
+		return nullptr;
+	}
+
+	const ResourcePackEntry* ResourcePack::GetEntries() const
+	{
+		return mEntries;
+	}
+
+	size_t ResourcePack::GetEntryCount() const
+	{
+		return mEntryCount;
+	}
+
+	std::string_view ResourcePack::GetEntryPath(const ResourcePackEntry& entry) const
+	{
+		if (!IsRangeInFile(entry.pathOffset, entry.pathSize, mPathsSize))
+			return {};
+
+		return { mPaths + entry.pathOffset, entry.pathSize };
+	}
+
+	bool ResourcePack::Read(const ResourcePackEntry& entry, std::vector<uint8_t>& data) const
+	{
+		data.clear();
+
+		if (!mFile.IsOpen() || !IsRangeInFile(entry.offset, entry.storedSize, mFile.Size()))
+			return false;
+
+		const auto* stored = reinterpret_cast<const char*>(mFile.Data() + entry.offset);
+
+		if ((entry.flags & gResourcePackEntryFlagCompressed) == 0)
+		{
+			if (entry.size != entry.storedSize)
+				return false;
+
+			data.assign(stored, stored + entry.storedSize);
+
+			return true;
+		}
+
+		// LZ4 blocks are limited to sizes which fit in an int
+		if (entry.size > LZ4_MAX_INPUT_SIZE || entry.storedSize > INT_MAX)
+			return false;
+
+		data.resize(static_cast<size_t>(entry.size));
+
+		const int decompressedSize = LZ4_decompress_safe(stored, reinterpret_cast<char*>(data.data()),
+			static_cast<int>(entry.storedSize), static_cast<int>(entry.size));
+
+		if (decompressedSize < 0 || static_cast<uint64_t>(decompressedSize) != entry.size)
+		{
+			data.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	void ResourcePackWriter::AddFile(const fs::path& filePath, const fs::path& rootPath)
+	{
+		const auto relativePath = filePath.lexically_relative(rootPath);
+
+		PendingEntry entry;
+		entry.id = HashResourcePath(relativePath);
+		entry.path = relativePath.lexically_normal().generic_string();
+		entry.filePath = filePath;
+
+		mEntries.push_back(std::move(entry));
+	}
+
+	void ResourcePackWriter::AddData(uint64_t id, std::string path, std::vector<uint8_t> data)
+	{
+		PendingEntry entry;
+		entry.id = id;
+		entry.path = std::move(path);
+		entry.data = std::move(data);
+
+		mEntries.push_back(std::move(entry));
+	}
+
+	bool ResourcePackWriter::Write(const fs::path& packPath, enki::TaskScheduler* taskScheduler)
+	{
+		if (taskScheduler && mEntries.size() > 1)
+		{
+			enki::TaskSet task(static_cast<uint32_t>(mEntries.size()), [&](enki::TaskSetPartition range, uint32_t threadIdx)
+			{
+				for (uint32_t idx = range.start; idx < range.end; ++idx)
+				{
+					PrepareEntry(mEntries[idx]);
+				}
+			});
+
+			taskScheduler->AddTaskSetToPipe(&task);
+			taskScheduler->WaitforTask(&task);
+		}
+		else
+		{
+			for (auto& entry : mEntries)
+			{
+				PrepareEntry(entry);
+			}
+		}
+
+		for (const auto& entry : mEntries)
+		{
+			if (!entry.valid)
+			{
+				std::cout << "ResourcePackWriter::Write - Failed to read " << entry.filePath.string() << std::endl;
+				return false;
+			}
+		}
+
+		std::sort(mEntries.begin(), mEntries.end(), [](const PendingEntry& lhs, const PendingEntry& rhs)
+		{
+			return lhs.id < rhs.id;
+		});
+
+		const auto duplicateIt = std::adjacent_find(mEntries.begin(), mEntries.end(), [](const PendingEntry& lhs, const PendingEntry& rhs)
+		{
+			return lhs.id == rhs.id;
+		});
+
+		if (duplicateIt != mEntries.end())
+		{
+			std::cout << "ResourcePackWriter::Write - " << duplicateIt->path << " and " << (duplicateIt + 1)->path << " have the same id" << std::endl;
+			return false;
+		}
+
+		if (packPath.has_parent_path())
+		{
+			std::error_code error;
+			fs::create_directories(packPath.parent_path(), error);
+		}
+
+		std::ofstream os(packPath, std::ios::out | std::ios::binary | std::ios::trunc);
+
+		if (!os.is_open())
+		{
+			std::cout << "ResourcePackWriter::Write - Failed to open " << packPath.string() << " for writing" << std::endl;
+			return false;
+		}
+
+		// Header is rewritten once location of each table is known
+		ResourcePackHeader header;
+		header.entryCount = mEntries.size();
+
+		os.write(reinterpret_cast<const char*>(&header), sizeof(ResourcePackHeader));
+
+		uint64_t offset = sizeof(ResourcePackHeader);
+
+		const std::vector<char> padding(gResourcePackAlignment, 0);
+
+		auto align = [&](uint64_t alignment)
+		{
+			const uint64_t alignedOffset = (offset + alignment - 1) & ~(alignment - 1);
+
+			os.write(padding.data(), static_cast<std::streamsize>(alignedOffset - offset));
+			offset = alignedOffset;
+		};
+
+		std::vector<ResourcePackEntry> toc;
+		toc.reserve(mEntries.size());
+
+		std::string paths;
+
+		for (const auto& entry : mEntries)
+		{
+			align(gResourcePackAlignment);
+
+			ResourcePackEntry& tocEntry = toc.emplace_back();
+			tocEntry.id = entry.id;
+			tocEntry.offset = offset;
+			tocEntry.storedSize = entry.data.size();
+			tocEntry.size = entry.size;
+			tocEntry.pathOffset = paths.size();
+			tocEntry.pathSize = static_cast<uint32_t>(entry.path.size());
+			tocEntry.flags = entry.flags;
+
+			paths += entry.path;
+
+			os.write(reinterpret_cast<const char*>(entry.data.data()), static_cast<std::streamsize>(entry.data.size()));
+			offset += entry.data.size();
+		}
+
+		align(alignof(ResourcePackEntry));
+
+		header.tocOffset = offset;
+
+		os.write(reinterpret_cast<const char*>(toc.data()), static_cast<std::streamsize>(toc.size() * sizeof(ResourcePackEntry)));
+		offset += toc.size() * sizeof(ResourcePackEntry);
+
+		header.pathsOffset = offset;
+		header.pathsSize = paths.size();
+
+		os.write(paths.data(), static_cast<std::streamsize>(paths.size()));
+		offset += paths.size();
+
+		header.fileSize = offset;
+
+		os.seekp(0);
+		os.write(reinterpret_cast<const char*>(&header), sizeof(ResourcePackHeader));
+
+		return os.good();
+	}
+
+	void ResourcePackWriter::Clear()
+	{
+		mEntries.clear();
+	}
+
+	void ResourcePackWriter::PrepareEntry(PendingEntry& entry)
+	{
+		if (!entry.filePath.empty())
+		{
+			std::ifstream is(entry.filePath, std::ios::in | std::ios::binary | std::ios::ate);
+
+			if (!is.is_open())
+				return;
+
+			entry.data.resize(static_cast<size_t>(is.tellg()));
+
+			is.seekg(0);
+			is.read(reinterpret_cast<char*>(entry.data.data()), static_cast<std::streamsize>(entry.data.size()));
+
+			if (!is)
+				return;
+		}
+
+		entry.size = entry.data.size();
+		entry.flags = 0;
+
+		// Entries which don't get smaller are stored as is, so they are a plain copy to read
+		if (!entry.data.empty() && entry.data.size() <= LZ4_MAX_INPUT_SIZE)
+		{
+			const int srcSize = static_cast<int>(entry.data.size());
+
+			std::vector<uint8_t> compressed(static_cast<size_t>(LZ4_compressBound(srcSize)));
+
+			const int compressedSize = LZ4_compress_default(reinterpret_cast<const char*>(entry.data.data()),
+				reinterpret_cast<char*>(compressed.data()), srcSize, static_cast<int>(compressed.size()));
+
+			if (compressedSize > 0 && static_cast<size_t>(compressedSize) < entry.data.size())
+			{
+				compressed.resize(static_cast<size_t>(compressedSize));
+
+				entry.data = std::move(compressed);
+				entry.flags |= gResourcePackEntryFlagCompressed;
+			}
+		}
+
+		entry.valid = true;
+	}
+}
@@ -0,0 +1,141 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utility/mapped_file.h"
+
+namespace fs = std::filesystem;
+
+namespace enki
+{
+	class TaskScheduler;
+}
+
+namespace puffin
+{
+	/*
+	 * Layout of pack files (.ppak), which bundle many resource files together so they are read through one memory
+	 * mapping rather than opened one at a time
+	 *
+	 * File starts with a header, followed by entry data with each entry aligned to gResourcePackAlignment, then a
+	 * table of contents sorted by id so entries are found with a binary search, then entry paths which are only
+	 * kept for tools. Each entry is compressed as a single LZ4 block, or stored as is when that doesn't make it smaller
+	 */
+	constexpr uint32_t gResourcePackMagic = 0x4B415050; // "PPAK"
+	constexpr uint32_t gResourcePackVersion = 1;
+	constexpr uint64_t gResourcePackAlignment = 4096;
+
+	constexpr uint32_t gResourcePackEntryFlagCompressed = 1 << 0;
+
+	struct ResourcePackHeader
+	{
+		uint32_t magic = gResourcePackMagic;
+		uint32_t version = gResourcePackVersion;
+		uint64_t fileSize = 0;
+		uint64_t entryCount = 0;
+		uint64_t tocOffset = 0; // ResourcePackEntry per entry, sorted by id
+		uint64_t pathsOffset = 0; // Path of each entry, entries refer to a range of this table
+		uint64_t pathsSize = 0;
+	};
+
+	struct ResourcePackEntry
+	{
+		uint64_t id = 0; // Resource UUID, or hash of resource path
+		uint64_t offset = 0;
+		uint64_t storedSize = 0; // Size of entry in file
+		uint64_t size = 0; // Size of entry once decompressed
+		uint64_t pathOffset = 0;
+		uint32_t pathSize = 0;
+		uint32_t flags = 0;
+	};
+
+	/*
+	 * Hash resource path to id of its pack entry, path is normalized first so each spelling of a path gets the same id.
+	 * Case is only ignored on platforms with case insensitive file systems, so packs are built on platform they ship for
+	 */
+	uint64_t HashResourcePath(const fs::path& path);
+
+	/*
+	 * Read only view of a pack file, file stays mapped while pack is open & entries are decompressed straight from
+	 * mapping, so entries can be read from multiple threads at once
+	 */
+	class ResourcePack
+	{
+	public:
+
+		ResourcePack() = default;
+		explicit ResourcePack(const fs::path& path);
+
+		// Map pack file, returns false if file could not be mapped or isn't a valid pack
+		bool Open(const fs::path& path);
+		void Close();
+
+		[[nodiscard]] bool IsOpen() const;
+		[[nodiscard]] const fs::path& GetPath() const;
+
+		// Entry with id, or nullptr if pack doesn't hold one
+		[[nodiscard]] const ResourcePackEntry* FindEntry(uint64_t id) const;
+
+		[[nodiscard]] const ResourcePackEntry* GetEntries() const;
+		[[nodiscard]] size_t GetEntryCount() const;
+		[[nodiscard]] std::string_view GetEntryPath(const ResourcePackEntry& entry) const;
+
+		// Decompress entry into data, returns false if entry lies outside of file or can't be decompressed
+		bool Read(const ResourcePackEntry& entry, std::vector<uint8_t>& data) const;
+
+	private:
+
+		fs::path mPath;
+		utility::MappedFile mFile;
+
+		const ResourcePackEntry* mEntries = nullptr;
+		size_t mEntryCount = 0;
+
+		const char* mPaths = nullptr;
+		uint64_t mPathsSize = 0;
+
+	};
+
+	/*
+	 * Builds a pack file, files are read & compressed on task scheduler workers when one is provided, then written
+	 * out in id order
+	 */
+	class ResourcePackWriter
+	{
+	public:
+
+		// Add file from disk, stored under id of its path relative to rootPath
+		void AddFile(const fs::path& filePath, const fs::path& rootPath);
+
+		// Add data under an explicit id, path is only stored for tools
+		void AddData(uint64_t id, std::string path, std::vector<uint8_t> data);
+
+		// Write pack, returns false if a file couldn't be read or pack couldn't be written
+		bool Write(const fs::path& packPath, enki::TaskScheduler* taskScheduler = nullptr);
+
+		void Clear();
+
+	private:
+
+		struct PendingEntry
+		{
+			uint64_t id = 0;
+			std::string path;
+			fs::path filePath; // Read when pack is written, empty if data was added directly
+			std::vector<uint8_t> data;
+			uint32_t flags = 0;
+			uint64_t size = 0;
+			bool valid = false;
+		};
+
+		// Read & compress entry, data is replaced with what is stored in file
+		static void PrepareEntry(PendingEntry& entry);
+
+		std::vector<PendingEntry> mEntries;
+
+	};
+}
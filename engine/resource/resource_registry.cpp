@@ -0,0 +1,149 @@
+﻿#include "resource/resource_registry.h"
+
+#include <cassert>
+#include <cctype>
+#include <iostream>
+#include <mutex>
+
+#include "resource/resource_pack.h"
+
+namespace puffin
+{
+	void ResourceRegistry::SetRootPath(const fs::path& rootPath)
+	{
+		std::unique_lock lock(mMutex);
+
+		assert(mPaths.empty() && "ResourceRegistry::SetRootPath - Root path cannot change once paths are registered");
+
+		mRootPath = rootPath.lexically_normal();
+	}
+
+	const fs::path& ResourceRegistry::GetRootPath() const
+	{
+		return mRootPath;
+	}
+
+	ResourceID ResourceRegistry::Register(const fs::path& path)
+	{
+		std::string normalizedPath = NormalizePath(path);
+		const ResourceID id = HashResourcePath(normalizedPath);
+
+		assert(id != gInvalidResourceID && "ResourceRegistry::Register - Path hashed to invalid id");
+
+		{
+			std::shared_lock lock(mMutex);
+
+			if (const auto it = mIDToIdx.find(id); it != mIDToIdx.end())
+				return CheckRegisteredPath(id, mPaths[it->second], normalizedPath);
+		}
+
+		std::unique_lock lock(mMutex);
+
+		// Path may have been registered by another thread while lock was released
+		if (const auto it = mIDToIdx.find(id); it != mIDToIdx.end())
+			return CheckRegisteredPath(id, mPaths[it->second], normalizedPath);
+
+		mIDToIdx.emplace(id, static_cast<uint32_t>(mPaths.size()));
+		mPaths.push_back(std::move(normalizedPath));
+
+		return id;
+	}
+
+	ResourceID ResourceRegistry::GetID(const fs::path& path) const
+	{
+		return HashResourcePath(NormalizePath(path));
+	}
+
+	bool ResourceRegistry::IsRegistered(ResourceID id) const
+	{
+		std::shared_lock lock(mMutex);
+
+		return mIDToIdx.find(id) != mIDToIdx.end();
+	}
+
+	const std::string& ResourceRegistry::GetPath(ResourceID id) const
+	{
+		static const std::string emptyPath;
+
+		std::shared_lock lock(mMutex);
+
+		const auto it = mIDToIdx.find(id);
+
+		return it != mIDToIdx.end() ? mPaths[it->second] : emptyPath;
+	}
+
+	fs::path ResourceRegistry::GetFilePath(ResourceID id) const
+	{
+		const fs::path path = GetPath(id);
+
+		if (path.empty() || path.is_absolute())
+			return path;
+
+		return mRootPath / path;
+	}
+
+	uint32_t ResourceRegistry::Count() const
+	{
+		std::shared_lock lock(mMutex);
+
+		return static_cast<uint32_t>(mPaths.size());
+	}
+
+	void ResourceRegistry::GetIDs(std::vector<ResourceID>& ids) const
+	{
+		std::shared_lock lock(mMutex);
+
+		ids.clear();
+		ids.reserve(mIDToIdx.size());
+
+		for (const auto& [id, idx] : mIDToIdx)
+		{
+			ids.push_back(id);
+		}
+	}
+
+	void ResourceRegistry::Clear()
+	{
+		std::unique_lock lock(mMutex);
+
+		mPaths.clear();
+		mIDToIdx.clear();
+	}
+
+	ResourceID ResourceRegistry::CheckRegisteredPath(ResourceID id, const std::string& registeredPath, const std::string& path)
+	{
+		bool match = registeredPath.size() == path.size();
+
+		for (size_t idx = 0; match && idx < path.size(); ++idx)
+		{
+#ifdef _WIN32
+			// Ids ignore case here, so paths which only differ by case are the same file
+			match = std::tolower(static_cast<unsigned char>(registeredPath[idx])) == std::tolower(static_cast<unsigned char>(path[idx]));
+#else
+			match = registeredPath[idx] == path[idx];
+#endif
+		}
+
+		if (match)
+			return id;
+
+		std::cout << "ResourceRegistry::Register - " << path << " has the same id as " << registeredPath << ", it will not be registered" << std::endl;
+
+		assert(false && "ResourceRegistry::Register - Path id collides with a different registered path");
+
+		return gInvalidResourceID;
+	}
+
+	std::string ResourceRegistry::NormalizePath(const fs::path& path) const
+	{
+		if (path.is_absolute() && !mRootPath.empty())
+		{
+			const auto relativePath = path.lexically_relative(mRootPath);
+
+			if (!relativePath.empty() && *relativePath.begin() != "..")
+				return relativePath.lexically_normal().generic_string();
+		}
+
+		return path.lexically_normal().generic_string();
+	}
+}
@@ -0,0 +1,67 @@
+﻿#pragma once
+
+#include <deque>
+#include <filesystem>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "resource/resource_id.h"
+
+namespace fs = std::filesystem;
+
+namespace puffin
+{
+	/*
+	 * Interns resource paths into resource ids, paths are registered once as resources are added or packs are
+	 * mounted so runtime lookups only deal in ids. Paths are kept in a compact table for tools & loose file reads
+	 *
+	 * Paths inside root path are stored relative to it, so ids don't depend on where project is on disk.
+	 * Safe to register & resolve from multiple threads
+	 */
+	class ResourceRegistry
+	{
+	public:
+
+		void SetRootPath(const fs::path& rootPath);
+		[[nodiscard]] const fs::path& GetRootPath() const;
+
+		/*
+		 * Get id of path, adding it to registry if it isn't already registered. Returns gInvalidResourceID if a
+		 * different path is already registered under same id, rather than letting both paths share one resource
+		 */
+		ResourceID Register(const fs::path& path);
+
+		// Id path has, whether or not it is registered
+		[[nodiscard]] ResourceID GetID(const fs::path& path) const;
+
+		[[nodiscard]] bool IsRegistered(ResourceID id) const;
+
+		// Normalized path of id, empty if id isn't registered
+		[[nodiscard]] const std::string& GetPath(ResourceID id) const;
+
+		// Path id is read from on disk
+		[[nodiscard]] fs::path GetFilePath(ResourceID id) const;
+
+		[[nodiscard]] uint32_t Count() const;
+		void GetIDs(std::vector<ResourceID>& ids) const;
+
+		void Clear();
+
+	private:
+
+		// Returns id if path is the one registered under it, otherwise reports collision & returns gInvalidResourceID
+		static ResourceID CheckRegisteredPath(ResourceID id, const std::string& registeredPath, const std::string& path);
+
+		[[nodiscard]] std::string NormalizePath(const fs::path& path) const;
+
+		mutable std::shared_mutex mMutex;
+
+		fs::path mRootPath;
+
+		std::deque<std::string> mPaths; // Deque so stored paths never move as registry grows
+		std::unordered_map<ResourceID, uint32_t> mIDToIdx;
+
+	};
+}
@@ -0,0 +1,389 @@
+#include "scene/prefab.h"
+
+#include <cassert>
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+
+#include "entt/meta/resolve.hpp"
+
+#include "ecs/entt_subsystem.h"
+#include "node/node.h"
+#include "scene/scene_graph_subsystem.h"
+#include "serialization/component_serialization.h"
+
+namespace puffin::scene
+{
+	Prefab::Prefab() : mRegistry(std::make_shared<entt::registry>())
+	{
+	}
+
+	Prefab::Prefab(fs::path path) : mPath(std::move(path)), mRegistry(std::make_shared<entt::registry>())
+	{
+	}
+
+	void Prefab::Load(SceneGraphSubsystem* sceneGraph, bool forceLoad)
+	{
+		if (mHasData && !forceLoad)
+			return;
+
+		if (!fs::exists(mPath))
+			return;
+
+		std::ifstream is(mPath);
+
+		nlohmann::json prefabJson;
+		is >> prefabJson;
+
+		is.close();
+
+		Clear();
+
+		// Deserialize nodes
+		const auto& nodesJson = prefabJson.at("nodes");
+		const auto rootNodeIDs = nodesJson.at("rootNodeIDs").get<std::vector<UUID>>();
+
+		assert(rootNodeIDs.size() == 1 && "Prefab::Load - Prefab should have a single root node");
+
+		std::unordered_map<UUID, const nlohmann::json*> idToNodeJson;
+		for (const auto& nodeJson : nodesJson.at("nodes"))
+		{
+			idToNodeJson.emplace(nodeJson.at("id").get<UUID>(), &nodeJson);
+		}
+
+		// Walk nodes depth first so parents are always stored before their children
+		std::unordered_map<UUID, int32_t> idToIdx;
+		std::vector<std::pair<UUID, int32_t>> stack;
+		stack.emplace_back(rootNodeIDs[0], -1);
+
+		while (!stack.empty())
+		{
+			const auto [id, parentIdx] = stack.back();
+			stack.pop_back();
+
+			const auto& nodeJson = *idToNodeJson.at(id);
+			const std::string type = nodeJson.at("type");
+			const auto typeID = entt::resolve(entt::hs(type.c_str())).id();
+
+			StringID nameID;
+			uint32_t nameSuffix;
+			Node::SplitName(nodeJson.at("name").get<std::string>(), nameID, nameSuffix);
+
+			const int32_t idx = AddTemplateNode(typeID, nameID, nameSuffix, parentIdx,
+				nodeJson.contains("data") ? nodeJson.at("data") : nlohmann::json());
+
+			idToIdx.emplace(id, idx);
+
+			if (nodeJson.contains("childIDs"))
+			{
+				const auto childIDs = nodeJson.at("childIDs").get<std::vector<UUID>>();
+
+				// Pushed in reverse so children are instantiated in their original order
+				for (auto it = childIDs.rbegin(); it != childIDs.rend(); ++it)
+				{
+					stack.emplace_back(*it, idx);
+				}
+			}
+		}
+
+		// Deserialize components into template registry
+		const auto& componentsJson = prefabJson.at("components");
+
+		for (const auto& funcs : serialization::ComponentRegistry::Get()->GetTypeFuncs())
+		{
+			if (!componentsJson.contains(funcs.typeString))
+				continue;
+
+			for (const auto& archiveJson : componentsJson.at(funcs.typeString))
+			{
+				// Skip components of entities which aren't part of prefab hierarchy
+				const auto it = idToIdx.find(archiveJson.at("id").get<UUID>());
+				if (it == idToIdx.end())
+					continue;
+
+				funcs.deserializeToRegistry(*mRegistry, mEntities[it->second], archiveJson.at("data"));
+			}
+		}
+
+		BuildTemplateNodes(sceneGraph);
+		UpdateTypeCaches();
+
+		mHasData = true;
+	}
+
+	void Prefab::Save() const
+	{
+		// Node ids are only used to link nodes & components within file, so index based ids are used to keep saves stable
+		const auto idxToID = [](size_t idx)
+		{
+			return static_cast<UUID>(idx + 1);
+		};
+
+		nlohmann::json prefabJson;
+
+		// Serialize components
+		nlohmann::json componentsJson;
+
+		std::vector<UUID> entityIDs;
+		entityIDs.reserve(mNodes.size());
+
+		for (size_t idx = 0; idx < mNodes.size(); ++idx)
+		{
+			entityIDs.push_back(idxToID(idx));
+		}
+
+		componentsJson["entityIDs"] = entityIDs;
+
+		for (const auto& funcs : serialization::ComponentRegistry::Get()->GetTypeFuncs())
+		{
+			nlohmann::json componentJson = nlohmann::json::array();
+
+			// Entities are visited in node order rather than storage order, so saves stay stable
+			for (size_t idx = 0; idx < mEntities.size(); ++idx)
+			{
+				if (!funcs.hasComponent(*mRegistry, mEntities[idx]))
+					continue;
+
+				nlohmann::json archiveJson;
+				archiveJson["id"] = idxToID(idx);
+				archiveJson["data"] = funcs.serializeFromRegistry(*mRegistry, mEntities[idx]);
+
+				componentJson.push_back(archiveJson);
+			}
+
+			if (!componentJson.empty())
+			{
+				componentsJson[funcs.typeString] = componentJson;
+			}
+		}
+
+		prefabJson["components"] = componentsJson;
+
+		// Serialize nodes
+		std::vector<std::vector<UUID>> childIDs(mNodes.size());
+
+		for (size_t idx = 1; idx < mNodes.size(); ++idx)
+		{
+			childIDs[mNodes[idx].parentIdx].push_back(idxToID(idx));
+		}
+
+		std::vector<nlohmann::json> nodeJsons(mNodes.size());
+
+		for (size_t idx = 0; idx < mNodes.size(); ++idx)
+		{
+			const auto& prefabNode = mNodes[idx];
+			auto& nodeJson = nodeJsons[idx];
+
+			nodeJson["id"] = idxToID(idx);
+			nodeJson["name"] = Node::BuildName(prefabNode.nameID, prefabNode.nameSuffix);
+			nodeJson["type"] = entt::resolve(prefabNode.typeID).func(entt::hs("GetTypeString")).invoke({}).cast<std::string_view>();
+
+			if (!prefabNode.json.empty())
+			{
+				nodeJson["data"] = prefabNode.json;
+			}
+
+			if (!childIDs[idx].empty())
+			{
+				nodeJson["childIDs"] = childIDs[idx];
+			}
+		}
+
+		nlohmann::json nodesJson;
+		nodesJson["rootNodeIDs"] = mNodes.empty() ? std::vector<UUID>() : std::vector<UUID>{ idxToID(0) };
+		nodesJson["nodes"] = nodeJsons;
+
+		prefabJson["nodes"] = nodesJson;
+
+		// Write prefab to file
+		if (!fs::exists(mPath.parent_path()))
+		{
+			fs::create_directories(mPath.parent_path());
+		}
+
+		std::ofstream os(mPath, std::ios::out);
+
+		os << std::setw(4) << prefabJson << std::endl;
+
+		os.close();
+	}
+
+	void Prefab::UpdateFromNode(ecs::EnTTSubsystem* enttSubsystem, SceneGraphSubsystem* sceneGraph, UUID rootID)
+	{
+		Clear();
+
+		std::vector<entt::entity> srcEntities;
+		std::vector<std::pair<UUID, int32_t>> stack;
+		stack.emplace_back(rootID, -1);
+
+		while (!stack.empty())
+		{
+			const auto [id, parentIdx] = stack.back();
+			stack.pop_back();
+
+			const auto* node = sceneGraph->GetNode(id);
+
+			assert(node != nullptr && "Prefab::UpdateFromNode - Node does not exist");
+
+			nlohmann::json json;
+			node->Serialize(json);
+
+			const int32_t idx = AddTemplateNode(node->GetTypeID(), node->GetNameID(), node->GetNameSuffix(), parentIdx, std::move(json));
+
+			srcEntities.push_back(node->GetEntity());
+
+			const auto& childIDs = node->GetChildIDs();
+			for (auto it = childIDs.rbegin(); it != childIDs.rend(); ++it)
+			{
+				stack.emplace_back(*it, idx);
+			}
+		}
+
+		// Copy components of each node into template registry
+		const auto registry = enttSubsystem->GetRegistry();
+
+		for (const auto& funcs : serialization::ComponentRegistry::Get()->GetTypeFuncs())
+		{
+			funcs.copyComponents(*registry, srcEntities, *mRegistry, mEntities);
+		}
+
+		BuildTemplateNodes(sceneGraph);
+		UpdateTypeCaches();
+
+		mHasData = true;
+	}
+
+	Node* Prefab::Instantiate(ecs::EnTTSubsystem* enttSubsystem, SceneGraphSubsystem* sceneGraph, UUID parentID) const
+	{
+		assert(mHasData && "Prefab::Instantiate - Prefab has not been loaded");
+
+		if (mNodes.empty())
+			return nullptr;
+
+		sceneGraph->ReserveNodes(mNodeTypeCounts);
+
+		std::vector<UUID> ids(mNodes.size());
+		std::vector<entt::entity> entities(mNodes.size());
+
+		for (size_t idx = 0; idx < mNodes.size(); ++idx)
+		{
+			const auto& prefabNode = mNodes[idx];
+			const UUID instanceParentID = prefabNode.parentIdx >= 0 ? ids[prefabNode.parentIdx] : parentID;
+
+			Node* node = instanceParentID != gInvalidID
+				? sceneGraph->AddChildNode(prefabNode.typeID, "", gInvalidID, instanceParentID)
+				: sceneGraph->AddNode(prefabNode.typeID, "", gInvalidID);
+
+			node->SetName(prefabNode.nameID, prefabNode.nameSuffix);
+
+			// Node data is copied from template node, rather than deserialized from json per instance
+			node->CopyFrom(*mTemplateNodes[idx]);
+
+			ids[idx] = node->GetID();
+			entities[idx] = node->GetEntity();
+		}
+
+		// Components are copied one type at a time for whole instance, rather than deserialized per node
+		const auto registry = enttSubsystem->GetRegistry();
+
+		for (const auto* funcs : mComponentTypeFuncs)
+		{
+			funcs->copyComponents(*mRegistry, mEntities, *registry, entities);
+		}
+
+		return sceneGraph->GetNode(ids[0]);
+	}
+
+	void Prefab::Clear()
+	{
+		mNodes.clear();
+		mTemplateNodes.clear();
+		mRegistry->clear();
+		mEntities.clear();
+
+		mComponentTypeFuncs.clear();
+		mNodeTypeCounts.clear();
+
+		mHasData = false;
+	}
+
+	bool Prefab::HasData() const
+	{
+		return mHasData;
+	}
+
+	const std::vector<PrefabNode>& Prefab::GetNodes() const
+	{
+		return mNodes;
+	}
+
+	void Prefab::SetPath(const fs::path& path)
+	{
+		mPath = path;
+	}
+
+	const fs::path& Prefab::GetPath() const
+	{
+		return mPath;
+	}
+
+	int32_t Prefab::AddTemplateNode(uint32_t typeID, StringID nameID, uint32_t nameSuffix, int32_t parentIdx, nlohmann::json json)
+	{
+		const auto idx = static_cast<int32_t>(mNodes.size());
+
+		PrefabNode prefabNode;
+		prefabNode.typeID = typeID;
+		prefabNode.nameID = nameID;
+		prefabNode.nameSuffix = nameSuffix;
+		prefabNode.parentIdx = parentIdx;
+		prefabNode.json = std::move(json);
+
+		mNodes.push_back(std::move(prefabNode));
+		mEntities.push_back(mRegistry->create());
+
+		return idx;
+	}
+
+	void Prefab::BuildTemplateNodes(SceneGraphSubsystem* sceneGraph)
+	{
+		mTemplateNodes.clear();
+		mTemplateNodes.reserve(mNodes.size());
+
+		for (const auto& prefabNode : mNodes)
+		{
+			auto node = sceneGraph->CreateDetachedNode(prefabNode.typeID);
+
+			if (!prefabNode.json.empty())
+				node->Deserialize(prefabNode.json);
+
+			mTemplateNodes.push_back(std::move(node));
+		}
+	}
+
+	void Prefab::UpdateTypeCaches()
+	{
+		mComponentTypeFuncs.clear();
+		mNodeTypeCounts.clear();
+
+		// Only keep component types at least one template entity has, so instancing skips types prefab doesn't use
+		for (const auto& funcs : serialization::ComponentRegistry::Get()->GetTypeFuncs())
+		{
+			for (const auto entity : mEntities)
+			{
+				if (funcs.hasComponent(*mRegistry, entity))
+				{
+					mComponentTypeFuncs.push_back(&funcs);
+					break;
+				}
+			}
+		}
+
+		std::unordered_map<uint32_t, uint32_t> typeCounts;
+		for (const auto& prefabNode : mNodes)
+		{
+			++typeCounts[prefabNode.typeID];
+		}
+
+		mNodeTypeCounts.assign(typeCounts.begin(), typeCounts.end());
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "entt/entity/registry.hpp"
+#include "entt/meta/meta.hpp"
+
+#include "node/node.h"
+#include "types/uuid.h"
+#include "types/string_intern.h"
+
+namespace fs = std::filesystem;
+
+namespace puffin
+{
+	namespace ecs
+	{
+		class EnTTSubsystem;
+	}
+
+	namespace serialization
+	{
+		struct ComponentTypeFuncs;
+	}
+
+	namespace scene
+	{
+		class SceneGraphSubsystem;
+
+		/*
+		 * Template node of a prefab
+		 */
+		struct PrefabNode
+		{
+			uint32_t typeID = 0;
+			StringID nameID = gEmptyStringID;
+			uint32_t nameSuffix = gNoNameSuffix;
+			int32_t parentIdx = -1; // Index of parent in prefab, -1 for root node
+			nlohmann::json json; // Node data, already parsed so instancing only has to walk it
+		};
+
+		/*
+		 * Subtree of nodes which can be instantiated many times
+		 *
+		 * Prefab file is parsed once into a flat list of nodes (parents before children), a detached template node per node
+		 * with its data already deserialized & a template registry holding one entity per node with its components already
+		 * deserialized. Instances copy node data from template nodes & components straight from the template registry,
+		 * one call per component type
+		 *
+		 * Prefab files use the same "components"/"nodes" layout as scene files, with a single root node
+		 */
+		class Prefab
+		{
+		public:
+
+			Prefab();
+			explicit Prefab(fs::path path);
+
+			~Prefab() = default;
+
+			// Load & parse prefab file, sceneGraph creates template nodes, does nothing if prefab already has data unless forceLoad is set
+			void Load(SceneGraphSubsystem* sceneGraph, bool forceLoad = false);
+
+			// Save prefab to json file
+			void Save() const;
+
+			// Copy subtree starting at rootID from scene into prefab
+			void UpdateFromNode(ecs::EnTTSubsystem* enttSubsystem, SceneGraphSubsystem* sceneGraph, UUID rootID);
+
+			/*
+			 * Add a new instance of prefab to scene graph as a child of parentID (or as a root node if parentID is invalid),
+			 * returns root node of instance
+			 */
+			Node* Instantiate(ecs::EnTTSubsystem* enttSubsystem, SceneGraphSubsystem* sceneGraph, UUID parentID = gInvalidID) const;
+
+			void Clear();
+
+			[[nodiscard]] bool HasData() const;
+			[[nodiscard]] const std::vector<PrefabNode>& GetNodes() const;
+
+			void SetPath(const fs::path& path);
+			[[nodiscard]] const fs::path& GetPath() const;
+
+		private:
+
+			// Add node to template, returns index of node in mNodes
+			int32_t AddTemplateNode(uint32_t typeID, StringID nameID, uint32_t nameSuffix, int32_t parentIdx, nlohmann::json json);
+
+			// Create template node of each node & deserialize its data, called after template is modified
+			void BuildTemplateNodes(SceneGraphSubsystem* sceneGraph);
+
+			// Cache component types present in template & node counts per type, called after template is modified
+			void UpdateTypeCaches();
+
+			fs::path mPath;
+			bool mHasData = false;
+
+			std::vector<PrefabNode> mNodes;
+			std::vector<std::unique_ptr<Node>> mTemplateNodes; // Node data, node at each index belongs to node at same index
+
+			std::shared_ptr<entt::registry> mRegistry; // Template components, entity at each index belongs to node at same index
+			std::vector<entt::entity> mEntities;
+
+			std::vector<const serialization::ComponentTypeFuncs*> mComponentTypeFuncs; // Funcs of each component type present in template
+			std::vector<std::pair<uint32_t, uint32_t>> mNodeTypeCounts; // Number of nodes of each type, used to reserve storage before instancing
+
+		};
+	}
+}
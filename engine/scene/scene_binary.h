@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+#include "types/uuid.h"
+
+namespace puffin
+{
+	namespace scene
+	{
+		/*
+		 * Layout of binary scene files
+		 *
+		 * File starts with a header holding the location of each table, tables are aligned to gSceneBinaryAlignment so
+		 * they can be read in place from a memory mapped file. Strings, types & nodes/entities refer to each other by
+		 * index into their tables, component & node types are stored as hashed type strings
+		 */
+		constexpr uint32_t gSceneBinaryMagic = 0x4E435350; // "PSCN"
+		constexpr uint32_t gSceneBinaryVersion = 2;
+		constexpr uint32_t gSceneBinaryAlignment = 16;
+		constexpr uint32_t gSceneBinaryNoIndex = UINT32_MAX;
+
+		enum class SceneFileFormat : uint8_t
+		{
+			Json,
+			Binary
+		};
+
+		// Location of a table or blob within file
+		struct SceneBinaryRange
+		{
+			uint64_t offset = 0;
+			uint64_t size = 0; // Size in bytes
+		};
+
+		struct SceneBinaryHeader
+		{
+			uint32_t magic = gSceneBinaryMagic;
+			uint32_t version = gSceneBinaryVersion;
+			uint64_t fileSize = 0;
+
+			SceneBinaryRange sceneInfo; // Msgpack encoded scene info
+			SceneBinaryRange strings; // SceneBinaryRange per string, pointing into string data
+			SceneBinaryRange entityIDs; // UUID per entity
+			SceneBinaryRange components; // SceneBinaryComponentSection per component type
+			SceneBinaryRange nodes; // SceneBinaryNode per node, parents before children
+			SceneBinaryRange rootNodes; // Node index per root node
+			SceneBinaryRange childNodes; // Node index per child, each node refers to a contiguous range of this table
+		};
+
+		/*
+		 * All components of one type, trivially copyable components are stored as a packed array which can be
+		 * inserted straight into registry, other components as a msgpack blob per component
+		 *
+		 * Raw sections also hold a msgpack blob per component, which is only read if layout of component has changed
+		 * since file was written, so components are never lost or read as garbage when a component struct changes
+		 */
+		struct SceneBinaryComponentSection
+		{
+			uint32_t typeID = 0; // Hashed type string
+			uint32_t typeStringIdx = gSceneBinaryNoIndex;
+			uint32_t count = 0;
+			uint32_t rawSize = 0; // Size of each component when stored raw, 0 when stored as blobs
+			uint64_t rawLayoutHash = 0; // Layout hash of component when stored raw
+			SceneBinaryRange entityIndices; // uint32_t index into entity id table per component
+			SceneBinaryRange data; // Packed components, or SceneBinaryRange per component when stored as blobs
+			SceneBinaryRange fallbackData; // SceneBinaryRange per component when stored raw, empty otherwise
+		};
+
+		struct SceneBinaryNode
+		{
+			UUID id = gInvalidID;
+			uint32_t typeID = 0; // Hashed type string
+			uint32_t typeStringIdx = gSceneBinaryNoIndex;
+			uint32_t nameIdx = gSceneBinaryNoIndex;
+			uint32_t nameSuffix = 0;
+			uint32_t firstChild = 0; // Index into child node table
+			uint32_t childCount = 0;
+			SceneBinaryRange data; // Msgpack encoded node data, empty if node has no data
+		};
+
+		constexpr uint64_t AlignSceneBinaryOffset(uint64_t offset)
+		{
+			return (offset + gSceneBinaryAlignment - 1) & ~static_cast<uint64_t>(gSceneBinaryAlignment - 1);
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#include "scene/scene_graph_command_buffer.h"
+
+#include <cassert>
+
+namespace puffin::scene
+{
+	UUID SceneGraphCommandBuffer::AddNode(UUID sourceID, uint32_t typeID, const std::string& name, UUID parentID)
+	{
+		const UUID id = GenerateId();
+
+		SceneGraphCommand command;
+		command.type = SceneGraphCommandType::AddNode;
+		command.sourceID = sourceID;
+		command.id = id;
+		command.parentID = parentID;
+		command.typeID = typeID;
+		command.payloadIdx = static_cast<uint32_t>(mNames.size());
+
+		mNames.push_back(name);
+		mCommands.push_back(command);
+
+		return id;
+	}
+
+	void SceneGraphCommandBuffer::DestroyNode(UUID sourceID, UUID id)
+	{
+		SceneGraphCommand command;
+		command.type = SceneGraphCommandType::DestroyNode;
+		command.sourceID = sourceID;
+		command.id = id;
+
+		mCommands.push_back(command);
+	}
+
+	void SceneGraphCommandBuffer::Reparent(UUID sourceID, UUID id, UUID parentID)
+	{
+		SceneGraphCommand command;
+		command.type = SceneGraphCommandType::Reparent;
+		command.sourceID = sourceID;
+		command.id = id;
+		command.parentID = parentID;
+
+		mCommands.push_back(command);
+	}
+
+	void SceneGraphCommandBuffer::SetTransform2D(UUID sourceID, UUID id, const Transform2D& transform)
+	{
+		SceneGraphCommand command;
+		command.type = SceneGraphCommandType::SetTransform2D;
+		command.sourceID = sourceID;
+		command.id = id;
+		command.payloadIdx = static_cast<uint32_t>(mTransform2Ds.size());
+
+		mTransform2Ds.push_back(transform);
+		mCommands.push_back(command);
+	}
+
+	void SceneGraphCommandBuffer::SetTransform3D(UUID sourceID, UUID id, const TransformComponent3D& transform)
+	{
+		SceneGraphCommand command;
+		command.type = SceneGraphCommandType::SetTransform3D;
+		command.sourceID = sourceID;
+		command.id = id;
+		command.payloadIdx = static_cast<uint32_t>(mTransform3Ds.size());
+
+		mTransform3Ds.push_back(transform);
+		mCommands.push_back(command);
+	}
+
+	const std::vector<SceneGraphCommand>& SceneGraphCommandBuffer::GetCommands() const
+	{
+		return mCommands;
+	}
+
+	const std::string& SceneGraphCommandBuffer::GetName(uint32_t payloadIdx) const
+	{
+		assert(payloadIdx < mNames.size() && "SceneGraphCommandBuffer::GetName - Invalid payload index");
+
+		return mNames[payloadIdx];
+	}
+
+	const Transform2D& SceneGraphCommandBuffer::GetTransform2D(uint32_t payloadIdx) const
+	{
+		assert(payloadIdx < mTransform2Ds.size() && "SceneGraphCommandBuffer::GetTransform2D - Invalid payload index");
+
+		return mTransform2Ds[payloadIdx];
+	}
+
+	const TransformComponent3D& SceneGraphCommandBuffer::GetTransform3D(uint32_t payloadIdx) const
+	{
+		assert(payloadIdx < mTransform3Ds.size() && "SceneGraphCommandBuffer::GetTransform3D - Invalid payload index");
+
+		return mTransform3Ds[payloadIdx];
+	}
+
+	bool SceneGraphCommandBuffer::Empty() const
+	{
+		return mCommands.empty();
+	}
+
+	void SceneGraphCommandBuffer::Clear()
+	{
+		mCommands.clear();
+		mNames.clear();
+		mTransform2Ds.clear();
+		mTransform3Ds.clear();
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "entt/meta/resolve.hpp"
+
+#include "types/uuid.h"
+#include "types/transform2d.h"
+#include "component/transform_component_3d.h"
+
+namespace puffin
+{
+	namespace scene
+	{
+		enum class SceneGraphCommandType : uint8_t
+		{
+			AddNode,
+			DestroyNode,
+			Reparent,
+			SetTransform2D,
+			SetTransform3D
+		};
+
+		struct SceneGraphCommand
+		{
+			SceneGraphCommandType type = SceneGraphCommandType::AddNode;
+			UUID sourceID = gInvalidID; // Node which recorded command, used to apply commands in a deterministic order
+			UUID id = gInvalidID; // Node command applies to
+			UUID parentID = gInvalidID; // New parent for AddNode/Reparent commands
+			uint32_t typeID = 0; // Node type for AddNode commands
+			uint32_t payloadIdx = 0; // Index of name/transform stored for AddNode/SetTransform commands
+		};
+
+		/*
+		 * Records structural changes to the scene graph so they can be made from enkiTS worker threads,
+		 * commands are applied on the main thread the next time the scene graph is updated
+		 *
+		 * Each thread records into its own buffer, see SceneGraphSubsystem::GetCommandBuffer
+		 */
+		class SceneGraphCommandBuffer
+		{
+		public:
+
+			SceneGraphCommandBuffer() = default;
+			~SceneGraphCommandBuffer() = default;
+
+			/*
+			 * Record a node to be added, node id is returned immediately so it can be used in later commands
+			 * Node type must already be registered with the scene graph
+			 */
+			UUID AddNode(UUID sourceID, uint32_t typeID, const std::string& name, UUID parentID = gInvalidID);
+
+			template<typename T>
+			UUID AddNode(UUID sourceID, const std::string& name, UUID parentID = gInvalidID)
+			{
+				return AddNode(sourceID, entt::resolve<T>().id(), name, parentID);
+			}
+
+			void DestroyNode(UUID sourceID, UUID id);
+			void Reparent(UUID sourceID, UUID id, UUID parentID);
+			void SetTransform2D(UUID sourceID, UUID id, const Transform2D& transform);
+			void SetTransform3D(UUID sourceID, UUID id, const TransformComponent3D& transform);
+
+			[[nodiscard]] const std::vector<SceneGraphCommand>& GetCommands() const;
+			[[nodiscard]] const std::string& GetName(uint32_t payloadIdx) const;
+			[[nodiscard]] const Transform2D& GetTransform2D(uint32_t payloadIdx) const;
+			[[nodiscard]] const TransformComponent3D& GetTransform3D(uint32_t payloadIdx) const;
+
+			[[nodiscard]] bool Empty() const;
+			void Clear();
+
+		private:
+
+			std::vector<SceneGraphCommand> mCommands;
+
+			std::vector<std::string> mNames;
+			std::vector<Transform2D> mTransform2Ds;
+			std::vector<TransformComponent3D> mTransform3Ds;
+
+		};
+	}
+}
@@ -1,6 +1,9 @@
 ﻿#include "scene/scene_graph_gameplay_subsystem.h"
 
+#include <deque>
+
 #include "core/engine.h"
+#include "core/enkits_subsystem.h"
 #include "subsystem/subsystem_manager.h"
 #include "scene/scene_graph_subsystem.h"
 
@@ -15,6 +18,7 @@ namespace puffin::scene
 		GameplaySubsystem::Initialize(subsystemManager);
 
 		subsystemManager->CreateAndInitializeSubsystem<SceneGraphSubsystem>();
+		subsystemManager->CreateAndInitializeSubsystem<core::EnkiTSSubsystem>();
 	}
 
 	void SceneGraphGameplaySubsystem::BeginPlay()
@@ -41,9 +45,11 @@ namespace puffin::scene
 
 	void SceneGraphGameplaySubsystem::Update(double deltaTime)
 	{
+		UpdateNodePools(m_engine->GetDeltaTime(), false);
+
 		const auto sceneGraph = m_engine->GetSubsystem<SceneGraphSubsystem>();
 
-		for (auto& id : sceneGraph->GetNodeIDs())
+		for (auto& id : sceneGraph->GetHierarchyUpdateNodeIDs())
 		{
 			if (const auto node = sceneGraph->GetNode(id); node && node->ShouldUpdate())
 				node->Update(m_engine->GetDeltaTime());
@@ -57,9 +63,11 @@ namespace puffin::scene
 
 	void SceneGraphGameplaySubsystem::FixedUpdate(double fixedTime)
 	{
+		UpdateNodePools(m_engine->GetTimeStepFixed(), true);
+
 		const auto sceneGraph = m_engine->GetSubsystem<SceneGraphSubsystem>();
 
-		for (auto& id : sceneGraph->GetNodeIDs())
+		for (auto& id : sceneGraph->GetHierarchyUpdateNodeIDs())
 		{
 			if (const auto node = sceneGraph->GetNode(id); node && node->ShouldFixedUpdate())
 				node->FixedUpdate(m_engine->GetTimeStepFixed());
@@ -75,4 +83,66 @@ namespace puffin::scene
 	{
 		return reflection::GetTypeString<SceneGraphGameplaySubsystem>();
 	}
+
+	void SceneGraphGameplaySubsystem::UpdateNodePools(double deltaTime, bool fixedUpdate)
+	{
+		const auto sceneGraph = m_engine->GetSubsystem<SceneGraphSubsystem>();
+		const auto& nodePools = sceneGraph->GetBucketedNodePools();
+
+		if (nodePools.empty())
+			return;
+
+		const auto taskScheduler = m_engine->GetSubsystem<core::EnkiTSSubsystem>()->GetTaskScheduler();
+
+		std::deque<enki::TaskSet> tasks; // Deque so queued tasks are never moved while in flight
+
+		auto waitForTasks = [&]()
+		{
+			for (auto& task : tasks)
+			{
+				taskScheduler->WaitforTask(&task);
+			}
+
+			tasks.clear();
+		};
+
+		for (auto* nodePool : nodePools)
+		{
+			if (nodePool->HasUpdateBarrier())
+				waitForTasks();
+
+			if (nodePool->Count() == 0)
+				continue;
+
+			const uint32_t count = nodePool->SlotCount();
+
+			if (nodePool->GetUpdateMode() == NodeUpdateMode::Parallel)
+			{
+				auto& task = tasks.emplace_back(count, [nodePool, deltaTime, fixedUpdate](enki::TaskSetPartition range, uint32_t threadIndex)
+				{
+					if (fixedUpdate)
+						nodePool->FixedUpdateNodes(deltaTime, range.start, range.end);
+					else
+						nodePool->UpdateNodes(deltaTime, range.start, range.end);
+				});
+
+				task.m_MinRange = gNodeUpdateMinRange;
+
+				taskScheduler->AddTaskSetToPipe(&task);
+			}
+			else
+			{
+				// Serial nodes may touch any node, including those still being updated in parallel
+				waitForTasks();
+
+				if (fixedUpdate)
+					nodePool->FixedUpdateNodes(deltaTime, 0, count);
+				else
+					nodePool->UpdateNodes(deltaTime, 0, count);
+			}
+		}
+
+		// Hierarchy ordered nodes may touch any node, so all parallel updates have to finish first
+		waitForTasks();
+	}
 }
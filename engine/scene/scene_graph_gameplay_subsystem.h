@@ -26,6 +26,14 @@ namespace puffin
 
 			std::string_view GetName() const override;
 
+		private:
+
+			/*
+			 * Update nodes of serial/parallel types pool by pool, parallel pools are split across enkiTS worker threads
+			 * and only waited on when a type requests a barrier or once all pools have been queued
+			 */
+			void UpdateNodePools(double deltaTime, bool fixedUpdate);
+
 		};
 	}
 
@@ -1,6 +1,9 @@
 #include "scene/scene_graph_subsystem.h"
 
+#include <algorithm>
+
 #include "core/engine.h"
+#include "core/enkits_subsystem.h"
 #include "ecs/entt_subsystem.h"
 #include "node/transform_2d_node.h"
 #include "node/transform_3d_node.h"
@@ -12,7 +15,6 @@
 #include "node/physics/2d/box_2d_node.h"
 #include "node/physics/2d/rigidbody_2d_node.h"
 #include "node/rendering/2d/sprite_2d_node.h"
-#include "rendering/render_globals.h"
 
 namespace puffin::scene
 {
@@ -24,6 +26,11 @@ namespace puffin::scene
 	{
 		EngineSubsystem::Initialize(subsystemManager);
 
+		const auto enkiTSSubsystem = subsystemManager->CreateAndInitializeSubsystem<core::EnkiTSSubsystem>();
+
+		mTaskScheduler = enkiTSSubsystem->GetTaskScheduler();
+		mCommandBuffers.resize(mTaskScheduler->GetNumTaskThreads());
+
 		RegisterNodeType<Node>();
 
 		RegisterNodeType<Transform2DNode>();
@@ -37,33 +44,6 @@ namespace puffin::scene
 		RegisterNodeType<rendering::SpotLightNode3D>();
 		RegisterNodeType<rendering::DirectionalLightNode3D>();
 		RegisterNodeType<rendering::CameraNode3D>();
-
-		SetDefaultNodePoolSize<Node>(12000);
-
-		SetDefaultNodePoolSize<Transform2DNode>(12000);
-		SetDefaultNodePoolSize<rendering::Sprite2DNode>(12000);
-		SetDefaultNodePoolSize<physics::Rigidbody2DNode>(12000);
-		SetDefaultNodePoolSize<physics::Box2DNode>(12000);
-
-		SetDefaultNodePoolSize<TransformNode3D>(12000);
-		SetDefaultNodePoolSize<rendering::StaticMeshNode3D>(12000);
-		SetDefaultNodePoolSize<rendering::PointLightNode3D>(rendering::gMaxPointLights);
-		SetDefaultNodePoolSize<rendering::SpotLightNode3D>(rendering::gMaxSpotLights);
-		SetDefaultNodePoolSize<rendering::DirectionalLightNode3D>(rendering::gMaxDirectionalLights);
-
-		mSceneGraphUpdated = true;
-
-		for (auto [typeID, nodePool] : mNodePools)
-		{
-			if (mNodePoolDefaultSizes.find(typeID) != mNodePoolDefaultSizes.end())
-			{
-				nodePool->Resize(mNodePoolDefaultSizes.at(typeID));
-			}
-			else
-			{
-				nodePool->Resize(gDefaultNodePoolSize);
-			}
-		}
 	}
 
 	void SceneGraphSubsystem::Deinitialize()
@@ -75,15 +55,33 @@ namespace puffin::scene
 		}
 
 		mNodePools.clear();
+		mBucketedNodePools.clear();
+
+		mCommandBuffers.clear();
+		mTaskScheduler = nullptr;
 	}
 
 	void SceneGraphSubsystem::EndPlay()
 	{
-		mNodeIDs.clear();
+		mNodeOrder.Clear();
+		mHierarchyUpdateOrder.Clear();
+		mPendingSubtreeIDs.clear();
+		mNodeOrderRebuildQueued = false;
 		mIDToTypeID.clear();
 		mRootNodeIDs.clear();
 		mNodesToDestroy.clear();
 
+		for (auto& commandBuffer : mCommandBuffers)
+		{
+			commandBuffer.Clear();
+		}
+
+		mTransformHierarchy2D.Clear();
+		mTransformHierarchy3D.Clear();
+		mTransform3DUpdated.clear();
+
+		mSpatialIndex.Clear();
+
 		mGlobalTransform3Ds.Clear();
 
 		for (auto [typeID, nodePool] : mNodePools)
@@ -96,7 +94,7 @@ namespace puffin::scene
 	{
 		UpdateSceneGraph();
 
-		//UpdateGlobalTransforms();
+		UpdateGlobalTransforms();
 	}
 
 	bool SceneGraphSubsystem::ShouldUpdate()
@@ -119,6 +117,11 @@ namespace puffin::scene
 		return AddNodeInternal(typeID, name, id, parentID);
 	}
 
+	std::unique_ptr<Node> SceneGraphSubsystem::CreateDetachedNode(uint32_t typeID) const
+	{
+		return GetPool(typeID)->CreateDetachedNode(m_engine);
+	}
+
 	Node* SceneGraphSubsystem::GetNode(const UUID& id) const
 	{
 		if (!IsValidNode(id))
@@ -144,32 +147,94 @@ namespace puffin::scene
 
 	void SceneGraphSubsystem::NotifyTransformChanged(UUID id)
 	{
-		if (mNodeTransformsNeedUpdated.find(id) == mNodeTransformsNeedUpdated.end())
+		if (auto* transformNode3D = dynamic_cast<TransformNode3D*>(GetNode(id)))
 		{
-			mNodeTransformsNeedUpdated.insert(id);
-			mNodeTransformsNeedUpdatedVector.push_back(id);
+			transformNode3D->NotifyTransformChanged();
+		}
+	}
 
-			if (mNodeTransformsUpToDate.find(id) != mNodeTransformsUpToDate.end())
-			{
-				mNodeTransformsUpToDate.erase(id);
-			}
+	void SceneGraphSubsystem::QueueDestroyNode(const UUID& id)
+	{
+		mNodesToDestroy.insert(id);
+	}
 
-			const auto node = GetNode(id);
-			for (const auto& childID : node->GetChildIDs())
+	void SceneGraphSubsystem::QueueDestroyNodes(const std::vector<UUID>& ids)
+	{
+		mNodesToDestroy.reserve(mNodesToDestroy.size() + ids.size());
+		mNodesToDestroy.insert(ids.begin(), ids.end());
+	}
+
+	void SceneGraphSubsystem::ReparentNode(UUID id, UUID parentID)
+	{
+		Node* node = GetNode(id);
+
+		assert(node != nullptr && "SceneGraphSubsystem::ReparentNode - Node does not exist");
+
+		const UUID oldParentID = node->GetParentID();
+		if (oldParentID == parentID)
+			return;
+
+		Node* parent = nullptr;
+
+		if (parentID != gInvalidID)
+		{
+			parent = GetNode(parentID);
+
+			assert(parent != nullptr && "SceneGraphSubsystem::ReparentNode - Parent node does not exist");
+
+			// Make sure node isn't being parented to itself or one of its descendants
+			for (Node* ancestor = parent; ancestor; ancestor = GetNode(ancestor->GetParentID()))
 			{
-				NotifyTransformChanged(childID);
+				if (ancestor->GetID() == id)
+				{
+					assert(false && "SceneGraphSubsystem::ReparentNode - Node cannot be parented to one of its descendants");
+					return;
+				}
 			}
 		}
+
+		if (oldParentID != gInvalidID)
+		{
+			if (Node* oldParent = GetNode(oldParentID); oldParent)
+				oldParent->RemoveChildID(id);
+		}
+		else
+		{
+			mRootNodeIDs.erase(std::remove(mRootNodeIDs.begin(), mRootNodeIDs.end(), id), mRootNodeIDs.end());
+		}
+
+		if (parent)
+		{
+			parent->AddChildID(id);
+		}
+		else
+		{
+			mRootNodeIDs.push_back(id);
+		}
+
+		node->SetParentID(parentID);
+
+		// Local transform is kept, global transform will be recalculated relative to new parent
+		if (auto* transformNode2D = dynamic_cast<Transform2DNode*>(node))
+			transformNode2D->SetTransform(transformNode2D->GetTransform());
+
+		// Node & its children are moved to end of node order so they still come after their new parent
+		RemoveSubtreeFromNodeOrder(id);
+		mPendingSubtreeIDs.push_back(id);
 	}
 
-	void SceneGraphSubsystem::QueueDestroyNode(const UUID& id)
+	SceneGraphCommandBuffer& SceneGraphSubsystem::GetCommandBuffer()
 	{
-		mNodesToDestroy.insert(id);
+		const uint32_t threadNum = mTaskScheduler->GetThreadNum();
+
+		assert(threadNum < mCommandBuffers.size() && "SceneGraphSubsystem::GetCommandBuffer - Calling thread is not an enkiTS thread");
+
+		return mCommandBuffers[threadNum];
 	}
 
 	const std::vector<UUID>& SceneGraphSubsystem::GetNodeIDs() const
 	{
-		return mNodeIDs;
+		return mNodeOrder.ids;
 	}
 
 	const std::vector<UUID>& SceneGraphSubsystem::GetRootNodeIDs() const
@@ -177,40 +242,216 @@ namespace puffin::scene
 		return mRootNodeIDs;
 	}
 
+	const std::vector<UUID>& SceneGraphSubsystem::GetHierarchyUpdateNodeIDs() const
+	{
+		return mHierarchyUpdateOrder.ids;
+	}
+
+	void SceneGraphSubsystem::QueueNodeOrderRebuild()
+	{
+		mNodeOrderRebuildQueued = true;
+	}
+
+	const std::vector<INodePool*>& SceneGraphSubsystem::GetBucketedNodePools() const
+	{
+		return mBucketedNodePools;
+	}
+
+	void SceneGraphSubsystem::ReserveNodes(const std::vector<std::pair<uint32_t, uint32_t>>& typeCounts)
+	{
+		uint32_t totalCount = 0;
+
+		for (const auto& [typeID, count] : typeCounts)
+		{
+			GetPool(typeID)->Reserve(count);
+
+			totalCount += count;
+		}
+
+		ReserveNodeStorage(totalCount);
+	}
+
+	SpatialIndex& SceneGraphSubsystem::GetSpatialIndex()
+	{
+		return mSpatialIndex;
+	}
+
+	const SpatialIndex& SceneGraphSubsystem::GetSpatialIndex() const
+	{
+		return mSpatialIndex;
+	}
+
 	void SceneGraphSubsystem::UpdateSceneGraph()
 	{
+		ApplyCommandBuffers();
+
 		if (!mNodesToDestroy.empty())
 		{
+			// Detach queued nodes from any parents which are not being destroyed, one pass per parent
+			std::unordered_set<UUID> parentIDs;
+
 			for (const auto& id : mNodesToDestroy)
 			{
-				DestroyNode(id);
+				if (const auto node = GetNode(id); node && node->GetParentID() != gInvalidID)
+					parentIDs.insert(node->GetParentID());
 			}
 
-			for (auto it = mRootNodeIDs.end(); it != mRootNodeIDs.begin(); --it)
+			for (const auto& parentID : parentIDs)
 			{
-				if (mNodesToDestroy.count(*it) > 0)
-					mRootNodeIDs.erase(it);
+				if (mNodesToDestroy.find(parentID) == mNodesToDestroy.end())
+				{
+					if (const auto parent = GetNode(parentID); parent)
+						parent->RemoveChildIDs(mNodesToDestroy);
+				}
 			}
 
+			for (const auto& id : mNodesToDestroy)
+			{
+				DestroyNode(id);
+			}
+
+			mRootNodeIDs.erase(std::remove_if(mRootNodeIDs.begin(), mRootNodeIDs.end(), [&](const UUID& id)
+			{
+				return mNodesToDestroy.find(id) != mNodesToDestroy.end();
+			}), mRootNodeIDs.end());
+
 			mNodesToDestroy.clear();
-			mSceneGraphUpdated = true;
 		}
 
-		if (mSceneGraphUpdated)
+		if (mNodeOrderRebuildQueued)
 		{
-			mNodeIDs.clear();
+			RebuildNodeOrder();
+		}
+		else
+		{
+			InsertPendingSubtrees();
+
+			if (mNodeOrder.ShouldCompact())
+				mNodeOrder.Compact();
+
+			if (mHierarchyUpdateOrder.ShouldCompact())
+				mHierarchyUpdateOrder.Compact();
+
+			if (mTransformHierarchy2D.ShouldRebuild() || mTransformHierarchy3D.ShouldRebuild())
+				BuildTransformHierarchies();
+		}
+	}
 
-			for (const auto& id : mRootNodeIDs)
+	void SceneGraphSubsystem::ApplyCommandBuffers()
+	{
+		struct QueuedCommand
+		{
+			const SceneGraphCommandBuffer* buffer;
+			const SceneGraphCommand* command;
+		};
+
+		std::vector<QueuedCommand> commands;
+
+		for (const auto& commandBuffer : mCommandBuffers)
+		{
+			for (const auto& command : commandBuffer.GetCommands())
 			{
-				AddIDAndChildIDs(id, mNodeIDs);
+				commands.push_back({ &commandBuffer, &command });
 			}
+		}
 
-			mSceneGraphUpdated = false;
+		if (commands.empty())
+			return;
+
+		// Commands from each source node are all recorded on the same thread, so sorting by source keeps them in record order
+		// while making the result independent of which thread updated which node
+		std::stable_sort(commands.begin(), commands.end(), [](const QueuedCommand& a, const QueuedCommand& b)
+		{
+			return a.command->sourceID < b.command->sourceID;
+		});
+
+		// Nodes are added before any other command is applied, so commands targeting nodes added by another source this
+		// frame aren't dropped for sorting before the node exists
+		std::vector<QueuedCommand> addCommands;
+		std::unordered_set<UUID> pendingAddIDs;
+
+		for (const auto& queuedCommand : commands)
+		{
+			if (queuedCommand.command->type == SceneGraphCommandType::AddNode)
+			{
+				addCommands.push_back(queuedCommand);
+				pendingAddIDs.insert(queuedCommand.command->id);
+			}
+		}
+
+		// Nodes whose parent is added later in order are deferred to next pass, until no more nodes can be added
+		bool addedNode = true;
+
+		while (!addCommands.empty() && addedNode)
+		{
+			addedNode = false;
+
+			auto deferredEnd = addCommands.begin();
+
+			for (const auto& queuedCommand : addCommands)
+			{
+				const auto& [buffer, command] = queuedCommand;
+
+				if (command->parentID != gInvalidID && !IsValidNode(command->parentID))
+				{
+					// Skip nodes whose parent doesn't exist & isn't about to be added
+					if (pendingAddIDs.find(command->parentID) != pendingAddIDs.end())
+						*deferredEnd++ = queuedCommand;
+					else
+						pendingAddIDs.erase(command->id);
+
+					continue;
+				}
+
+				AddNodeInternal(command->typeID, buffer->GetName(command->payloadIdx), command->id, command->parentID);
+				pendingAddIDs.erase(command->id);
+
+				addedNode = true;
+			}
+
+			addCommands.erase(deferredEnd, addCommands.end());
+		}
+
+		for (const auto& [buffer, command] : commands)
+		{
+			switch (command->type)
+			{
+			case SceneGraphCommandType::AddNode:
+				break;
+
+			case SceneGraphCommandType::DestroyNode:
+				QueueDestroyNode(command->id);
+				break;
+
+			case SceneGraphCommandType::Reparent:
+				if (IsValidNode(command->id) && (command->parentID == gInvalidID || IsValidNode(command->parentID)))
+					ReparentNode(command->id, command->parentID);
+				break;
+
+			case SceneGraphCommandType::SetTransform2D:
+				if (auto* transformNode2D = dynamic_cast<Transform2DNode*>(GetNode(command->id)))
+					transformNode2D->SetTransform(buffer->GetTransform2D(command->payloadIdx));
+				break;
+
+			case SceneGraphCommandType::SetTransform3D:
+				if (auto* transformNode3D = dynamic_cast<TransformNode3D*>(GetNode(command->id)))
+					transformNode3D->Transform() = buffer->GetTransform3D(command->payloadIdx);
+				break;
+			}
+		}
+
+		for (auto& commandBuffer : mCommandBuffers)
+		{
+			commandBuffer.Clear();
 		}
 	}
 
 	void SceneGraphSubsystem::DestroyNode(UUID id)
 	{
+		// Child ids of queued parents are left as they are, so a child queued before its parent will already be destroyed
+		if (!IsValidNode(id))
+			return;
+
 		if (const auto node = GetNode(id); node)
 		{
 			for (const auto& childID : node->GetChildIDs())
@@ -223,6 +464,10 @@ namespace puffin::scene
 			node->Deinitialize();
 		}
 
+		RemoveFromNodeOrder(id);
+
+		mSpatialIndex.Remove(id);
+
 		GetPool(mIDToTypeID.at(id))->RemoveNode(id);
 
 		mIDToTypeID.erase(id);
@@ -231,67 +476,509 @@ namespace puffin::scene
 			mGlobalTransform3Ds.Erase(id);
 	}
 
-	void SceneGraphSubsystem::AddIDAndChildIDs(UUID id, std::vector<UUID>& nodeIDs)
+	void SceneGraphSubsystem::RebuildNodeOrder()
+	{
+		mNodeOrder.Clear();
+		mHierarchyUpdateOrder.Clear();
+		mPendingSubtreeIDs.clear();
+
+		mNodeOrder.ids.reserve(mIDToTypeID.size());
+		mNodeOrder.idToIdx.reserve(mIDToTypeID.size());
+
+		for (const auto& id : mRootNodeIDs)
+		{
+			AddIDAndChildIDs(id);
+		}
+
+		BuildTransformHierarchies();
+
+		mNodeOrderRebuildQueued = false;
+	}
+
+	void SceneGraphSubsystem::InsertPendingSubtrees()
+	{
+		if (mPendingSubtreeIDs.empty())
+			return;
+
+		std::vector<UUID> subtreeRootIDs;
+		std::unordered_set<UUID> subtreeRootIDSet;
+
+		for (const auto& id : mPendingSubtreeIDs)
+		{
+			// Skip nodes which were destroyed, are already in node order or are queued more than once
+			if (!IsValidNode(id) || mNodeOrder.Contains(id) || subtreeRootIDSet.find(id) != subtreeRootIDSet.end())
+				continue;
+
+			// Parent isn't in node order yet, so node will be added along with its parent's subtree
+			const UUID parentID = GetNode(id)->GetParentID();
+			if (parentID != gInvalidID && !mNodeOrder.Contains(parentID))
+				continue;
+
+			subtreeRootIDs.push_back(id);
+			subtreeRootIDSet.insert(id);
+		}
+
+		mPendingSubtreeIDs.clear();
+
+		if (subtreeRootIDs.empty())
+			return;
+
+		std::vector<QueuedTransformNode> subtreeRoots;
+		std::vector<UUID> subtreeIDs;
+		std::unordered_set<UUID> hierarchyUpdateIDs;
+
+		// Each subtree is keyed by node which follows it, so subtrees inserted at same place can be chained in depth first order
+		std::unordered_map<UUID, PendingSubtree> nextIDToSubtree;
+		bool appendOnly = true;
+
+		for (const auto& id : subtreeRootIDs)
+		{
+			PendingSubtree subtree;
+			subtree.nextID = FindNextSubtreeID(id, subtreeRootIDSet);
+			subtree.start = subtreeIDs.size();
+
+			CollectSubtreeIDs(id, subtreeIDs, hierarchyUpdateIDs);
+
+			subtree.end = subtreeIDs.size();
+
+			if (subtree.nextID != gInvalidID && mNodeOrder.Contains(subtree.nextID))
+				appendOnly = false;
+
+			nextIDToSubtree.emplace(subtree.nextID, subtree);
+
+			const UUID parentID = GetNode(id)->GetParentID();
+			subtreeRoots.push_back({ id, mTransformHierarchy2D.GetEntryIdx(parentID), mTransformHierarchy3D.GetEntryIdx(parentID) });
+		}
+
+		// Collect chain of subtrees ending before nextID, last subtree of chain comes first in node order
+		std::vector<const PendingSubtree*> chain;
+
+		const auto collectChain = [&](UUID nextID)
+		{
+			chain.clear();
+
+			for (auto it = nextIDToSubtree.find(nextID); it != nextIDToSubtree.end(); it = nextIDToSubtree.find(subtreeIDs[it->second.start]))
+			{
+				chain.push_back(&it->second);
+			}
+		};
+
+		if (appendOnly)
+		{
+			// New root nodes & children of last subtree can be appended without moving any ids
+			collectChain(gInvalidID);
+
+			for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+			{
+				for (size_t idx = (*it)->start; idx < (*it)->end; ++idx)
+				{
+					mNodeOrder.Append(subtreeIDs[idx]);
+
+					if (hierarchyUpdateIDs.find(subtreeIDs[idx]) != hierarchyUpdateIDs.end())
+						mHierarchyUpdateOrder.Append(subtreeIDs[idx]);
+				}
+			}
+		}
+		else
+		{
+			// Splice all subtrees in with a single pass over node order, dropping tombstones as it goes
+			std::vector<UUID> ids;
+			std::vector<UUID> hierarchyIDs;
+			ids.reserve(mNodeOrder.idToIdx.size() + subtreeIDs.size());
+			hierarchyIDs.reserve(mHierarchyUpdateOrder.idToIdx.size() + hierarchyUpdateIDs.size());
+
+			const auto addID = [&](UUID id)
+			{
+				ids.push_back(id);
+
+				if (mHierarchyUpdateOrder.Contains(id) || hierarchyUpdateIDs.find(id) != hierarchyUpdateIDs.end())
+					hierarchyIDs.push_back(id);
+			};
+
+			const auto addChain = [&](UUID nextID)
+			{
+				collectChain(nextID);
+
+				for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+				{
+					for (size_t idx = (*it)->start; idx < (*it)->end; ++idx)
+					{
+						addID(subtreeIDs[idx]);
+					}
+				}
+			};
+
+			for (const auto& id : mNodeOrder.ids)
+			{
+				if (id == gInvalidID)
+					continue;
+
+				addChain(id);
+				addID(id);
+			}
+
+			addChain(gInvalidID);
+
+			mNodeOrder.Assign(std::move(ids));
+			mHierarchyUpdateOrder.Assign(std::move(hierarchyIDs));
+		}
+
+		AppendTransformHierarchyLevels(subtreeRoots);
+
+		++mTransformHierarchy2D.appendCount;
+		++mTransformHierarchy3D.appendCount;
+	}
+
+	void SceneGraphSubsystem::CollectSubtreeIDs(UUID id, std::vector<UUID>& ids, std::unordered_set<UUID>& hierarchyUpdateIDs) const
+	{
+		ids.push_back(id);
+
+		if (GetPool(mIDToTypeID.at(id))->GetUpdateMode() == NodeUpdateMode::Hierarchy)
+			hierarchyUpdateIDs.insert(id);
+
+		for (const auto childID : GetNode(id)->GetChildIDs())
+		{
+			CollectSubtreeIDs(childID, ids, hierarchyUpdateIDs);
+		}
+	}
+
+	UUID SceneGraphSubsystem::FindNextSubtreeID(UUID id, const std::unordered_set<UUID>& subtreeRootIDs) const
+	{
+		// First later sibling which is in node order or is a new subtree, searched from back as new nodes are usually added last
+		const auto findNextSibling = [&](auto rbegin, auto rend, UUID siblingID) -> UUID
+		{
+			const auto siblingIt = std::find(rbegin, rend, siblingID);
+			if (siblingIt == rend)
+				return gInvalidID;
+
+			for (auto it = siblingIt.base(); it != rbegin.base(); ++it)
+			{
+				if (mNodeOrder.Contains(*it) || subtreeRootIDs.find(*it) != subtreeRootIDs.end())
+					return *it;
+			}
+
+			return gInvalidID;
+		};
+
+		// Walk up through ancestors until one has a later sibling
+		UUID nodeID = id;
+
+		while (true)
+		{
+			const UUID parentID = GetNode(nodeID)->GetParentID();
+
+			UUID nextID;
+
+			if (parentID != gInvalidID)
+			{
+				const auto& siblingIDs = GetNode(parentID)->GetChildIDs();
+				nextID = findNextSibling(siblingIDs.rbegin(), siblingIDs.rend(), nodeID);
+			}
+			else
+			{
+				nextID = findNextSibling(mRootNodeIDs.rbegin(), mRootNodeIDs.rend(), nodeID);
+			}
+
+			if (nextID != gInvalidID || parentID == gInvalidID)
+				return nextID;
+
+			nodeID = parentID;
+		}
+	}
+
+	void SceneGraphSubsystem::AddIDAndChildIDs(UUID id)
 	{
-		mNodeIDs.push_back(id);
+		mNodeOrder.Append(id);
+
+		if (GetPool(mIDToTypeID.at(id))->GetUpdateMode() == NodeUpdateMode::Hierarchy)
+			mHierarchyUpdateOrder.Append(id);
 
 		const auto node = GetNode(id);
 
 		for (const auto childID : node->GetChildIDs())
 		{
-			AddIDAndChildIDs(childID, nodeIDs);
+			AddIDAndChildIDs(childID);
 		}
 	}
 
-	void SceneGraphSubsystem::UpdateGlobalTransforms()
+	void SceneGraphSubsystem::RemoveFromNodeOrder(UUID id)
 	{
-		const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
-		const auto registry = enttSubsystem->GetRegistry();
+		mNodeOrder.Remove(id);
+		mHierarchyUpdateOrder.Remove(id);
+
+		mTransformHierarchy2D.Remove(id);
+		mTransformHierarchy3D.Remove(id);
+	}
+
+	void SceneGraphSubsystem::RemoveSubtreeFromNodeOrder(UUID id)
+	{
+		RemoveFromNodeOrder(id);
+
+		if (const auto node = GetNode(id); node)
+		{
+			for (const auto childID : node->GetChildIDs())
+			{
+				RemoveSubtreeFromNodeOrder(childID);
+			}
+		}
+	}
+
+	void SceneGraphSubsystem::BuildTransformHierarchies()
+	{
+		// Keep previous entries so their versions can be carried over, otherwise every global transform would be recalculated/re-indexed
+		TransformHierarchy previousHierarchy2D;
+		TransformHierarchy previousHierarchy3D;
+		std::swap(previousHierarchy2D, mTransformHierarchy2D);
+		std::swap(previousHierarchy3D, mTransformHierarchy3D);
+
+		mTransformHierarchy2D.Clear();
+		mTransformHierarchy3D.Clear();
+
+		std::vector<QueuedTransformNode> currentLevel;
+		currentLevel.reserve(mRootNodeIDs.size());
+
+		for (const auto& id : mRootNodeIDs)
+		{
+			currentLevel.push_back({ id, -1, -1 });
+		}
+
+		AppendTransformHierarchyLevels(currentLevel);
 
-		for (const auto& id : mNodeTransformsNeedUpdatedVector)
+		for (auto& entry : mTransformHierarchy2D.entries)
 		{
-			UpdateGlobalTransform(id);
+			if (const int32_t previousIdx = previousHierarchy2D.GetEntryIdx(entry.node->GetID()); previousIdx >= 0)
+				entry.indexedVersion = previousHierarchy2D.entries[previousIdx].indexedVersion;
 		}
 
-		mNodeTransformsNeedUpdated.clear();
-		mNodeTransformsNeedUpdatedVector.clear();
+		for (auto& entry : mTransformHierarchy3D.entries)
+		{
+			if (const int32_t previousIdx = previousHierarchy3D.GetEntryIdx(entry.node->GetID()); previousIdx >= 0)
+			{
+				const auto& previousEntry = previousHierarchy3D.entries[previousIdx];
+
+				entry.localVersion = previousEntry.localVersion;
+				entry.parentGlobalVersion = previousEntry.parentGlobalVersion;
+				entry.globalVersion = previousEntry.globalVersion;
+			}
+		}
+
+		mTransform3DUpdated.assign(mTransformHierarchy3D.entries.size(), 0);
 	}
 
-	void SceneGraphSubsystem::UpdateGlobalTransform(UUID id)
+	void SceneGraphSubsystem::AppendTransformHierarchyLevels(std::vector<QueuedTransformNode>& currentLevel)
 	{
-		if (mNodeTransformsUpToDate.find(id) == mNodeTransformsUpToDate.end())
+		auto& entries2D = mTransformHierarchy2D.entries;
+		auto& entries3D = mTransformHierarchy3D.entries;
+		auto& levelOffsets2D = mTransformHierarchy2D.levelOffsets;
+		auto& levelOffsets3D = mTransformHierarchy3D.levelOffsets;
+
+		// Remove end offset of last level, it's added back once new levels have been appended
+		if (!levelOffsets2D.empty())
+			levelOffsets2D.pop_back();
+
+		if (!levelOffsets3D.empty())
+			levelOffsets3D.pop_back();
+
+		std::vector<QueuedTransformNode> nextLevel;
+
+		// Walk scene graph breadth first so each level of the hierarchy is contiguous
+		while (!currentLevel.empty())
 		{
-			if (const auto node = GetNode(id); node)
+			const size_t levelStart2D = entries2D.size();
+			const size_t levelStart3D = entries3D.size();
+
+			for (const auto& queuedNode : currentLevel)
 			{
-				const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
-				const auto registry = enttSubsystem->GetRegistry();
+				auto* node = GetNode(queuedNode.id);
+				if (!node)
+					continue;
+
+				int32_t idx2D = -1;
+				int32_t idx3D = -1;
 
-				if (auto* transformNode3D = dynamic_cast<TransformNode3D*>(node))
+				if (dynamic_cast<Transform2DNode*>(node))
 				{
-					auto& globalTransform = mGlobalTransform3Ds.At(id);
-					globalTransform.position = { 0.f };
-					globalTransform.orientationQuat = angleAxis(0.0f, glm::vec3(0.0f, 0.0f, 1.0));
-					globalTransform.orientationEulerAngles = { 0.0f, 0.0f, 0.0f };
-					globalTransform.scale = { 1.f };
+					idx2D = static_cast<int32_t>(entries2D.size());
+					entries2D.push_back({ node, queuedNode.parentIdx2D });
+					mTransformHierarchy2D.idToEntryIdx.emplace(queuedNode.id, idx2D);
+				}
+				else if (dynamic_cast<TransformNode3D*>(node))
+				{
+					idx3D = static_cast<int32_t>(entries3D.size());
+					entries3D.push_back({ node, queuedNode.parentIdx3D });
+					mTransformHierarchy3D.idToEntryIdx.emplace(queuedNode.id, idx3D);
+				}
 
-					const auto& localTransform = transformNode3D->GetTransform();
+				for (const auto& childID : node->GetChildIDs())
+				{
+					nextLevel.push_back({ childID, idx2D, idx3D });
+				}
+			}
 
-					auto parentNode = dynamic_cast<TransformNode3D*>(node->GetParent());
-					if (parentNode)
-					{
-						const auto& parentTransform = parentNode->GetGlobalTransform();
+			// Levels without any entries of a transform type are skipped
+			if (entries2D.size() > levelStart2D)
+				levelOffsets2D.push_back(levelStart2D);
 
-						ApplyLocalToGlobalTransform3D(localTransform, parentTransform, globalTransform);
-					}
-					else
-					{
-						ApplyLocalToGlobalTransform3D(localTransform, {}, globalTransform);
-					}
+			if (entries3D.size() > levelStart3D)
+				levelOffsets3D.push_back(levelStart3D);
 
-					registry->patch<TransformComponent3D>(node->GetEntity());
+			std::swap(currentLevel, nextLevel);
+			nextLevel.clear();
+		}
+
+		levelOffsets2D.push_back(entries2D.size());
+		levelOffsets3D.push_back(entries3D.size());
+
+		mTransform3DUpdated.resize(entries3D.size(), 0);
+	}
+
+	template<typename UpdateFunc>
+	void SceneGraphSubsystem::UpdateTransformHierarchy(const TransformHierarchy& hierarchy, const UpdateFunc& updateFunc)
+	{
+		if (hierarchy.entries.empty())
+			return;
+
+		for (size_t level = 0; level + 1 < hierarchy.levelOffsets.size(); ++level)
+		{
+			const size_t start = hierarchy.levelOffsets[level];
+			const size_t end = hierarchy.levelOffsets[level + 1];
+			const auto count = static_cast<uint32_t>(end - start);
+
+			if (count < gTransformUpdateMinRange)
+			{
+				updateFunc(start, end);
+
+				continue;
+			}
+
+			enki::TaskSet task(count, [&](enki::TaskSetPartition range, uint32_t threadIndex)
+			{
+				updateFunc(start + range.start, start + range.end);
+			});
+
+			task.m_MinRange = gTransformUpdateMinRange;
+
+			mTaskScheduler->AddTaskSetToPipe(&task);
+			mTaskScheduler->WaitforTask(&task);
+		}
+	}
+
+	void SceneGraphSubsystem::UpdateGlobalTransforms()
+	{
+		UpdateGlobalTransforms2D();
+		UpdateGlobalTransforms3D();
+	}
+
+	void SceneGraphSubsystem::UpdateGlobalTransforms2D()
+	{
+		auto& entries = mTransformHierarchy2D.entries;
+		const Transform2D rootTransform = {};
+
+		UpdateTransformHierarchy(mTransformHierarchy2D, [&](size_t start, size_t end)
+		{
+			for (size_t idx = start; idx < end; ++idx)
+			{
+				const auto& entry = entries[idx];
+				auto* node = static_cast<Transform2DNode*>(entry.node);
+
+				// Skip entries of removed nodes
+				if (!node)
+					continue;
+
+				if (entry.parentIdx >= 0)
+				{
+					// Parent is on a previous level, so its global transform is already up to date
+					auto* parent = static_cast<Transform2DNode*>(entries[entry.parentIdx].node);
+
+					node->UpdateTransforms(parent->GetGlobalTransform());
+				}
+				else
+				{
+					node->UpdateTransforms(rootTransform);
 				}
+			}
+		});
+
+		// Global transforms can also be modified outside of hierarchy update, so compare versions rather than tracking updated entries
+		for (auto& entry : entries)
+		{
+			auto* node = static_cast<Transform2DNode*>(entry.node);
+
+			if (!node || node->GetGlobalTransformVersion() == entry.indexedVersion)
+				continue;
+
+			mSpatialIndex.Update2D(node->GetID(), node->GetGlobalTransform());
+
+			entry.indexedVersion = node->GetGlobalTransformVersion();
+		}
+	}
+
+	void SceneGraphSubsystem::UpdateGlobalTransforms3D()
+	{
+		auto& entries = mTransformHierarchy3D.entries;
+
+		// Local transforms written in place by bulk writers (i.e. physics) are marked changed rather than set through nodes
+		const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
+		const auto registry = enttSubsystem->GetRegistry();
+
+		for (const auto entity : enttSubsystem->GetChanged<TransformComponent3D>())
+		{
+			if (!registry->valid(entity))
+				continue;
+
+			NotifyTransformChanged(enttSubsystem->GetID(entity));
+		}
 
-				mNodeTransformsUpToDate.insert(id);
+		UpdateTransformHierarchy(mTransformHierarchy3D, [&](size_t start, size_t end)
+		{
+			for (size_t idx = start; idx < end; ++idx)
+			{
+				auto& entry = entries[idx];
+				auto* node = static_cast<TransformNode3D*>(entry.node);
+
+				// Skip entries of removed nodes
+				if (!node)
+					continue;
+
+				const uint32_t localVersion = node->GetTransformVersion();
+				const uint32_t parentGlobalVersion = entry.parentIdx >= 0 ? entries[entry.parentIdx].globalVersion : 0;
+
+				// Only recalculate if local transform or parent global transform changed since last update
+				if (localVersion == entry.localVersion && parentGlobalVersion == entry.parentGlobalVersion)
+					continue;
+
+				auto& globalTransform = mGlobalTransform3Ds.At(node->GetID());
+				const auto& localTransform = node->GetTransform();
+
+				if (entry.parentIdx >= 0)
+				{
+					const auto& parentTransform = mGlobalTransform3Ds.At(entries[entry.parentIdx].node->GetID());
+
+					ApplyLocalToGlobalTransform3D(localTransform, parentTransform, globalTransform);
+				}
+				else
+				{
+					ApplyLocalToGlobalTransform3D(localTransform, {}, globalTransform);
+				}
+
+				entry.localVersion = localVersion;
+				entry.parentGlobalVersion = parentGlobalVersion;
+				++entry.globalVersion;
+
+				mTransform3DUpdated[idx] = 1;
+			}
+		});
+
+		// Spatial index is not thread safe, so it is updated once all transforms are updated
+		for (size_t idx = 0; idx < entries.size(); ++idx)
+		{
+			if (mTransform3DUpdated[idx])
+			{
+				const UUID id = entries[idx].node->GetID();
+
+				mSpatialIndex.Update3D(id, mGlobalTransform3Ds.At(id));
+
+				mTransform3DUpdated[idx] = 0;
 			}
 		}
 	}
@@ -327,20 +1014,42 @@ namespace puffin::scene
 	void SceneGraphSubsystem::AddNodeInternalBase(Node* node, uint32_t typeID, UUID id, UUID parentID)
 	{
 		assert(node != nullptr && "SceneGraphSubsystem::AddNodeInternalBase - Node was nullptr");
+		assert(node->GetID() == id && "SceneGraphSubsystem::AddNodeInternalBase - Node id does not match");
+
+		Node* parent = nullptr;
 
-		// Set node parent if necessary
 		if (parentID != gInvalidID)
 		{
-			node->SetParentID(parentID);
+			parent = GetNode(parentID);
+
+			assert(parent != nullptr && "SceneGraphSubsystem::AddNodeInternalBase - Parent node does not exist");
+		}
+
+		AddNodeInternalBase(node, typeID, parent);
+	}
+
+	void SceneGraphSubsystem::AddNodeInternalBase(Node* node, uint32_t typeID, Node* parent)
+	{
+		assert(node != nullptr && "SceneGraphSubsystem::AddNodeInternalBase - Node was nullptr");
+
+		const UUID id = node->GetID();
+
+		// Set node parent if necessary
+		if (parent)
+		{
+			node->SetParentID(parent->GetID());
 
-			Node* parent_node_ptr = GetNode(parentID);
-			parent_node_ptr->AddChildID(id);
+			parent->AddChildID(id);
 		}
 		else
 		{
 			mRootNodeIDs.push_back(id);
 		}
 
+		// Nodes added under a parent which isn't in node order yet will be added along with their parent
+		if (!parent || mNodeOrder.Contains(parent->GetID()))
+			mPendingSubtreeIDs.push_back(id);
+
 		node->Initialize();
 
 		mIDToTypeID.insert({ id, typeID });
@@ -349,9 +1058,33 @@ namespace puffin::scene
 		{
 			mGlobalTransform3Ds.Emplace(id, TransformComponent3D());
 
-			NotifyTransformChanged(id);
+			transformNode3D->NotifyTransformChanged();
+		}
+	}
+
+	Node* SceneGraphSubsystem::PrepareAddNodes(uint32_t count, UUID parentID)
+	{
+		ReserveNodeStorage(count);
+
+		if (parentID == gInvalidID)
+		{
+			mRootNodeIDs.reserve(mRootNodeIDs.size() + count);
+
+			return nullptr;
 		}
 
-		mSceneGraphUpdated = true;
+		Node* parent = GetNode(parentID);
+
+		assert(parent != nullptr && "SceneGraphSubsystem::PrepareAddNodes - Parent node does not exist");
+
+		return parent;
+	}
+
+	void SceneGraphSubsystem::ReserveNodeStorage(uint32_t count)
+	{
+		m_engine->GetSubsystem<ecs::EnTTSubsystem>()->Reserve(count);
+
+		mIDToTypeID.reserve(mIDToTypeID.size() + count);
+		mGlobalTransform3Ds.Reserve(mGlobalTransform3Ds.Count() + count);
 	}
 }
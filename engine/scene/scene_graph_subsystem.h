@@ -1,16 +1,28 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <unordered_map>
 #include <memory>
+#include <type_traits>
 #include <unordered_set>
+#include <vector>
 
 #include "subsystem/engine_subsystem.h"
 #include "node/node.h"
+#include "node/transform_2d_node.h"
 #include "types/uuid.h"
 #include "types/storage/mapped_array.h"
 #include "types/storage/mapped_vector.h"
+#include "types/storage/chunked_pool.h"
 #include "component/transform_component_3d.h"
+#include "scene/scene_graph_command_buffer.h"
+#include "scene/spatial_index.h"
+
+namespace enki
+{
+	class TaskScheduler;
+}
 
 namespace puffin
 {
@@ -21,7 +33,11 @@ namespace puffin
 
 	namespace scene
 	{
-		constexpr uint32_t gDefaultNodePoolSize = 128;
+		constexpr uint32_t gNodePoolChunkSize = 128; // Number of nodes in each node pool chunk
+		constexpr uint32_t gTransformUpdateMinRange = 256; // Minimum number of nodes in a hierarchy level before transform updates are split across threads
+		constexpr uint32_t gNodeUpdateMinRange = 64; // Minimum number of nodes updated by each task when updating parallel node types
+		constexpr uint32_t gNodeOrderMinTombstones = 256; // Minimum number of removed entries before node order lists/transform hierarchies are compacted
+		constexpr uint32_t gTransformHierarchyMaxAppends = 32; // Number of incremental appends before transform hierarchies are rebuilt to merge levels
 
 		// PFN_TODO_SERIALIZATION - Rework node serialization logic to match component implementation
 
@@ -34,18 +50,38 @@ namespace puffin
 			virtual ~INodePool() = default;
 
 			virtual Node* AddNode(const std::shared_ptr<core::Engine>& engine, const std::string& name, UUID id = gInvalidID) = 0;
+
+			// Create node outside of pool, see SceneGraphSubsystem::CreateDetachedNode
+			[[nodiscard]] virtual std::unique_ptr<Node> CreateDetachedNode(const std::shared_ptr<core::Engine>& engine) const = 0;
 			virtual Node* GetNode(UUID id) = 0;
 			virtual void RemoveNode(UUID id) = 0;
 			virtual bool IsValid(UUID id) = 0;
-			virtual void Resize(uint32_t newSize, bool forceShrink = false) = 0;
+			virtual void Reserve(uint32_t count) = 0;
 			virtual void Reset() = 0;
 			virtual void Clear() = 0;
 
+			[[nodiscard]] virtual uint32_t Count() const = 0;
+			[[nodiscard]] virtual uint32_t SlotCount() const = 0;
+			[[nodiscard]] virtual NodeUpdateMode GetUpdateMode() const = 0;
+			[[nodiscard]] virtual bool HasUpdateBarrier() const = 0;
+
+			// Update/fixed update nodes in slot range [start, end) of pool, range should be within [0, SlotCount())
+			virtual void UpdateNodes(double deltaTime, uint32_t start, uint32_t end) = 0;
+			virtual void FixedUpdateNodes(double deltaTime, uint32_t start, uint32_t end) = 0;
+
 		};
 
+		/*
+		 * Pool of nodes of type T, nodes are stored in chunks so their addresses stay
+		 * valid for as long as they are in the scene
+		 */
 		template<typename T>
 		class NodePool final : public INodePool
 		{
+			// Transform2DNode flags its children for update whenever its transform changes, so it touches other nodes
+			static_assert(NodeUpdateTraits<T>::updateMode != NodeUpdateMode::Parallel || !std::is_base_of_v<Transform2DNode, T>,
+				"NodePool - Types derived from Transform2DNode modify their children & can't be updated in parallel");
+
 		public:
 
 			NodePool() = default;
@@ -57,22 +93,24 @@ namespace puffin
 				if (id == gInvalidID)
 					id = GenerateId();
 
-				if (mNodes.Full())
-				{
-					uint32_t newSize = mNodes.Size() * 2;
-
-					mNodes.Resize(newSize);
-				}
-
-				mNodes.Emplace(id, T{});
+				const uint32_t slot = mNodes.Emplace();
+				mIDToSlot.emplace(id, slot);
 
-				T& node = mNodes.At(id);
+				T& node = mNodes.At(slot);
 				auto* nodePtr = static_cast<Node*>(&node);
 				nodePtr->Prepare(engine, name, id);
 
 				return &node;
 			}
 
+			[[nodiscard]] std::unique_ptr<Node> CreateDetachedNode(const std::shared_ptr<core::Engine>& engine) const override
+			{
+				std::unique_ptr<Node> node = std::make_unique<T>();
+				node->Prepare(engine, "", gInvalidID);
+
+				return node;
+			}
+
 			Node* GetNode(UUID id) override
 			{
 				if (IsValid(id))
@@ -83,70 +121,253 @@ namespace puffin
 
 			void RemoveNode(UUID id) override
 			{
-				GetNode(id)->Reset();
+				const uint32_t slot = mIDToSlot.at(id);
 
-				mNodes.Erase(id, false);
+				mNodes.At(slot).Reset();
+				mNodes.Erase(slot);
+
+				mIDToSlot.erase(id);
 			}
 
 			bool IsValid(UUID id) override
 			{
-				return mNodes.Contains(id);
+				return mIDToSlot.find(id) != mIDToSlot.end();
 			}
 
-			void Resize(uint32_t newSize, bool forceShrink = false) override
+			/*
+			 * Make sure pool has space for count additional nodes, so adding them will not allocate
+			 */
+			void Reserve(uint32_t count) override
 			{
-				if (newSize > mNodes.Size() || (newSize < mNodes.Size() && forceShrink))
-					mNodes.Resize(newSize);
+				mNodes.Reserve(count);
+				mIDToSlot.reserve(mIDToSlot.size() + count);
 			}
 
 			/*
-			 * Reset all nodes in pool
+			 * Reset all nodes in pool, allocated chunks are kept for reuse
 			 */
 			void Reset() override
 			{
-				for (auto& node : mNodes)
+				mNodes.ForEach([](T& node)
 				{
 					node.Reset();
-				}
+				});
 
-				mNodes.Clear(false);
+				mNodes.Reset();
+				mIDToSlot.clear();
 			}
 
 			/*
-			 * Reset & clear all nodes in pool
+			 * Reset all nodes in pool & release all chunks
 			 */
 			void Clear() override
 			{
-				for (auto& node : mNodes)
+				mNodes.ForEach([](T& node)
 				{
 					node.Reset();
-				}
+				});
 
 				mNodes.Clear();
+				mIDToSlot.clear();
+			}
+
+			[[nodiscard]] uint32_t Count() const override
+			{
+				return mNodes.Count();
+			}
+
+			[[nodiscard]] uint32_t SlotCount() const override
+			{
+				return mNodes.SlotCount();
+			}
+
+			[[nodiscard]] NodeUpdateMode GetUpdateMode() const override
+			{
+				return NodeUpdateTraits<T>::updateMode;
+			}
+
+			[[nodiscard]] bool HasUpdateBarrier() const override
+			{
+				return NodeUpdateTraits<T>::updateBarrier;
+			}
+
+			/*
+			 * Update nodes in pool order, calls are qualified so they are resolved at compile time
+			 * Chunks are looked up per node so nodes added during update don't invalidate the loop
+			 */
+			void UpdateNodes(double deltaTime, uint32_t start, uint32_t end) override
+			{
+				mNodes.ForEach(start, end, [deltaTime](T& node)
+				{
+					if (node.T::ShouldUpdate())
+						node.T::Update(deltaTime);
+				});
+			}
+
+			void FixedUpdateNodes(double deltaTime, uint32_t start, uint32_t end) override
+			{
+				mNodes.ForEach(start, end, [deltaTime](T& node)
+				{
+					if (node.T::ShouldFixedUpdate())
+						node.T::FixedUpdate(deltaTime);
+				});
 			}
 
 			T* GetNodeTyped(UUID id)
 			{
-				return &mNodes.At(id);
+				return &mNodes.At(mIDToSlot.at(id));
 			}
 
 			void GetNodes(std::vector<T*>& nodes)
 			{
-				nodes.resize(mNodes.Count());
+				nodes.clear();
+				nodes.reserve(mNodes.Count());
 
-				int i = 0;
-				for (auto& node : mNodes)
+				mNodes.ForEach([&nodes](T& node)
 				{
-					nodes[i] = &node;
+					nodes.push_back(&node);
+				});
+			}
+
+		private:
+
+			ChunkedPool<T, gNodePoolChunkSize> mNodes;
+			std::unordered_map<UUID, uint32_t> mIDToSlot;
 
-					i++;
+		};
+
+		/*
+		 * Node ids in execution order, depth first so each subtree is contiguous & parents always come before their children
+		 * Removed ids are replaced with gInvalidID and compacted away once enough have built up
+		 */
+		struct NodeOrderList
+		{
+			std::vector<UUID> ids;
+			std::unordered_map<UUID, uint32_t> idToIdx;
+			uint32_t tombstoneCount = 0;
+
+			[[nodiscard]] bool Contains(UUID id) const
+			{
+				return idToIdx.find(id) != idToIdx.end();
+			}
+
+			void Append(UUID id)
+			{
+				idToIdx.emplace(id, static_cast<uint32_t>(ids.size()));
+				ids.push_back(id);
+			}
+
+			void Remove(UUID id)
+			{
+				if (const auto it = idToIdx.find(id); it != idToIdx.end())
+				{
+					ids[it->second] = gInvalidID;
+					idToIdx.erase(it);
+
+					++tombstoneCount;
 				}
 			}
 
-		private:
+			[[nodiscard]] bool ShouldCompact() const
+			{
+				return tombstoneCount >= gNodeOrderMinTombstones && tombstoneCount * 4 >= ids.size();
+			}
+
+			// Replace ids with newIDs, which must not hold any tombstones
+			void Assign(std::vector<UUID> newIDs)
+			{
+				ids = std::move(newIDs);
+
+				idToIdx.clear();
+				idToIdx.reserve(ids.size());
+
+				for (uint32_t idx = 0; idx < ids.size(); ++idx)
+				{
+					idToIdx.emplace(ids[idx], idx);
+				}
+
+				tombstoneCount = 0;
+			}
+
+			// Remove tombstones while keeping order of remaining ids
+			void Compact()
+			{
+				ids.erase(std::remove(ids.begin(), ids.end(), gInvalidID), ids.end());
+
+				for (uint32_t idx = 0; idx < ids.size(); ++idx)
+				{
+					idToIdx[ids[idx]] = idx;
+				}
+
+				tombstoneCount = 0;
+			}
+
+			void Clear()
+			{
+				ids.clear();
+				idToIdx.clear();
+				tombstoneCount = 0;
+			}
+		};
+
+		/*
+		 * Entry in a flattened transform hierarchy
+		 */
+		struct TransformHierarchyEntry
+		{
+			Node* node = nullptr;
+			int32_t parentIdx = -1; // Index of parent entry, -1 if node does not have a parent of the same transform type
+
+			uint32_t localVersion = 0; // Version of node local transform that global transform was last calculated from
+			uint32_t parentGlobalVersion = 0; // Version of parent global transform that global transform was last calculated from
+			uint32_t globalVersion = 0; // Incremented each time global transform is recalculated
+			uint32_t indexedVersion = 0; // Version of 2d node global transform last written to spatial index
+		};
 
-			MappedVector<UUID, T> mNodes;
+		/*
+		 * Transform nodes flattened into an array of levels, parents are always on an earlier level than their children
+		 * Nodes added after the hierarchy was built are appended as extra levels, removed nodes are left as entries with no node
+		 */
+		struct TransformHierarchy
+		{
+			std::vector<TransformHierarchyEntry> entries;
+			std::vector<size_t> levelOffsets; // Start index of each level, followed by end index of last level
+			std::unordered_map<UUID, int32_t> idToEntryIdx;
+			uint32_t tombstoneCount = 0;
+			uint32_t appendCount = 0; // Number of times levels were appended since hierarchy was last built
+
+			[[nodiscard]] int32_t GetEntryIdx(UUID id) const
+			{
+				const auto it = idToEntryIdx.find(id);
+
+				return it != idToEntryIdx.end() ? it->second : -1;
+			}
+
+			void Remove(UUID id)
+			{
+				if (const auto it = idToEntryIdx.find(id); it != idToEntryIdx.end())
+				{
+					entries[it->second].node = nullptr;
+					idToEntryIdx.erase(it);
 
+					++tombstoneCount;
+				}
+			}
+
+			[[nodiscard]] bool ShouldRebuild() const
+			{
+				return appendCount >= gTransformHierarchyMaxAppends
+					|| (tombstoneCount >= gNodeOrderMinTombstones && tombstoneCount * 4 >= entries.size());
+			}
+
+			void Clear()
+			{
+				entries.clear();
+				levelOffsets.clear();
+				idToEntryIdx.clear();
+				tombstoneCount = 0;
+				appendCount = 0;
+			}
 		};
 
 		class SceneGraphSubsystem : public core::EngineSubsystem
@@ -168,6 +389,12 @@ namespace puffin
 
 			Node* AddNode(uint32_t typeID, const std::string& name, UUID id);
 			Node* AddChildNode(uint32_t typeID, const std::string& name, UUID id, UUID parentID);
+
+			/*
+			 * Create node of type which is prepared but never initialized or added to scene graph,
+			 * used as a template to copy node data from, see Node::CopyFrom
+			 */
+			[[nodiscard]] std::unique_ptr<Node> CreateDetachedNode(uint32_t typeID) const;
 			[[nodiscard]] Node* GetNode(const UUID& id) const;
 			bool IsValidNode(UUID id) const;
 
@@ -176,14 +403,49 @@ namespace puffin
 			[[nodiscard]] TransformComponent3D& GetNodeGlobalTransform3D(const UUID& id);
 
 			// PUFFIN_TODO - Remove when refactoring 3d nodes to remove reliance on components
+			// Mark node local transform as changed, node and its children will have their global transforms updated next frame
 			void NotifyTransformChanged(UUID id);
 
 			// Queue a node for destruction, will also destroy all child nodes
 			void QueueDestroyNode(const UUID& id);
 
+			// Queue multiple nodes for destruction, will also destroy all child nodes
+			void QueueDestroyNodes(const std::vector<UUID>& ids);
+
+			// Move node to be a child of parentID, or a root node if parentID is invalid
+			void ReparentNode(UUID id, UUID parentID);
+
+			/*
+			 * Command buffer for calling enkiTS thread, nodes updated from worker threads must record
+			 * structural changes here instead of modifying the scene graph directly
+			 * Commands from all threads are applied at start of next scene graph update, ordered by source node id,
+			 * nodes are all added before any other command is applied so commands can target nodes added by other sources
+			 */
+			SceneGraphCommandBuffer& GetCommandBuffer();
+
+			// Ids of all nodes in execution order (parents before children), may contain gInvalidID for removed nodes
 			[[nodiscard]] const std::vector<UUID>& GetNodeIDs() const;
 			[[nodiscard]] const std::vector<UUID>& GetRootNodeIDs() const;
 
+			// Ids of nodes whose type is updated in hierarchy order, in execution order, may contain gInvalidID for removed nodes
+			[[nodiscard]] const std::vector<UUID>& GetHierarchyUpdateNodeIDs() const;
+
+			/*
+			 * Rebuild node order lists & transform hierarchies from scratch next update, instead of appending new nodes to them,
+			 * use after bulk loading a scene so nodes are stored in depth first order
+			 */
+			void QueueNodeOrderRebuild();
+
+			// Reserve storage for nodes about to be added in bulk, typeCounts is a list of (node type id, count) pairs
+			void ReserveNodes(const std::vector<std::pair<uint32_t, uint32_t>>& typeCounts);
+
+			// Pools of node types updated in pool order (serial/parallel), in registration order
+			[[nodiscard]] const std::vector<INodePool*>& GetBucketedNodePools() const;
+
+			// Spatial index of transform nodes, updated from global transforms at end of each scene graph update
+			[[nodiscard]] SpatialIndex& GetSpatialIndex();
+			[[nodiscard]] const SpatialIndex& GetSpatialIndex() const;
+
 			template<typename T>
 			void RegisterNodeType()
 			{
@@ -192,23 +454,12 @@ namespace puffin
 
 				if (mNodePools.find(typeID) == mNodePools.end())
 				{
-					mNodePools.emplace(typeID, static_cast<INodePool*>(new NodePool<T>()));
-				}
-			}
+					auto* pool = static_cast<INodePool*>(new NodePool<T>());
 
-			template<typename T>
-			void SetDefaultNodePoolSize(uint32_t defaultPoolSize)
-			{
-				auto type = entt::resolve<T>();
-				const auto& typeID = type.id();
+					mNodePools.emplace(typeID, pool);
 
-				if (mNodePoolDefaultSizes.find(typeID) == mNodePoolDefaultSizes.end())
-				{
-					mNodePoolDefaultSizes.emplace(typeID, defaultPoolSize);
-				}
-				else
-				{
-					mNodePoolDefaultSizes[typeID] = defaultPoolSize;
+					if (pool->GetUpdateMode() != NodeUpdateMode::Hierarchy)
+						mBucketedNodePools.push_back(pool);
 				}
 			}
 
@@ -236,6 +487,39 @@ namespace puffin
 				return AddNodeInternal<T>(name, id, parent_id);
 			}
 
+			/*
+			 * Add count nodes of type T as children of parentID (or as root nodes if parentID is invalid),
+			 * storage is reserved once up front and initFn(T* node, uint32_t index) is called for each new node
+			 */
+			template<typename T, typename InitFn>
+			void AddNodes(uint32_t count, UUID parentID, const InitFn& initFn, const std::string& name = "")
+			{
+				if (count == 0)
+					return;
+
+				auto type = entt::resolve<T>();
+				const auto& typeID = type.id();
+
+				if (mNodePools.find(typeID) == mNodePools.end())
+				{
+					RegisterNodeType<T>();
+				}
+
+				auto* pool = GetPool<T>();
+				pool->Reserve(count);
+
+				Node* parent = PrepareAddNodes(count, parentID);
+
+				for (uint32_t i = 0; i < count; ++i)
+				{
+					Node* node = pool->AddNode(m_engine, name);
+
+					AddNodeInternalBase(node, typeID, parent);
+
+					initFn(static_cast<T*>(node), i);
+				}
+			}
+
 			template<typename T>
 			T* GetNode(UUID id) const
 			{
@@ -260,18 +544,66 @@ namespace puffin
 
 		private:
 
+			struct QueuedTransformNode
+			{
+				UUID id;
+				int32_t parentIdx2D;
+				int32_t parentIdx3D;
+			};
+
+			// Subtree waiting to be spliced into node order, ids are a range of a shared id list
+			struct PendingSubtree
+			{
+				UUID nextID; // Node subtree is inserted before, see FindNextSubtreeID
+				size_t start;
+				size_t end;
+			};
+
 			void UpdateSceneGraph();
+			void ApplyCommandBuffers();
 			void DestroyNode(UUID id);
-			void AddIDAndChildIDs(UUID id, std::vector<UUID>& nodeIDs);
+
+			void RebuildNodeOrder();
+			void InsertPendingSubtrees();
+			void AddIDAndChildIDs(UUID id);
+
+			// Append ids of node & its descendants depth first, ids of nodes updated in hierarchy order are also added to hierarchyUpdateIDs
+			void CollectSubtreeIDs(UUID id, std::vector<UUID>& ids, std::unordered_set<UUID>& hierarchyUpdateIDs) const;
+
+			/*
+			 * First node following subtree rooted at id depth first, which is either in node order or the root of another
+			 * new subtree, gInvalidID if subtree belongs at end of node order
+			 */
+			[[nodiscard]] UUID FindNextSubtreeID(UUID id, const std::unordered_set<UUID>& subtreeRootIDs) const;
+			void RemoveFromNodeOrder(UUID id);
+			void RemoveSubtreeFromNodeOrder(UUID id);
+
+			void BuildTransformHierarchies();
+
+			// Walk nodes breadth first from currentLevel, appending each level to the end of transform hierarchies
+			void AppendTransformHierarchyLevels(std::vector<QueuedTransformNode>& currentLevel);
 
 			void UpdateGlobalTransforms();
-			void UpdateGlobalTransform(UUID id);
+			void UpdateGlobalTransforms2D();
+			void UpdateGlobalTransforms3D();
+
+			/*
+			 * Update hierarchy a level at a time, updateFunc is called with entry ranges [start, end) within a single level,
+			 * levels with enough entries are split into ranges across enkiTS worker threads
+			 */
+			template<typename UpdateFunc>
+			void UpdateTransformHierarchy(const TransformHierarchy& hierarchy, const UpdateFunc& updateFunc);
 
 			static void LimitAngleTo180Degrees(float& angle);
 			static void ApplyLocalToGlobalTransform3D(const TransformComponent3D& localTransform, const TransformComponent3D& globalTransform, TransformComponent3D&
 				updatedTransform);
 
 			void AddNodeInternalBase(Node* node, uint32_t typeID, UUID id = gInvalidID, UUID parentID = gInvalidID);
+			void AddNodeInternalBase(Node* node, uint32_t typeID, Node* parent);
+
+			// Reserve scene graph & registry storage for count new nodes, returns parent node or nullptr if parentID is invalid
+			Node* PrepareAddNodes(uint32_t count, UUID parentID);
+			void ReserveNodeStorage(uint32_t count);
 
 			template<typename T>
 			T* AddNodeInternal(const std::string& name, UUID id = gInvalidID, UUID parent_id = gInvalidID)
@@ -354,21 +686,27 @@ namespace puffin
 		private:
 
 			std::unordered_map<UUID, uint32_t> mIDToTypeID;
-			std::vector<UUID> mNodeIDs; // Vector of node id's, sorted by order methods are executed in
+			NodeOrderList mNodeOrder; // Node id's, sorted by order methods are executed in
+			NodeOrderList mHierarchyUpdateOrder; // Subset of mNodeOrder whose type is updated in hierarchy order
 			std::vector<UUID> mRootNodeIDs; // Vector of nodes at root of scene graph
+			std::vector<UUID> mPendingSubtreeIDs; // Nodes added/reparented since last update, spliced into node order along with their children
+			bool mNodeOrderRebuildQueued = false;
+
+			TransformHierarchy mTransformHierarchy2D;
+			TransformHierarchy mTransformHierarchy3D;
+			std::vector<uint8_t> mTransform3DUpdated; // Whether each 3d hierarchy entry was updated in last transform update
 
-			std::unordered_set<UUID> mNodeTransformsNeedUpdated; // Set of nodes which need their transforms updated
-			std::vector<UUID> mNodeTransformsNeedUpdatedVector; // Set of nodes which need their transforms updated
-			std::unordered_set<UUID> mNodeTransformsUpToDate; // Set of nodes which global transforms are up to date
+			SpatialIndex mSpatialIndex;
 
 			std::unordered_set<UUID> mNodesToDestroy;
 
-			MappedVector<UUID, TransformComponent3D> mGlobalTransform3Ds;
+			std::shared_ptr<enki::TaskScheduler> mTaskScheduler = nullptr;
+			std::vector<SceneGraphCommandBuffer> mCommandBuffers; // One command buffer per enkiTS thread, indexed by thread number
 
-			bool mSceneGraphUpdated = false;
+			MappedVector<UUID, TransformComponent3D> mGlobalTransform3Ds;
 
 			std::unordered_map<uint32_t, INodePool*> mNodePools;
-			std::unordered_map<uint32_t, uint32_t> mNodePoolDefaultSizes;
+			std::vector<INodePool*> mBucketedNodePools; // Pools updated in pool order, stored in registration order so type ordering is deterministic
 
 		};
 	}
@@ -1,10 +1,185 @@
 #include "scene/scene_serialization_subsystem.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <system_error>
+
+#include "core/enkits_subsystem.h"
+#include "node/transform_2d_node.h"
+#include "node/transform_3d_node.h"
 #include "resource/resource_manager.h"
+#include "scene/scene_writer.h"
 #include "serialization/component_serialization.h"
 
 namespace puffin::scene
 {
+	namespace
+	{
+		// Get table stored in binary scene file, returns nullptr if range lies outside of file or isn't a whole, aligned table of T
+		template<typename T>
+		const T* GetBinaryTable(const utility::MappedFile& file, const SceneBinaryRange& range, size_t& count)
+		{
+			count = 0;
+
+			if (range.offset > file.Size() || range.size > file.Size() - range.offset)
+				return nullptr;
+
+			if (range.offset % alignof(T) != 0 || range.size % sizeof(T) != 0)
+				return nullptr;
+
+			count = range.size / sizeof(T);
+
+			return reinterpret_cast<const T*>(file.Data() + range.offset);
+		}
+
+		// Decode msgpack blob, empty blobs decode to null, returns false if blob lies outside of file or isn't valid msgpack
+		bool ReadBinaryBlob(const utility::MappedFile& file, const SceneBinaryRange& range, nlohmann::json& json)
+		{
+			json = nlohmann::json {};
+
+			if (range.size == 0)
+				return true;
+
+			if (range.offset > file.Size() || range.size > file.Size() - range.offset)
+				return false;
+
+			const uint8_t* blob = file.Data() + range.offset;
+
+			json = nlohmann::json::from_msgpack(blob, blob + range.size, true, false);
+
+			if (json.is_discarded())
+			{
+				json = nlohmann::json {};
+				return false;
+			}
+
+			return true;
+		}
+
+		// Size & write time of scene file, which a delta records so it is only applied to the file it was written against
+		bool GetSceneFileStamp(const fs::path& path, uint64_t& size, int64_t& writeTime)
+		{
+			std::error_code error;
+
+			size = fs::file_size(path, error);
+			if (error)
+				return false;
+
+			writeTime = static_cast<int64_t>(fs::last_write_time(path, error).time_since_epoch().count());
+
+			return !error;
+		}
+
+		// Registered component types sorted by type string, so components are always written in same order
+		std::vector<const serialization::ComponentTypeFuncs*> GetSortedComponentTypes()
+		{
+			std::vector<const serialization::ComponentTypeFuncs*> types;
+
+			for (const auto& funcs : serialization::ComponentRegistry::Get()->GetTypeFuncs())
+			{
+				types.push_back(&funcs);
+			}
+
+			std::sort(types.begin(), types.end(), [](const auto* lhs, const auto* rhs)
+			{
+				return lhs->typeString < rhs->typeString;
+			});
+
+			return types;
+		}
+
+		/*
+		 * Decode batches in chunks spread across worker threads, prepareRange is called on the worker before a chunk
+		 * is decoded. Decoded batches are inserted afterwards with InsertBatch
+		 */
+		void DeserializeBatches(std::vector<serialization::ComponentBatch>& batches, enki::TaskScheduler* taskScheduler,
+			const std::function<void(size_t, size_t, size_t)>& prepareRange = nullptr)
+		{
+			struct BatchChunk
+			{
+				size_t batchIdx;
+				size_t begin;
+				size_t end;
+			};
+
+			const auto* componentRegistry = serialization::ComponentRegistry::Get();
+
+			std::vector<const serialization::ComponentTypeFuncs*> batchFuncs;
+			std::vector<BatchChunk> chunks;
+
+			batchFuncs.reserve(batches.size());
+
+			for (size_t batchIdx = 0; batchIdx < batches.size(); ++batchIdx)
+			{
+				auto& batch = batches[batchIdx];
+
+				batchFuncs.push_back(componentRegistry->GetTypeFuncs(batch.typeID));
+
+				if (!batchFuncs.back())
+					continue;
+
+				batchFuncs.back()->prepareBatch(batch);
+
+				for (size_t begin = 0; begin < batch.jsons.size(); begin += gSceneLoadChunkSize)
+				{
+					chunks.push_back({ batchIdx, begin, std::min(begin + gSceneLoadChunkSize, batch.jsons.size()) });
+				}
+			}
+
+			auto deserializeChunk = [&](const BatchChunk& chunk)
+			{
+				if (prepareRange)
+					prepareRange(chunk.batchIdx, chunk.begin, chunk.end);
+
+				batchFuncs[chunk.batchIdx]->deserializeBatchRange(batches[chunk.batchIdx], chunk.begin, chunk.end);
+			};
+
+			if (taskScheduler && chunks.size() > 1)
+			{
+				enki::TaskSet task(static_cast<uint32_t>(chunks.size()), [&](enki::TaskSetPartition range, uint32_t threadIdx)
+				{
+					for (uint32_t idx = range.start; idx < range.end; ++idx)
+					{
+						deserializeChunk(chunks[idx]);
+					}
+				});
+
+				taskScheduler->AddTaskSetToPipe(&task);
+				taskScheduler->WaitforTask(&task);
+			}
+			else
+			{
+				for (const auto& chunk : chunks)
+				{
+					deserializeChunk(chunk);
+				}
+			}
+		}
+
+		// Registry isn't thread safe, so batches are inserted serially, batches without decoded components are skipped
+		void InsertBatch(entt::registry& registry, serialization::ComponentBatch& batch)
+		{
+			if (!batch.components)
+				return;
+
+			if (const auto* funcs = serialization::ComponentRegistry::Get()->GetTypeFuncs(batch.typeID))
+				funcs->insertBatchToRegistry(registry, batch);
+		}
+
+		void DeserializeAndInsertBatches(entt::registry& registry, std::vector<serialization::ComponentBatch>& batches,
+			enki::TaskScheduler* taskScheduler)
+		{
+			DeserializeBatches(batches, taskScheduler);
+
+			for (auto& batch : batches)
+			{
+				InsertBatch(registry, batch);
+			}
+		}
+	}
+
 	SceneData::SceneData(fs::path path)
 		: m_path(std::move(path))
 	{
@@ -15,105 +190,247 @@ namespace puffin::scene
 	{
 	}
 
-	void SceneData::Setup(ecs::EnTTSubsystem* enttSubsystem, scene::SceneGraphSubsystem* sceneGraph)
+	void SceneData::Setup(ecs::EnTTSubsystem* enttSubsystem, scene::SceneGraphSubsystem* sceneGraph, enki::TaskScheduler* taskScheduler)
 	{
-		auto registry = enttSubsystem->GetRegistry();
+		SetupEntities(enttSubsystem, taskScheduler);
+		SetupNodes(sceneGraph);
+	}
+
+	void SceneData::SetupEntities(ecs::EnTTSubsystem* enttSubsystem, enki::TaskScheduler* taskScheduler)
+	{
+		if (!m_binaryComponentSections.empty())
+		{
+			SetupEntitiesFromBinary(enttSubsystem, taskScheduler);
+			return;
+		}
+
+		const auto registry = enttSubsystem->GetRegistry();
+
+		// Add all entities first, so components can be added a whole type at a time
+		enttSubsystem->Reserve(m_entityIDs.size());
+
+		std::unordered_map<UUID, entt::entity> idToEntity;
+		idToEntity.reserve(m_entityIDs.size());
 
-		// Add entities & components to registry/subsystem
 		for (const auto& id : m_entityIDs)
 		{
-			auto entity = enttSubsystem->AddEntity(id);
+			idToEntity.emplace(id, enttSubsystem->AddEntity(id));
+		}
 
-			auto* componentRegistry = serialization::ComponentRegistry::Get();
-			for (const auto& typeID : componentRegistry->GetRegisteredTypesVector())
+		// One batch per component type present in scene, in registration order
+		std::vector<serialization::ComponentBatch> batches;
+
+		for (const auto& typeID : serialization::ComponentRegistry::Get()->GetRegisteredTypesVector())
+		{
+			const auto it = m_serializedComponentData.find(typeID);
+			if (it == m_serializedComponentData.end() || it->second.empty())
+				continue;
+
+			auto& batch = batches.emplace_back();
+			batch.typeID = typeID;
+			batch.entities.reserve(it->second.size());
+			batch.jsons.reserve(it->second.size());
+
+			for (const auto& [id, json] : it->second)
 			{
-				const auto& entityJsonMap = m_serializedComponentData.at(typeID);
-				if (entityJsonMap.find(id) != entityJsonMap.end())
-				{
-					auto type = entt::resolve(typeID);
-					const auto& json = entityJsonMap.at(id);
+				const auto entityIt = idToEntity.find(id);
+				if (entityIt == idToEntity.end())
+					continue;
 
-					if (auto deserializeToRegistryFunc = type.func(entt::hs("DeserializeToRegistry")))
-					{
-						deserializeToRegistryFunc.invoke({}, registry, entity, json);
-					}
-				}
+				batch.entities.push_back(entityIt->second);
+				batch.jsons.push_back(&json);
 			}
 		}
 
+		DeserializeAndInsertBatches(*registry, batches, taskScheduler);
+	}
+
+	void SceneData::SetupNodes(scene::SceneGraphSubsystem* sceneGraph)
+	{
+		// Reserve storage for every node type up front, so nodes are added in a single pass without pools reallocating
+		std::unordered_map<uint32_t, uint32_t> typeCounts;
+
+		for (const auto& [id, serializedNodeData] : m_serializedNodeData)
+		{
+			++typeCounts[serializedNodeData.typeID];
+		}
+
+		sceneGraph->ReserveNodes({ typeCounts.begin(), typeCounts.end() });
+
 		// Add nodes to scene graph
 		for (const auto& id : m_rootNodeIDs)
 		{
 			const auto& serializedNodeData = m_serializedNodeData.at(id);
 
-			auto type = entt::resolve(entt::hs(serializedNodeData.type.c_str()));
-			auto typeID = type.id();
-
-			auto node = sceneGraph->AddNode(typeID, serializedNodeData.name, serializedNodeData.id);
+			auto node = sceneGraph->AddNode(serializedNodeData.typeID, "", serializedNodeData.id);
+			node->SetName(serializedNodeData.nameID, serializedNodeData.nameSuffix);
 			node->Deserialize(serializedNodeData.json);
 
 			for (const auto& childID : serializedNodeData.childIDs)
 			{
 				const auto& serializedNodeDataChild = m_serializedNodeData.at(childID);
 
-				auto childType = entt::resolve(entt::hs(serializedNodeDataChild.type.c_str()));
-				auto childTypeID = childType.id();
-
-				auto childNode = sceneGraph->AddChildNode(childTypeID, serializedNodeDataChild.name, childID, id);
+				auto childNode = sceneGraph->AddChildNode(serializedNodeDataChild.typeID, "", childID, id);
+				childNode->SetName(serializedNodeDataChild.nameID, serializedNodeDataChild.nameSuffix);
 				childNode->Deserialize(serializedNodeDataChild.json);
 			}
 		}
+
+		sceneGraph->QueueNodeOrderRebuild();
 	}
 
 	void SceneData::UpdateData(const ::std::shared_ptr<core::Engine>& engine)
 	{
 		Clear();
 
-		auto enttSubsystem = engine->GetSubsystem<ecs::EnTTSubsystem>();
-		auto sceneGraph = engine->GetSubsystem<scene::SceneGraphSubsystem>();
+		UpdateEntityData(engine->GetSubsystem<ecs::EnTTSubsystem>());
+		UpdateNodeData(engine->GetSubsystem<scene::SceneGraphSubsystem>());
 
-		const auto registry = enttSubsystem->GetRegistry();
+		m_hasData = true;
+	}
 
-		for (const auto entity : registry->view<entt::entity>())
-		{
-			const auto& id = enttSubsystem->GetID(entity);
+	void SceneData::UpdateEntityData(ecs::EnTTSubsystem* enttSubsystem)
+	{
+		m_entityIDs.clear();
+		m_serializedComponentData.clear();
+		ClearBinaryComponents();
 
-			if (!enttSubsystem->ShouldEntityBeSerialized(id))
+		auto& registry = *enttSubsystem->GetRegistry();
+
+		// Entities which should be serialized, used to filter each component storage
+		entt::sparse_set serializedEntities;
+
+		for (const auto entity : registry.view<entt::entity>())
+		{
+			if (!enttSubsystem->ShouldEntityBeSerialized(entity))
 				continue;
 
-			m_entityIDs.push_back(id);
+			serializedEntities.push(entity);
+			m_entityIDs.push_back(enttSubsystem->GetID(entity));
+		}
+
+		// Each component storage is iterated once, rather than checking every type for every entity
+		for (const auto& funcs : serialization::ComponentRegistry::Get()->GetTypeFuncs())
+		{
+			auto& entityJsonMap = m_serializedComponentData[funcs.typeID];
+
+			funcs.serializeStorage(registry, &serializedEntities, [&](entt::entity entity, nlohmann::json&& json)
+			{
+				entityJsonMap.emplace(enttSubsystem->GetID(entity), std::move(json));
+			});
+		}
+	}
+
+	void SceneData::UpdateNodeData(scene::SceneGraphSubsystem* sceneGraph)
+	{
+		m_rootNodeIDs.clear();
+		m_nodeIDs.clear();
+		m_serializedNodeData.clear();
+
+		for (auto id : sceneGraph->GetRootNodeIDs())
+		{
+			m_rootNodeIDs.push_back(id);
+
+			SerializeNodeAndChildren(sceneGraph, id);
+		}
+	}
+
+	void SceneData::UpdateDirtyData(ecs::EnTTSubsystem* enttSubsystem, scene::SceneGraphSubsystem* sceneGraph)
+	{
+		assert(m_hasData && "SceneData::UpdateDirtyData - Scene holds no data to update, use UpdateData instead");
+
+		// Components have to be held as json so they can be replaced
+		ExpandBinaryComponents();
+
+		const auto& dirtyIDs = enttSubsystem->GetDirtyIDs();
+		const auto& removedIDs = enttSubsystem->GetRemovedIDs();
 
-			auto* componentRegistry = serialization::ComponentRegistry::Get();
-			for (const auto& typeID : componentRegistry->GetRegisteredTypesVector())
+		if (!dirtyIDs.empty() || !removedIDs.empty())
+		{
+			const auto& typeFuncs = serialization::ComponentRegistry::Get()->GetTypeFuncs();
+
+			std::unordered_set<UUID> entityIDs(m_entityIDs.begin(), m_entityIDs.end());
+
+			for (const auto& id : removedIDs)
 			{
-				if (m_serializedComponentData.find(typeID) == m_serializedComponentData.end())
+				if (entityIDs.erase(id) == 0)
+					continue;
+
+				for (auto& [typeID, entityJsonMap] : m_serializedComponentData)
 				{
-					m_serializedComponentData.emplace(typeID, EntityJsonMap());
+					entityJsonMap.erase(id);
 				}
 
-				auto type = entt::resolve(typeID);
+				m_deltaEntityIDs.erase(id);
+				m_deltaRemovedEntityIDs.insert(id);
+			}
 
-				auto hasComponentFunc = type.func(entt::hs("HasComponent"));
-				if (hasComponentFunc && hasComponentFunc.invoke({}, registry, entity).cast<bool>())
+			if (!removedIDs.empty())
+			{
+				m_entityIDs.erase(std::remove_if(m_entityIDs.begin(), m_entityIDs.end(), [&](const UUID& id)
 				{
-					if (auto serializefunc = type.func(entt::hs("SerializeFromRegistry")))
-					{
-						auto& entityJsonMap = m_serializedComponentData.at(typeID);
+					return entityIDs.find(id) == entityIDs.end();
+				}), m_entityIDs.end());
+			}
 
-						entityJsonMap.emplace(id, serializefunc.invoke({}, registry, entity).cast<nlohmann::json>());
-					}
+			auto& registry = *enttSubsystem->GetRegistry();
+
+			// Every component of a dirty entity is replaced, so components removed from it are dropped too
+			for (const auto& id : dirtyIDs)
+			{
+				if (!enttSubsystem->IsEntityValid(id))
+					continue;
+
+				const auto entity = enttSubsystem->GetEntity(id);
+
+				if (entityIDs.insert(id).second)
+					m_entityIDs.push_back(id);
+
+				for (const auto& funcs : typeFuncs)
+				{
+					auto& entityJsonMap = m_serializedComponentData[funcs.typeID];
+
+					if (funcs.hasComponent(registry, entity))
+						entityJsonMap[id] = funcs.serializeFromRegistry(registry, entity);
+					else
+						entityJsonMap.erase(id);
 				}
+
+				m_deltaEntityIDs.insert(id);
+				m_deltaRemovedEntityIDs.erase(id);
 			}
 		}
 
+		// Scene graph is walked in full, but only nodes which changed are reserialized
+		m_rootNodeIDs.clear();
+		m_nodeIDs.clear();
+
 		for (auto id : sceneGraph->GetRootNodeIDs())
 		{
 			m_rootNodeIDs.push_back(id);
 
-			SerializeNodeAndChildren(sceneGraph, id);
+			UpdateDirtyNodeAndChildren(sceneGraph, id, dirtyIDs);
 		}
 
-		m_hasData = true;
+		// Any node which wasn't visited has been destroyed
+		if (m_serializedNodeData.size() != m_nodeIDs.size())
+		{
+			const std::unordered_set<UUID> nodeIDs(m_nodeIDs.begin(), m_nodeIDs.end());
+
+			for (auto it = m_serializedNodeData.begin(); it != m_serializedNodeData.end();)
+			{
+				if (nodeIDs.find(it->first) != nodeIDs.end())
+				{
+					++it;
+					continue;
+				}
+
+				m_deltaNodeIDs.erase(it->first);
+				m_deltaRemovedNodeIDs.insert(it->first);
+
+				it = m_serializedNodeData.erase(it);
+			}
+		}
 	}
 
 	void SceneData::Clear()
@@ -123,217 +440,959 @@ namespace puffin::scene
 		m_rootNodeIDs.clear();
 		m_nodeIDs.clear();
 		m_serializedNodeData.clear();
+		ClearBinaryComponents();
 
 		m_hasData = false;
 	}
 
 	void SceneData::Save()
 	{
-		// Serialize scene data to json file
-		nlohmann::json sceneJson;
+		// Components loaded from a binary file are still in mapped file, which has to be closed before file is overwritten
+		ExpandBinaryComponents();
 
-		// Serialize scene info
-		sceneJson["sceneInfo"] = SerializeSceneInfo(m_sceneInfo);
+		SceneWriter writer(m_path, m_fileFormat);
 
-		// Serialize entities & components
-		nlohmann::json componentsJson;
-		componentsJson["entityIDs"] = m_entityIDs;
-		
-		for (const auto& [typeID, entityJsonMap] : m_serializedComponentData)
+		if (!writer.Begin())
+		{
+			std::cout << "SceneData::Save - Failed to open " << m_path.string() << " for writing" << std::endl;
+			return;
+		}
+
+		writer.BeginComponents(m_entityIDs);
+
+		for (const auto* funcs : GetSortedComponentTypes())
 		{
-			if (!entityJsonMap.empty())
+			const auto it = m_serializedComponentData.find(funcs->typeID);
+			if (it == m_serializedComponentData.end())
+				continue;
+
+			writer.BeginComponentType(funcs->typeID, funcs->typeString);
+
+			for (const auto& [id, json] : it->second)
 			{
-				auto type = entt::resolve(typeID);
+				writer.WriteComponent(id, json);
+			}
+
+			writer.EndComponentType();
+		}
+
+		writer.EndComponents();
+
+		WriteNodes(writer);
+
+		writer.WriteSceneInfo(m_sceneInfo);
+		writer.End();
 
-				nlohmann::json componentJson;
+		// Scene file now holds every change, so delta is no longer needed
+		ClearDelta();
+		RemoveDeltaFiles();
+	}
+
+	void SceneData::Save(const ecs::RegistrySnapshot& snapshot, const SceneData& nodeData) const
+	{
+		SceneWriter writer(m_path, m_fileFormat);
+
+		if (!writer.Begin())
+		{
+			std::cout << "SceneData::Save - Failed to open " << m_path.string() << " for writing" << std::endl;
+			return;
+		}
+
+		auto& registry = *snapshot.GetRegistry();
+		const auto& ids = snapshot.GetIDs();
+		const auto& entities = snapshot.GetEntities();
 
-				int i = 0;
-				for (const auto& [id, json] : entityJsonMap)
+		// Id of each snapshot entity, indexed by entity
+		std::vector<UUID> entityToID;
+
+		for (size_t idx = 0; idx < entities.size(); ++idx)
+		{
+			const auto entityIdx = static_cast<size_t>(entt::to_entity(entities[idx]));
+
+			if (entityIdx >= entityToID.size())
+				entityToID.resize(entityIdx + 1, gInvalidID);
+
+			entityToID[entityIdx] = ids[idx];
+		}
+
+		writer.BeginComponents(ids);
+
+		// Components are serialized one at a time as they are written, no json is kept for them
+		for (const auto* funcs : GetSortedComponentTypes())
+		{
+			writer.BeginComponentType(funcs->typeID, funcs->typeString);
+
+			// Raw components are copied from snapshot storage as they are, json is only used for fallback blobs
+			if (funcs->rawSize != 0)
+			{
+				funcs->serializeStorageRaw(registry, nullptr, [&](entt::entity entity, const void* rawData, nlohmann::json&& json)
+				{
+					writer.WriteComponent(entityToID[static_cast<size_t>(entt::to_entity(entity))], rawData, json);
+				});
+			}
+			else
+			{
+				funcs->serializeStorage(registry, nullptr, [&](entt::entity entity, nlohmann::json&& json)
 				{
-					componentJson[i]["id"] = id;
-					componentJson[i]["data"] = json;
+					writer.WriteComponent(entityToID[static_cast<size_t>(entt::to_entity(entity))], json);
+				});
+			}
 
-					++i;
-				}
+			writer.EndComponentType();
+		}
+
+		writer.EndComponents();
+
+		nodeData.WriteNodes(writer);
+
+		writer.WriteSceneInfo(m_sceneInfo);
+		writer.End();
+
+		RemoveDeltaFiles();
+	}
+
+	void SceneData::SaveDelta() const
+	{
+		if (!WriteDeltaFile(GetDeltaPath()))
+			return;
+
+		// Recovery file may hold older copies of changes now in delta
+		std::error_code error;
+		fs::remove(GetRecoveryPath(), error);
+	}
+
+	void SceneData::SaveRecovery() const
+	{
+		WriteDeltaFile(GetRecoveryPath());
+	}
+
+	bool SceneData::WriteDeltaFile(const fs::path& deltaPath) const
+	{
+		uint64_t baseSize = 0;
+		int64_t baseTime = 0;
+
+		if (!GetSceneFileStamp(m_path, baseSize, baseTime))
+		{
+			std::cout << "SceneData::WriteDeltaFile - Scene file " << m_path.string() << " has to be saved in full before a delta can be saved" << std::endl;
+			return false;
+		}
+
+		nlohmann::json deltaJson;
+		deltaJson["version"] = gSceneDeltaVersion;
+		deltaJson["baseSize"] = baseSize;
+		deltaJson["baseTime"] = baseTime;
+
+		// Entities
+		deltaJson["removedEntityIDs"] = std::vector<UUID>(m_deltaRemovedEntityIDs.begin(), m_deltaRemovedEntityIDs.end());
+
+		auto& entitiesJson = deltaJson["entities"] = nlohmann::json::array();
+
+		const auto& typeFuncs = serialization::ComponentRegistry::Get()->GetTypeFuncs();
+
+		for (const auto& id : m_deltaEntityIDs)
+		{
+			nlohmann::json componentsJson = nlohmann::json::object();
+
+			for (const auto& funcs : typeFuncs)
+			{
+				const auto it = m_serializedComponentData.find(funcs.typeID);
+				if (it == m_serializedComponentData.end())
+					continue;
+
+				if (const auto componentIt = it->second.find(id); componentIt != it->second.end())
+					componentsJson[std::string(funcs.typeString)] = componentIt->second;
+			}
+
+			entitiesJson.push_back({ { "id", id }, { "components", std::move(componentsJson) } });
+		}
+
+		// Nodes
+		deltaJson["removedNodeIDs"] = std::vector<UUID>(m_deltaRemovedNodeIDs.begin(), m_deltaRemovedNodeIDs.end());
+
+		auto& nodesJson = deltaJson["nodes"] = nlohmann::json::array();
+
+		for (const auto& id : m_deltaNodeIDs)
+		{
+			const auto& serializedNodeData = m_serializedNodeData.at(id);
+
+			nlohmann::json nodeJson;
+			nodeJson["id"] = id;
+			nodeJson["name"] = Node::BuildName(serializedNodeData.nameID, serializedNodeData.nameSuffix);
+			nodeJson["type"] = ResolveString(serializedNodeData.typeStringID);
+
+			if (!serializedNodeData.childIDs.empty())
+				nodeJson["childIDs"] = serializedNodeData.childIDs;
+
+			if (!serializedNodeData.json.empty())
+				nodeJson["data"] = serializedNodeData.json;
+
+			nodesJson.push_back(std::move(nodeJson));
+		}
+
+		deltaJson["rootNodeIDs"] = m_rootNodeIDs;
+
+		// Written to a temporary file which replaces delta once complete, so a failed save never leaves a partial delta
+		auto tempPath = deltaPath;
+		tempPath += ".tmp";
+
+		{
+			std::ofstream os(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+
+			if (!os.is_open())
+			{
+				std::cout << "SceneData::WriteDeltaFile - Failed to open " << tempPath.string() << " for writing" << std::endl;
+				return false;
+			}
+
+			const auto msgpack = nlohmann::json::to_msgpack(deltaJson);
+
+			os.write(reinterpret_cast<const char*>(msgpack.data()), static_cast<std::streamsize>(msgpack.size()));
+		}
+
+		std::error_code error;
+		fs::rename(tempPath, deltaPath, error);
+
+		if (error)
+		{
+			std::cout << "SceneData::WriteDeltaFile - Failed to replace " << deltaPath.string() << ": " << error.message() << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	void SceneData::ClearDelta()
+	{
+		m_deltaEntityIDs.clear();
+		m_deltaRemovedEntityIDs.clear();
+		m_deltaNodeIDs.clear();
+		m_deltaRemovedNodeIDs.clear();
+	}
+
+	size_t SceneData::GetDeltaCount() const
+	{
+		return m_deltaEntityIDs.size() + m_deltaRemovedEntityIDs.size() + m_deltaNodeIDs.size() + m_deltaRemovedNodeIDs.size();
+	}
+
+	bool SceneData::ShouldCompactDelta() const
+	{
+		const size_t deltaCount = GetDeltaCount();
+		const size_t sceneCount = m_entityIDs.size() + m_nodeIDs.size();
+
+		return deltaCount >= gSceneDeltaCompactMinCount && static_cast<double>(deltaCount) >= static_cast<double>(sceneCount) * gSceneDeltaCompactRatio;
+	}
+
+	fs::path SceneData::GetDeltaPath() const
+	{
+		auto deltaPath = m_path;
+		deltaPath += ".delta";
+
+		return deltaPath;
+	}
+
+	fs::path SceneData::GetRecoveryPath() const
+	{
+		auto recoveryPath = m_path;
+		recoveryPath += ".recovery";
+
+		return recoveryPath;
+	}
+
+	void SceneData::RemoveDeltaFiles() const
+	{
+		std::error_code error;
+		fs::remove(GetDeltaPath(), error);
+		fs::remove(GetRecoveryPath(), error);
+	}
+
+	void SceneData::WriteNodes(SceneWriter& writer) const
+	{
+		writer.BeginNodes(m_nodeIDs);
+
+		for (const auto& id : m_nodeIDs)
+		{
+			const auto& serializedNodeData = m_serializedNodeData.at(id);
+
+			writer.WriteNode(id, serializedNodeData.nameID, serializedNodeData.nameSuffix, serializedNodeData.typeStringID,
+				serializedNodeData.typeID, serializedNodeData.childIDs, serializedNodeData.json);
+		}
+
+		writer.EndNodes(m_rootNodeIDs);
+	}
+
+	void SceneData::Load(const bool forceLoad)
+	{
+		if (m_hasData && !forceLoad)
+			return;
+
+		if (!fs::exists(m_path))
+			return;
+
+		Clear();
+
+		utility::MappedFile file(m_path);
+
+		if (!file.IsOpen())
+			return;
+
+		if (file.Size() >= sizeof(SceneBinaryHeader) && reinterpret_cast<const SceneBinaryHeader*>(file.Data())->magic == gSceneBinaryMagic)
+		{
+			m_mappedFile = std::move(file);
+
+			LoadBinary();
+		}
+		else
+		{
+			LoadJson(nlohmann::json::parse(file.Data(), file.Data() + file.Size()));
+		}
+
+		ClearDelta();
+
+		if (m_hasData)
+			LoadDelta();
+	}
+
+	void SceneData::LoadJson(const nlohmann::json& sceneJson)
+	{
+		m_fileFormat = SceneFileFormat::Json;
 
-				if (auto getTypeStringFunc = type.func(entt::hs("GetTypeString")))
+		m_sceneInfo = DeserializeSceneInfo(sceneJson.at("sceneInfo"));
+
+		// Deserialize Components
+
+		const nlohmann::json& componentsJson = sceneJson.at("components");
+		m_entityIDs = componentsJson.at("entityIDs").get<std::vector<UUID>>();
+
+		for (const auto& funcs : serialization::ComponentRegistry::Get()->GetTypeFuncs())
+		{
+			auto& entityJsonMap = m_serializedComponentData[funcs.typeID];
+
+			if (componentsJson.contains(funcs.typeString))
+			{
+				const json& componentJson = componentsJson.at(funcs.typeString);
+				for (const auto& archiveJson : componentJson)
 				{
-					auto typeString = getTypeStringFunc.invoke({}).cast<std::string_view>();
+					entityJsonMap.emplace(archiveJson["id"], archiveJson["data"]);
+				}
+			}
+		}
+
+		// Deserialize Nodes
+		const nlohmann::json& nodesJson = sceneJson.at("nodes");
+
+		m_rootNodeIDs = nodesJson.at("rootNodeIDs").get<std::vector<UUID>>();
+
+		// Type ids are resolved once per type rather than once per node
+		std::unordered_map<StringID, uint32_t> typeStringIDToTypeID;
+
+		for (const auto& nodeJson : nodesJson.at("nodes"))
+		{
+			m_nodeIDs.push_back(nodeJson.at("id").get<UUID>());
+
+			LoadNodeJson(nodeJson, typeStringIDToTypeID);
+		}
+
+		m_hasData = true;
+	}
+
+	void SceneData::LoadNodeJson(const nlohmann::json& nodeJson, std::unordered_map<StringID, uint32_t>& typeStringIDToTypeID)
+	{
+		const UUID& id = nodeJson.at("id");
+
+		// Node may already exist when it is replaced by a delta
+		auto& serializedNodeData = m_serializedNodeData[id];
+		serializedNodeData = SerializedNodeData{};
+		serializedNodeData.id = id;
+		Node::SplitName(nodeJson.at("name").get<std::string>(), serializedNodeData.nameID, serializedNodeData.nameSuffix);
+		serializedNodeData.typeStringID = InternString(nodeJson.at("type").get<std::string>());
+
+		auto typeIt = typeStringIDToTypeID.find(serializedNodeData.typeStringID);
+		if (typeIt == typeStringIDToTypeID.end())
+		{
+			const auto& typeString = ResolveString(serializedNodeData.typeStringID);
+
+			typeIt = typeStringIDToTypeID.emplace(serializedNodeData.typeStringID, entt::resolve(entt::hs(typeString.c_str())).id()).first;
+		}
+
+		serializedNodeData.typeID = typeIt->second;
+		
+		if (nodeJson.contains("childIDs"))
+		{
+			serializedNodeData.childIDs = nodeJson.at("childIDs").get<std::vector<UUID>>();
+		}
+
+		if (nodeJson.contains("data"))
+		{
+			serializedNodeData.json = nodeJson.at("data");
+		}
+	}
+
+	void SceneData::LoadAndInit(ecs::EnTTSubsystem* enttSubsystem, scene::SceneGraphSubsystem* sceneGraph)
+	{
+		Load();
+		Setup(enttSubsystem, sceneGraph);
+	}
+
+	void SceneData::SetPath(const fs::path& path)
+	{
+		m_path = path;
+	}
+
+	const fs::path& SceneData::GetPath()
+	{
+		return m_path;
+	}
+
+	const SceneInfo& SceneData::GetSceneInfo() const
+	{
+		return m_sceneInfo;
+	}
+
+	bool SceneData::HasData() const
+	{
+		return m_hasData;
+	}
+
+	void SceneData::SetFileFormat(SceneFileFormat fileFormat)
+	{
+		m_fileFormat = fileFormat;
+	}
+
+	SceneFileFormat SceneData::GetFileFormat() const
+	{
+		return m_fileFormat;
+	}
+
+	void SceneData::LoadBinary()
+	{
+		m_fileFormat = SceneFileFormat::Binary;
+
+		const auto& header = *reinterpret_cast<const SceneBinaryHeader*>(m_mappedFile.Data());
+
+		if (header.version != gSceneBinaryVersion || header.fileSize != m_mappedFile.Size())
+		{
+			std::cout << "SceneData::LoadBinary - Unsupported or truncated binary scene: " << m_path << std::endl;
+
+			m_mappedFile.Close();
+			return;
+		}
+
+		// Tables & blobs scene can't be read without, scene is left without data (& file unmapped) when one of them is corrupt
+		auto failLoad = [&](const char* what)
+		{
+			std::cout << "SceneData::LoadBinary - Corrupt " << what << " in binary scene: " << m_path.string() << std::endl;
+
+			Clear();
+		};
+
+		// Strings
+		size_t stringCount = 0;
+		const auto* stringRanges = GetBinaryTable<SceneBinaryRange>(m_mappedFile, header.strings, stringCount);
+
+		if (!stringRanges && header.strings.size != 0)
+			return failLoad("string table");
+
+		std::vector<StringID> stringIDs;
+		stringIDs.reserve(stringCount);
+
+		for (size_t idx = 0; idx < stringCount; ++idx)
+		{
+			size_t length = 0;
+			const auto* chars = GetBinaryTable<char>(m_mappedFile, stringRanges[idx], length);
+
+			stringIDs.push_back(chars ? InternString(std::string_view(chars, length)) : gEmptyStringID);
+		}
+
+		auto getString = [&](uint32_t idx)
+		{
+			return idx < stringIDs.size() ? stringIDs[idx] : gEmptyStringID;
+		};
+
+		nlohmann::json sceneInfoJson;
+		if (!ReadBinaryBlob(m_mappedFile, header.sceneInfo, sceneInfoJson))
+			return failLoad("scene info");
+
+		m_sceneInfo = DeserializeSceneInfo(sceneInfoJson);
+
+		// Entities
+		size_t entityCount = 0;
+		const auto* entityIDs = GetBinaryTable<UUID>(m_mappedFile, header.entityIDs, entityCount);
+
+		if (!entityIDs && header.entityIDs.size != 0)
+			return failLoad("entity table");
+
+		m_entityIDs.assign(entityIDs, entityIDs + entityCount);
+
+		// Components are left in file, and inserted straight into registry during setup
+		size_t sectionCount = 0;
+		const auto* sections = GetBinaryTable<SceneBinaryComponentSection>(m_mappedFile, header.components, sectionCount);
+
+		if (!sections && header.components.size != 0)
+			return failLoad("component table");
+
+		m_binaryComponentSections.reserve(sectionCount);
+
+		for (size_t idx = 0; idx < sectionCount; ++idx)
+		{
+			const auto& section = sections[idx];
+
+			const auto* funcs = serialization::ComponentRegistry::Get()->GetTypeFuncs(section.typeID);
+			if (!funcs)
+				continue;
+
+			size_t indexCount = 0;
+			size_t dataSize = 0;
+
+			BinaryComponentSection binarySection;
+			binarySection.typeID = section.typeID;
+			binarySection.rawSize = section.rawSize;
+			binarySection.count = section.count;
+			binarySection.entityIndices = GetBinaryTable<uint32_t>(m_mappedFile, section.entityIndices, indexCount);
+
+			// Raw components are inserted straight from file, blob ranges are read as a table so they are checked to be aligned
+			auto readData = [&](const SceneBinaryRange& range, uint32_t rawSize, size_t& dataSize) -> const uint8_t*
+			{
+				if (rawSize != 0)
+					return GetBinaryTable<uint8_t>(m_mappedFile, range, dataSize);
+
+				size_t rangeCount = 0;
+				const auto* ranges = GetBinaryTable<SceneBinaryRange>(m_mappedFile, range, rangeCount);
+
+				dataSize = rangeCount * sizeof(SceneBinaryRange);
+
+				return reinterpret_cast<const uint8_t*>(ranges);
+			};
+
+			binarySection.data = readData(section.data, section.rawSize, dataSize);
+
+			// Raw components are only read as is when their layout still matches & they lie within file, otherwise their blobs are decoded instead
+			const bool layoutChanged = section.rawSize != 0 && (funcs->rawSize != section.rawSize || funcs->rawLayoutHash != section.rawLayoutHash);
+			const bool rawCorrupt = section.rawSize != 0 && (!binarySection.data || dataSize != static_cast<size_t>(section.rawSize) * section.count);
+
+			if (layoutChanged || rawCorrupt)
+			{
+				std::cout << "SceneData::LoadBinary - " << (layoutChanged ? "Layout" : "Raw data") << " of component " << ResolveString(getString(section.typeStringIdx))
+					<< (layoutChanged ? " has changed since scene was saved" : " is corrupt") << ", component will be loaded from its serialized copy" << std::endl;
+
+				binarySection.rawSize = 0;
+				binarySection.data = readData(section.fallbackData, 0, dataSize);
+			}
+
+			const size_t expectedDataSize = binarySection.rawSize != 0 ? static_cast<size_t>(binarySection.rawSize) * section.count : sizeof(SceneBinaryRange) * section.count;
+
+			if (!binarySection.entityIndices || !binarySection.data || indexCount != section.count || dataSize != expectedDataSize
+				|| std::any_of(binarySection.entityIndices, binarySection.entityIndices + indexCount, [&](uint32_t entityIdx) { return entityIdx >= entityCount; }))
+			{
+				std::cout << "SceneData::LoadBinary - Section of component " << ResolveString(getString(section.typeStringIdx))
+					<< " is corrupt, component will not be loaded" << std::endl;
+				continue;
+			}
+
+			m_binaryComponentSections.push_back(binarySection);
+		}
+
+		// Sections are written in type string order, but are inserted in registration order like json scenes, so
+		// construction signals see components of earlier registered types already present
+		std::unordered_map<entt::id_type, size_t> registrationIndices;
+		const auto& registeredTypes = serialization::ComponentRegistry::Get()->GetRegisteredTypesVector();
+
+		for (size_t idx = 0; idx < registeredTypes.size(); ++idx)
+		{
+			registrationIndices.emplace(registeredTypes[idx], idx);
+		}
+
+		std::stable_sort(m_binaryComponentSections.begin(), m_binaryComponentSections.end(),
+			[&](const BinaryComponentSection& lhs, const BinaryComponentSection& rhs)
+		{
+			return registrationIndices.at(lhs.typeID) < registrationIndices.at(rhs.typeID);
+		});
+
+		// Nodes
+		size_t nodeCount = 0;
+		const auto* nodes = GetBinaryTable<SceneBinaryNode>(m_mappedFile, header.nodes, nodeCount);
+
+		size_t childCount = 0;
+		const auto* childNodes = GetBinaryTable<uint32_t>(m_mappedFile, header.childNodes, childCount);
+
+		size_t rootCount = 0;
+		const auto* rootNodes = GetBinaryTable<uint32_t>(m_mappedFile, header.rootNodes, rootCount);
+
+		if ((!nodes && header.nodes.size != 0) || (!childNodes && header.childNodes.size != 0) || (!rootNodes && header.rootNodes.size != 0))
+			return failLoad("node table");
+
+		m_nodeIDs.reserve(nodeCount);
+		m_serializedNodeData.reserve(nodeCount);
+
+		for (size_t idx = 0; idx < nodeCount; ++idx)
+		{
+			const auto& node = nodes[idx];
+
+			m_nodeIDs.push_back(node.id);
+
+			auto& serializedNodeData = m_serializedNodeData.emplace(node.id, SerializedNodeData{}).first->second;
+			serializedNodeData.id = node.id;
+			serializedNodeData.nameID = getString(node.nameIdx);
+			serializedNodeData.nameSuffix = node.nameSuffix;
+			serializedNodeData.typeStringID = getString(node.typeStringIdx);
+			serializedNodeData.typeID = node.typeID;
+
+			if (!ReadBinaryBlob(m_mappedFile, node.data, serializedNodeData.json))
+				return failLoad("node data");
+
+			serializedNodeData.childIDs.reserve(node.childCount);
+
+			for (uint32_t childIdx = node.firstChild; childIdx < node.firstChild + node.childCount && childIdx < childCount; ++childIdx)
+			{
+				if (childNodes[childIdx] < nodeCount)
+					serializedNodeData.childIDs.push_back(nodes[childNodes[childIdx]].id);
+			}
+		}
+
+		m_rootNodeIDs.reserve(rootCount);
+
+		for (size_t idx = 0; idx < rootCount; ++idx)
+		{
+			if (rootNodes[idx] < nodeCount)
+				m_rootNodeIDs.push_back(nodes[rootNodes[idx]].id);
+		}
+
+		// Mapping is only needed while there are components left to read
+		if (m_binaryComponentSections.empty())
+			m_mappedFile.Close();
+
+		m_hasData = true;
+	}
+
+	bool SceneData::LoadRecovery()
+	{
+		if (!m_hasData)
+			return false;
+
+		return ApplyDeltaFile(GetRecoveryPath());
+	}
+
+	void SceneData::LoadDelta()
+	{
+		ApplyDeltaFile(GetDeltaPath());
+	}
+
+	bool SceneData::ApplyDeltaFile(const fs::path& deltaPath)
+	{
+		if (!fs::exists(deltaPath))
+			return false;
+
+		utility::MappedFile file(deltaPath);
+
+		if (!file.IsOpen())
+			return false;
+
+		const auto deltaJson = nlohmann::json::from_msgpack(file.Data(), file.Data() + file.Size(), true, false);
+
+		uint64_t baseSize = 0;
+		int64_t baseTime = 0;
+
+		if (!GetSceneFileStamp(m_path, baseSize, baseTime) || !deltaJson.is_object() || deltaJson.value("version", 0u) != gSceneDeltaVersion
+			|| deltaJson.value("baseSize", static_cast<uint64_t>(0)) != baseSize || deltaJson.value("baseTime", static_cast<int64_t>(0)) != baseTime)
+		{
+			std::cout << "SceneData::ApplyDeltaFile - Delta " << deltaPath.string() << " does not match scene file, it will not be applied" << std::endl;
+			return false;
+		}
+
+		// Components have to be held as json so delta can replace them
+		ExpandBinaryComponents();
+
+		// Entities
+		std::unordered_set<UUID> entityIDs(m_entityIDs.begin(), m_entityIDs.end());
+
+		for (const auto& id : deltaJson.at("removedEntityIDs").get<std::vector<UUID>>())
+		{
+			entityIDs.erase(id);
 
-					componentsJson[typeString] = componentJson;
-				}
+			for (auto& [typeID, entityJsonMap] : m_serializedComponentData)
+			{
+				entityJsonMap.erase(id);
 			}
-		}
 
-		sceneJson["components"] = componentsJson;
+			m_deltaRemovedEntityIDs.insert(id);
+		}
 
-		// Serialize nodes
-		nlohmann::json nodesJson;
+		m_entityIDs.erase(std::remove_if(m_entityIDs.begin(), m_entityIDs.end(), [&](const UUID& id)
+		{
+			return entityIDs.find(id) == entityIDs.end();
+		}), m_entityIDs.end());
 
-		nodesJson["rootNodeIDs"] = m_rootNodeIDs;
+		std::unordered_map<std::string_view, const serialization::ComponentTypeFuncs*> typeStringToFuncs;
 
-		std::vector<nlohmann::json> nodeJsons;
-		nodeJsons.resize(m_nodeIDs.size());
+		for (const auto& funcs : serialization::ComponentRegistry::Get()->GetTypeFuncs())
+		{
+			typeStringToFuncs.emplace(funcs.typeString, &funcs);
+		}
 
-		int i = 0;
-		for (const auto& id : m_nodeIDs)
+		// Each entity in delta replaces all components it had in scene file
+		for (const auto& entityJson : deltaJson.at("entities"))
 		{
-			const auto& serializedNodeData = m_serializedNodeData.at(id);
-			
-			auto& nodeJson = nodeJsons[i];
+			const auto id = entityJson.at("id").get<UUID>();
 
-			nodeJson["id"] = serializedNodeData.id;
-			nodeJson["name"] = serializedNodeData.name;
-			nodeJson["type"] = serializedNodeData.type;
-			
-			if (!serializedNodeData.json.empty())
+			if (entityIDs.insert(id).second)
+				m_entityIDs.push_back(id);
+
+			for (auto& [typeID, entityJsonMap] : m_serializedComponentData)
 			{
-				nodeJson["data"] = serializedNodeData.json;
+				entityJsonMap.erase(id);
 			}
 
-			if (!serializedNodeData.childIDs.empty())
+			for (const auto& component : entityJson.at("components").items())
 			{
-				nodeJson["childIDs"] = serializedNodeData.childIDs;
+				const auto it = typeStringToFuncs.find(component.key());
+				if (it == typeStringToFuncs.end())
+					continue;
+
+				m_serializedComponentData[it->second->typeID][id] = component.value();
 			}
 
-			++i;
+			m_deltaEntityIDs.insert(id);
 		}
 
-		nodesJson["nodes"] = nodeJsons;
-		sceneJson["nodes"] = nodesJson;
+		// Nodes
+		for (const auto& id : deltaJson.at("removedNodeIDs").get<std::vector<UUID>>())
+		{
+			m_serializedNodeData.erase(id);
+
+			m_deltaRemovedNodeIDs.insert(id);
+		}
+
+		std::unordered_map<StringID, uint32_t> typeStringIDToTypeID;
 
-		// Write scene data to file
-		if (!fs::exists(m_path.parent_path()))
+		for (const auto& nodeJson : deltaJson.at("nodes"))
 		{
-			fs::create_directories(m_path.parent_path());
+			LoadNodeJson(nodeJson, typeStringIDToTypeID);
+
+			m_deltaNodeIDs.insert(nodeJson.at("id").get<UUID>());
 		}
 
-		std::ofstream os(m_path, std::ios::out);
+		m_rootNodeIDs = deltaJson.at("rootNodeIDs").get<std::vector<UUID>>();
 
-		os << std::setw(4) << sceneJson << std::endl;
+		UpdateNodeOrder();
 
-		os.close();
+		return true;
 	}
 
-	void SceneData::Load(const bool forceLoad)
+	void SceneData::UpdateNodeOrder()
 	{
-		if (m_hasData && !forceLoad)
-			return;
+		m_nodeIDs.clear();
+		m_nodeIDs.reserve(m_serializedNodeData.size());
 
-		if (!fs::exists(m_path))
-			return;
+		// Depth first from each root, same order nodes are serialized in
+		std::vector<UUID> stack(m_rootNodeIDs.rbegin(), m_rootNodeIDs.rend());
 
-		// Initialize Input File Stream and Cereal Binary Archive
-		std::ifstream is(m_path);
+		while (!stack.empty())
+		{
+			const UUID id = stack.back();
+			stack.pop_back();
 
-		json sceneJson;
-		is >> sceneJson;
+			const auto it = m_serializedNodeData.find(id);
+			if (it == m_serializedNodeData.end())
+				continue;
 
-		is.close();
+			m_nodeIDs.push_back(id);
 
-		m_sceneInfo = DeserializeSceneInfo(sceneJson.at("sceneInfo"));
+			stack.insert(stack.end(), it->second.childIDs.rbegin(), it->second.childIDs.rend());
+		}
+	}
 
-		// Deserialize Components
+	void SceneData::SetupEntitiesFromBinary(ecs::EnTTSubsystem* enttSubsystem, enki::TaskScheduler* taskScheduler) const
+	{
+		const auto registry = enttSubsystem->GetRegistry();
 
-		nlohmann::json componentsJson = sceneJson.at("components");
-		m_entityIDs = componentsJson.at("entityIDs").get<std::vector<UUID>>();
+		enttSubsystem->Reserve(m_entityIDs.size());
+
+		std::vector<entt::entity> entities;
+		entities.reserve(m_entityIDs.size());
+
+		for (const auto& id : m_entityIDs)
+		{
+			entities.push_back(enttSubsystem->AddEntity(id));
+		}
 
-		auto* componentRegistry = serialization::ComponentRegistry::Get();
-		for (const auto& typeID : componentRegistry->GetRegisteredTypesVector())
+		auto getSectionEntities = [&](const BinaryComponentSection& section, std::vector<entt::entity>& sectionEntities)
 		{
-			if (m_serializedComponentData.find(typeID) == m_serializedComponentData.end())
+			sectionEntities.clear();
+			sectionEntities.reserve(section.count);
+
+			for (uint32_t idx = 0; idx < section.count; ++idx)
 			{
-				m_serializedComponentData.emplace(typeID, EntityJsonMap());
+				sectionEntities.push_back(entities[section.entityIndices[idx]]);
 			}
+		};
 
-			auto type = entt::resolve(typeID);
+		// Sections stored as blobs are decoded in parallel up front, so every section can then be inserted in order
+		std::vector<serialization::ComponentBatch> batches;
+		std::vector<const SceneBinaryRange*> batchBlobRanges;
+		std::vector<std::vector<nlohmann::json>> batchJsons;
 
-			if (auto getTypeStringFunc = type.func(entt::hs("GetTypeString")))
-			{
-				auto typeString = getTypeStringFunc.invoke({}).cast<std::string_view>();
+		for (const auto& section : m_binaryComponentSections)
+		{
+			if (section.rawSize != 0)
+				continue;
 
-				if (componentsJson.contains(typeString))
-				{
-					const json& componentJson = componentsJson.at(typeString);
-					for (const auto& archiveJson : componentJson)
-					{
-						auto& entityJsonMap = m_serializedComponentData.at(typeID);
-						entityJsonMap.emplace(archiveJson["id"], archiveJson["data"]);
-					}
-				}
-			}
+			auto& batch = batches.emplace_back();
+			batch.typeID = section.typeID;
+			batch.jsons.resize(section.count, nullptr);
+
+			getSectionEntities(section, batch.entities);
+
+			batchBlobRanges.push_back(reinterpret_cast<const SceneBinaryRange*>(section.data));
+			batchJsons.emplace_back(section.count);
 		}
 
-		// Deserialize Nodes
-		nlohmann::json nodesJson = sceneJson.at("nodes");
+		// Components whose blobs are corrupt are left null, and skipped when their batch is inserted
+		std::atomic<size_t> corruptCount { 0 };
 
-		m_rootNodeIDs = nodesJson.at("rootNodeIDs").get<std::vector<UUID>>();
+		DeserializeBatches(batches, taskScheduler, [&](size_t batchIdx, size_t begin, size_t end)
+		{
+			auto& batch = batches[batchIdx];
+			auto& jsons = batchJsons[batchIdx];
 
-		for (const auto& nodeJson : nodesJson.at("nodes"))
+			for (size_t idx = begin; idx < end; ++idx)
+			{
+				if (ReadBinaryBlob(m_mappedFile, batchBlobRanges[batchIdx][idx], jsons[idx]))
+					batch.jsons[idx] = &jsons[idx];
+				else
+					++corruptCount;
+			}
+		});
+
+		if (corruptCount > 0)
 		{
-			const UUID& id = nodeJson.at("id");
+			std::cout << "SceneData::SetupEntitiesFromBinary - " << corruptCount.load() << " components have corrupt data and were not loaded: " << m_path.string() << std::endl;
+		}
 
-			m_nodeIDs.push_back(id);
-			m_serializedNodeData.emplace(id, SerializedNodeData{});
+		std::vector<entt::entity> sectionEntities;
+		size_t batchIdx = 0;
 
-			auto& serializedNodeData = m_serializedNodeData.at(id);
-			serializedNodeData.id = id;
-			serializedNodeData.name = nodeJson.at("name");
-			serializedNodeData.type = nodeJson.at("type");
-			
-			if (nodeJson.contains("childIDs"))
+		for (const auto& section : m_binaryComponentSections)
+		{
+			if (section.rawSize == 0)
 			{
-				serializedNodeData.childIDs = nodeJson.at("childIDs").get<std::vector<UUID>>();
+				InsertBatch(*registry, batches[batchIdx++]);
+				continue;
 			}
 
-			if (nodeJson.contains("data"))
+			// Whole section is inserted as one batch straight from mapped file
+			if (const auto* funcs = serialization::ComponentRegistry::Get()->GetTypeFuncs(section.typeID))
 			{
-				serializedNodeData.json = nodeJson.at("data");
+				getSectionEntities(section, sectionEntities);
+
+				funcs->insertRawToRegistry(*registry, sectionEntities, section.data);
 			}
 		}
-
-		m_hasData = true;
 	}
 
-	void SceneData::LoadAndInit(ecs::EnTTSubsystem* enttSubsystem, scene::SceneGraphSubsystem* sceneGraph)
+	void SceneData::ExpandBinaryComponents()
 	{
-		Load();
-		Setup(enttSubsystem, sceneGraph);
+		for (const auto& section : m_binaryComponentSections)
+		{
+			auto& entityJsonMap = m_serializedComponentData[section.typeID];
+
+			if (section.rawSize != 0)
+			{
+				const auto* funcs = serialization::ComponentRegistry::Get()->GetTypeFuncs(section.typeID);
+				if (!funcs)
+					continue;
+
+				for (uint32_t idx = 0; idx < section.count; ++idx)
+				{
+					const void* data = section.data + static_cast<size_t>(idx) * section.rawSize;
+
+					entityJsonMap.emplace(m_entityIDs[section.entityIndices[idx]], funcs->rawToJson(data));
+				}
+			}
+			else
+			{
+				const auto* blobRanges = reinterpret_cast<const SceneBinaryRange*>(section.data);
+
+				nlohmann::json json;
+				size_t corruptCount = 0;
+
+				for (uint32_t idx = 0; idx < section.count; ++idx)
+				{
+					if (ReadBinaryBlob(m_mappedFile, blobRanges[idx], json))
+						entityJsonMap.emplace(m_entityIDs[section.entityIndices[idx]], std::move(json));
+					else
+						++corruptCount;
+				}
+
+				if (corruptCount > 0)
+				{
+					std::cout << "SceneData::ExpandBinaryComponents - " << corruptCount << " components have corrupt data and were dropped: " << m_path.string() << std::endl;
+				}
+			}
+		}
+
+		ClearBinaryComponents();
 	}
 
-	void SceneData::SetPath(const fs::path& path)
+	void SceneData::ClearBinaryComponents()
 	{
-		m_path = path;
+		m_binaryComponentSections.clear();
+		m_mappedFile.Close();
 	}
 
-	const fs::path& SceneData::GetPath()
+	void SceneData::SerializeNodeAndChildren(scene::SceneGraphSubsystem* sceneGraph, UUID id)
 	{
-		return m_path;
+		auto node = sceneGraph->GetNode(id);
+
+		m_nodeIDs.push_back(id);
+
+		SerializeNode(node, m_serializedNodeData[id]);
+
+		for (const auto& childID : node->GetChildIDs())
+		{
+			SerializeNodeAndChildren(sceneGraph, childID);
+		}
 	}
 
-	const SceneInfo& SceneData::GetSceneInfo() const
+	void SceneData::SerializeNode(const Node* node, SerializedNodeData& serializedNodeData) const
 	{
-		return m_sceneInfo;
+		serializedNodeData.id = node->GetID();
+		serializedNodeData.nameID = node->GetNameID();
+		serializedNodeData.nameSuffix = node->GetNameSuffix();
+		serializedNodeData.typeStringID = InternString(node->GetTypeString());
+		serializedNodeData.typeID = node->GetTypeID();
+		serializedNodeData.childIDs.assign(node->GetChildIDs().begin(), node->GetChildIDs().end());
+
+		serializedNodeData.json = nlohmann::json {};
+		node->Serialize(serializedNodeData.json);
 	}
 
-	void SceneData::SerializeNodeAndChildren(scene::SceneGraphSubsystem* sceneGraph, UUID id)
+	void SceneData::UpdateDirtyNodeAndChildren(scene::SceneGraphSubsystem* sceneGraph, UUID id, const std::unordered_set<UUID>& dirtyIDs)
 	{
-		auto node = sceneGraph->GetNode(id);
+		const auto node = sceneGraph->GetNode(id);
 
 		m_nodeIDs.push_back(id);
-		m_serializedNodeData.emplace(id, SerializedNodeData{});
 
-		auto& serializedNodeData = m_serializedNodeData.at(id);
-		serializedNodeData.id = id;
-		serializedNodeData.name = node->GetName();
-		serializedNodeData.type = node->GetTypeString();
+		auto [it, isNew] = m_serializedNodeData.try_emplace(id);
+		auto& serializedNodeData = it->second;
 
-		node->Serialize(serializedNodeData.json);
+		// Renames & added/removed/reordered children are found by comparing against serialized data
+		const auto& childIDs = node->GetChildIDs();
 
-		for (const auto& childID : node->GetChildIDs())
+		const bool isDirty = isNew || dirtyIDs.find(id) != dirtyIDs.end()
+			|| serializedNodeData.nameID != node->GetNameID() || serializedNodeData.nameSuffix != node->GetNameSuffix()
+			|| serializedNodeData.typeID != node->GetTypeID()
+			|| !std::equal(serializedNodeData.childIDs.begin(), serializedNodeData.childIDs.end(), childIDs.begin(), childIDs.end());
+
+		if (isDirty)
 		{
-			serializedNodeData.childIDs.push_back(childID);
-			SerializeNodeAndChildren(sceneGraph, childID);
+			SerializeNode(node, serializedNodeData);
+
+			m_deltaNodeIDs.insert(id);
+			m_deltaRemovedNodeIDs.erase(id);
+		}
+
+		for (const auto& childID : childIDs)
+		{
+			UpdateDirtyNodeAndChildren(sceneGraph, childID, dirtyIDs);
 		}
 	}
 
@@ -350,14 +1409,28 @@ namespace puffin::scene
 	{
 		EngineSubsystem::Initialize(subsystemManager);
 
+		subsystemManager->CreateAndInitializeSubsystem<core::EnkiTSSubsystem>();
 		subsystemManager->CreateAndInitializeSubsystem<ecs::EnTTSubsystem>();
 		subsystemManager->CreateAndInitializeSubsystem<scene::SceneGraphSubsystem>();
 	}
 
 	void SceneSerializationSubsystem::Deinitialize()
 	{
+		WaitForSave();
+
+		m_saveTask = nullptr;
+		m_saveSnapshot.Clear();
+		m_saveSceneData = nullptr;
+		m_saveNodeData = nullptr;
+
+		m_playSnapshot.Clear();
+		m_playSceneData = nullptr;
+
 		m_currentSceneData = nullptr;
 		m_sceneData.clear();
+
+		m_prefabs.clear();
+		m_prefabPathToID.clear();
 	}
 
 	void SceneSerializationSubsystem::BeginPlay()
@@ -365,12 +1438,44 @@ namespace puffin::scene
 		const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
 		const auto sceneGraph = m_engine->GetSubsystem<scene::SceneGraphSubsystem>();
 
-		m_currentSceneData->UpdateData(m_engine);
+		// Edits made before play are recorded in scene data & its delta, so they're still saved once play ends
+		UpdateSceneData();
+
+		// Components are restored from snapshot when play ends, so only nodes need to be serialized, they're kept
+		// apart from current scene data, which saves & deltas are written from
+		m_playSnapshot.Capture(enttSubsystem);
+
+		m_playSceneData = std::make_shared<SceneData>(m_currentSceneData->GetPath(), m_currentSceneData->GetSceneInfo());
+		m_playSceneData->UpdateNodeData(sceneGraph);
+
+		// Changes made during play are thrown away when it ends, so they shouldn't be saved
+		enttSubsystem->SetDirtyTrackingEnabled(false);
 	}
 
 	void SceneSerializationSubsystem::EndPlay()
 	{
-		LoadAndSetup();
+		const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
+		const auto sceneGraph = m_engine->GetSubsystem<scene::SceneGraphSubsystem>();
+
+		// Save task may be writing play snapshot
+		WaitForSave();
+
+		if (!m_playSnapshot.HasData())
+		{
+			enttSubsystem->SetDirtyTrackingEnabled(true);
+
+			LoadAndSetup();
+			return;
+		}
+
+		// Restored entities & nodes match scene data as it was brought up to date when play began
+		m_playSnapshot.Restore(enttSubsystem);
+		m_playSceneData->SetupNodes(sceneGraph);
+
+		m_playSnapshot.Clear();
+		m_playSceneData = nullptr;
+
+		enttSubsystem->SetDirtyTrackingEnabled(true);
 	}
 
 	std::string_view SceneSerializationSubsystem::GetName() const
@@ -380,11 +1485,15 @@ namespace puffin::scene
 
 	void SceneSerializationSubsystem::Load() const
 	{
+		WaitForSave();
+
 		m_currentSceneData->Load();
 	}
 
 	void SceneSerializationSubsystem::LoadFromFile(const fs::path& path)
 	{
+		WaitForSave();
+
 		std::shared_ptr<SceneData> scene = nullptr;
 
 		if (m_sceneData.find(path) == m_sceneData.end())
@@ -402,8 +1511,12 @@ namespace puffin::scene
 	{
 		const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
 		const auto sceneGraph = m_engine->GetSubsystem<scene::SceneGraphSubsystem>();
+		const auto enkitsSubsystem = m_engine->GetSubsystem<core::EnkiTSSubsystem>();
+
+		m_currentSceneData->Setup(enttSubsystem, sceneGraph, enkitsSubsystem->GetTaskScheduler().get());
 
-		m_currentSceneData->Setup(enttSubsystem, sceneGraph);
+		// Registry now matches scene data, so only changes from here on need saving
+		enttSubsystem->ClearDirty();
 	}
 
 	void SceneSerializationSubsystem::LoadAndSetup() const
@@ -412,6 +1525,139 @@ namespace puffin::scene
 		Setup();
 	}
 
+	void SceneSerializationSubsystem::UpdateSceneData()
+	{
+		// Save task may still be writing nodes of current scene
+		WaitForSave();
+
+		const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
+		const auto sceneGraph = m_engine->GetSubsystem<scene::SceneGraphSubsystem>();
+
+		// Changes made during play are thrown away when it ends, so they shouldn't reach scene data
+		if (!enttSubsystem->IsDirtyTrackingEnabled())
+			return;
+
+		if (m_currentSceneData->HasData())
+			m_currentSceneData->UpdateDirtyData(enttSubsystem, sceneGraph);
+		else
+			m_currentSceneData->UpdateData(m_engine);
+
+		enttSubsystem->ClearDirty();
+	}
+
+	void SceneSerializationSubsystem::SaveAsync()
+	{
+		// Previous save still holds snapshot & may be writing same file
+		WaitForSave();
+
+		const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
+		const auto enkitsSubsystem = m_engine->GetSubsystem<core::EnkiTSSubsystem>();
+
+		// File may still be mapped if scene was loaded from a binary file, it has to be closed before being overwritten
+		m_currentSceneData->ExpandBinaryComponents();
+
+		const ecs::RegistrySnapshot* snapshot = &m_saveSnapshot;
+
+		if (enttSubsystem->IsDirtyTrackingEnabled())
+		{
+			// Scene file will hold every change made so far, so scene data is brought up to date & its delta is dropped
+			UpdateSceneData();
+
+			m_currentSceneData->ClearDelta();
+
+			m_saveSnapshot.Capture(enttSubsystem);
+		}
+		else if (m_playSnapshot.HasData())
+		{
+			// Changes made during play are thrown away when it ends, so scene is saved as it was before play
+			snapshot = &m_playSnapshot;
+
+			m_saveSnapshot.Clear();
+		}
+		else
+		{
+			if (!m_currentSceneData->HasData())
+				m_currentSceneData->UpdateData(m_engine);
+
+			m_saveSnapshot.Capture(enttSubsystem);
+		}
+
+		/*
+		 * Only path, format & scene info are copied, nodes are written by task straight from current scene, whose
+		 * serialized nodes are already up to date, as they are only reserialized once changed. Current scene & play
+		 * snapshot aren't modified again until save has finished
+		 */
+		m_saveSceneData = std::make_shared<SceneData>(m_currentSceneData->GetPath(), m_currentSceneData->GetSceneInfo());
+		m_saveSceneData->SetFileFormat(m_currentSceneData->GetFileFormat());
+		m_saveNodeData = m_currentSceneData;
+
+		m_saveTask = std::make_unique<enki::TaskSet>([this, snapshot](enki::TaskSetPartition range, uint32_t threadIdx)
+		{
+			m_saveSceneData->Save(*snapshot, *m_saveNodeData);
+		});
+
+		enkitsSubsystem->GetTaskScheduler()->AddTaskSetToPipe(m_saveTask.get());
+	}
+
+	void SceneSerializationSubsystem::SaveDelta()
+	{
+		// Delta is written against scene file, which may still be being written
+		WaitForSave();
+
+		// Changes made during play aren't tracked
+		if (!m_engine->GetSubsystem<ecs::EnTTSubsystem>()->IsDirtyTrackingEnabled())
+			return;
+
+		if (!m_currentSceneData->HasData() || !fs::exists(m_currentSceneData->GetPath()))
+		{
+			SaveAsync();
+			return;
+		}
+
+		UpdateSceneData();
+
+		// Large deltas cost close to a full save to write & apply, so they're compacted into scene file in background
+		if (m_currentSceneData->ShouldCompactDelta())
+		{
+			SaveAsync();
+			return;
+		}
+
+		if (m_currentSceneData->GetDeltaCount() > 0)
+			m_currentSceneData->SaveDelta();
+	}
+
+	void SceneSerializationSubsystem::SaveRecovery()
+	{
+		// Recovery is written against scene file, which may still be being written
+		WaitForSave();
+
+		// Changes made during play aren't tracked
+		if (!m_engine->GetSubsystem<ecs::EnTTSubsystem>()->IsDirtyTrackingEnabled())
+			return;
+
+		if (!m_currentSceneData->HasData() || !fs::exists(m_currentSceneData->GetPath()))
+			return;
+
+		UpdateSceneData();
+
+		if (m_currentSceneData->GetDeltaCount() > 0)
+			m_currentSceneData->SaveRecovery();
+	}
+
+	void SceneSerializationSubsystem::WaitForSave() const
+	{
+		if (!m_saveTask)
+			return;
+
+		m_engine->GetSubsystem<core::EnkiTSSubsystem>()->GetTaskScheduler()->WaitforTask(m_saveTask.get());
+	}
+
+	bool SceneSerializationSubsystem::IsSaving() const
+	{
+		return m_saveTask && !m_saveTask->GetIsComplete();
+	}
+
 	std::shared_ptr<SceneData> SceneSerializationSubsystem::CreateScene(const fs::path& path, const SceneInfo& sceneInfo)
 	{
 		auto* resourceManager = m_engine->GetResourceManager();
@@ -432,4 +1678,107 @@ namespace puffin::scene
 	{
 		return m_currentSceneData;
 	}
+
+	UUID SceneSerializationSubsystem::LoadPrefab(const fs::path& path)
+	{
+		if (const auto it = m_prefabPathToID.find(path); it != m_prefabPathToID.end())
+			return it->second;
+
+		const auto sceneGraph = m_engine->GetSubsystem<scene::SceneGraphSubsystem>();
+
+		auto prefab = std::make_shared<Prefab>(path);
+		prefab->Load(sceneGraph);
+
+		if (!prefab->HasData())
+			return gInvalidID;
+
+		const UUID prefabID = GenerateId();
+
+		m_prefabs.emplace(prefabID, prefab);
+		m_prefabPathToID.emplace(path, prefabID);
+
+		return prefabID;
+	}
+
+	UUID SceneSerializationSubsystem::CreatePrefabFromNode(UUID rootID, const fs::path& path)
+	{
+		const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
+		const auto sceneGraph = m_engine->GetSubsystem<scene::SceneGraphSubsystem>();
+
+		auto prefab = std::make_shared<Prefab>(path);
+		prefab->UpdateFromNode(enttSubsystem, sceneGraph, rootID);
+
+		const UUID prefabID = GenerateId();
+
+		m_prefabs.emplace(prefabID, prefab);
+
+		if (!path.empty())
+		{
+			prefab->Save();
+
+			m_prefabPathToID[path] = prefabID;
+		}
+
+		return prefabID;
+	}
+
+	std::shared_ptr<Prefab> SceneSerializationSubsystem::GetPrefab(UUID prefabID)
+	{
+		if (const auto it = m_prefabs.find(prefabID); it != m_prefabs.end())
+			return it->second;
+
+		return nullptr;
+	}
+
+	UUID SceneSerializationSubsystem::InstantiatePrefab(UUID prefabID, UUID parentID) const
+	{
+		const auto root = InstantiatePrefabInternal(prefabID, parentID);
+
+		return root ? root->GetID() : gInvalidID;
+	}
+
+	UUID SceneSerializationSubsystem::InstantiatePrefab(UUID prefabID, UUID parentID, const Transform2D& transform) const
+	{
+		const auto root = InstantiatePrefabInternal(prefabID, parentID);
+		if (!root)
+			return gInvalidID;
+
+		auto* transformNode2D = dynamic_cast<Transform2DNode*>(root);
+
+		assert(transformNode2D != nullptr && "SceneSerializationSubsystem::InstantiatePrefab - Prefab root is not a Transform2DNode");
+
+		transformNode2D->SetTransform(transform);
+
+		return root->GetID();
+	}
+
+	UUID SceneSerializationSubsystem::InstantiatePrefab(UUID prefabID, UUID parentID, const TransformComponent3D& transform) const
+	{
+		const auto root = InstantiatePrefabInternal(prefabID, parentID);
+		if (!root)
+			return gInvalidID;
+
+		auto* transformNode3D = dynamic_cast<TransformNode3D*>(root);
+
+		assert(transformNode3D != nullptr && "SceneSerializationSubsystem::InstantiatePrefab - Prefab root is not a TransformNode3D");
+
+		transformNode3D->Transform() = transform;
+
+		return root->GetID();
+	}
+
+	Node* SceneSerializationSubsystem::InstantiatePrefabInternal(UUID prefabID, UUID parentID) const
+	{
+		const auto it = m_prefabs.find(prefabID);
+
+		assert(it != m_prefabs.end() && "SceneSerializationSubsystem::InstantiatePrefab - Prefab does not exist");
+
+		if (it == m_prefabs.end())
+			return nullptr;
+
+		const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
+		const auto sceneGraph = m_engine->GetSubsystem<scene::SceneGraphSubsystem>();
+
+		return it->second->Instantiate(enttSubsystem, sceneGraph, parentID);
+	}
 }
@@ -2,6 +2,7 @@
 
 #include <fstream>
 #include <filesystem>
+#include <unordered_set>
 #include <utility>
 
 #include "nlohmann/json.hpp"
@@ -11,16 +12,37 @@
 #include "scene/scene_graph_subsystem.h"
 #include "subsystem/engine_subsystem.h"
 #include "ecs/entt_subsystem.h"
+#include "ecs/registry_snapshot.h"
 #include "types/uuid.h"
+#include "types/string_intern.h"
 #include "utility/serialization.h"
+#include "utility/mapped_file.h"
 #include "scene/scene_info.h"
+#include "scene/scene_binary.h"
+#include "scene/prefab.h"
+#include "types/transform2d.h"
+#include "component/transform_component_3d.h"
 
 namespace fs = std::filesystem;
 
+namespace enki
+{
+	class TaskScheduler;
+	class TaskSet;
+}
+
 namespace puffin
 {
 	namespace scene
 	{
+		class SceneWriter;
+
+		constexpr size_t gSceneLoadChunkSize = 512; // Number of components decoded by a single task when loading a scene
+
+		constexpr uint32_t gSceneDeltaVersion = 1;
+		constexpr size_t gSceneDeltaCompactMinCount = 256; // Delta is never compacted into scene file while it holds fewer entities & nodes than this
+		constexpr double gSceneDeltaCompactRatio = 0.25; // Delta is compacted once it holds this fraction of entities & nodes in scene
+
 		// Stores Loaded Scene Data
 		class SceneData
 		{
@@ -30,17 +52,64 @@ namespace puffin
 			explicit SceneData(fs::path path);
 			explicit SceneData(fs::path path, SceneInfo sceneInfo);
 
-			// Initialize ECS & SceneGraph with loaded data
-			void Setup(ecs::EnTTSubsystem* enttSubsystem, scene::SceneGraphSubsystem* sceneGraph);
+			/*
+			 * Initialize ECS & SceneGraph with loaded data, components are decoded on task scheduler workers
+			 * when one is provided
+			 */
+			void Setup(ecs::EnTTSubsystem* enttSubsystem, scene::SceneGraphSubsystem* sceneGraph, enki::TaskScheduler* taskScheduler = nullptr);
+			void SetupEntities(ecs::EnTTSubsystem* enttSubsystem, enki::TaskScheduler* taskScheduler = nullptr);
+			void SetupNodes(scene::SceneGraphSubsystem* sceneGraph);
 
 			void UpdateData(const std::shared_ptr<core::Engine>& engine);
+			void UpdateEntityData(ecs::EnTTSubsystem* enttSubsystem);
+			void UpdateNodeData(scene::SceneGraphSubsystem* sceneGraph);
+
+			/*
+			 * Only reserialize entities marked dirty/removed in EnTTSubsystem, and nodes which are new, dirty or were
+			 * renamed/reparented, changes are also recorded for next delta save. Scene must already hold data
+			 */
+			void UpdateDirtyData(ecs::EnTTSubsystem* enttSubsystem, scene::SceneGraphSubsystem* sceneGraph);
 
 			void Clear();
 
-			// Save Entities/Components to json scene file
+			// Save Entities/Components to scene file, in format set by SetFileFormat (json unless scene was loaded from a binary file)
 			void Save();
 
-			// Load  Entities/Components from Binary Scene File
+			/*
+			 * Save components captured in snapshot instead of serialized component data, along with serialized nodes of
+			 * nodeData, to path of this scene. Safe to call from a worker thread as long as scene data, node data &
+			 * snapshot aren't modified while saving
+			 */
+			void Save(const ecs::RegistrySnapshot& snapshot, const SceneData& nodeData) const;
+
+			/*
+			 * Write every entity & node changed since scene file was last written in full to delta file next to it,
+			 * delta is applied on top of scene file when it is next loaded
+			 */
+			void SaveDelta() const;
+
+			/*
+			 * Write same changes as SaveDelta to recovery file next to scene file, recovery is never applied when scene is
+			 * loaded, only by LoadRecovery, so autosaves don't change scene without it being saved
+			 */
+			void SaveRecovery() const;
+
+			// Apply recovery file on top of loaded scene, returns false if there is no recovery file matching scene file
+			bool LoadRecovery();
+
+			// Forget changes recorded for delta saves, once scene file holds them
+			void ClearDelta();
+
+			// Number of entities & nodes held in delta
+			[[nodiscard]] size_t GetDeltaCount() const;
+
+			// Whether delta has grown large enough that scene should be written in full instead
+			[[nodiscard]] bool ShouldCompactDelta() const;
+
+			[[nodiscard]] fs::path GetDeltaPath() const;
+			[[nodiscard]] fs::path GetRecoveryPath() const;
+
+			// Load Entities/Components from scene file, format is detected from file header
 			void Load(const bool forceLoad = false);
 			void LoadAndInit(ecs::EnTTSubsystem* enttSubsystem, scene::SceneGraphSubsystem* sceneGraph);
 
@@ -49,6 +118,14 @@ namespace puffin
 
 			const SceneInfo& GetSceneInfo() const;
 
+			[[nodiscard]] bool HasData() const;
+
+			void SetFileFormat(SceneFileFormat fileFormat);
+			[[nodiscard]] SceneFileFormat GetFileFormat() const;
+
+			// Convert components still held in mapped binary file to json, so they can be saved or modified
+			void ExpandBinaryComponents();
+
 		private:
 
 			using EntityJsonMap = std::unordered_map<UUID, nlohmann::json>;
@@ -56,14 +133,51 @@ namespace puffin
 			struct SerializedNodeData
 			{
 				UUID id;
-				std::string name;
-				std::string type;
+				StringID nameID = gEmptyStringID;
+				uint32_t nameSuffix = gNoNameSuffix;
+				StringID typeStringID = gEmptyStringID;
+				uint32_t typeID = 0; // Hashed type string, resolved once when node data is loaded/copied
 				std::vector<UUID> childIDs;
 				nlohmann::json json;
 			};
 
+			// Component section of a mapped binary scene file, components are read straight from file during setup
+			struct BinaryComponentSection
+			{
+				entt::id_type typeID = 0;
+				uint32_t rawSize = 0;
+				uint32_t count = 0;
+				const uint32_t* entityIndices = nullptr;
+				const uint8_t* data = nullptr; // Packed components, or blob range per component if rawSize is 0
+			};
+
+			void WriteNodes(SceneWriter& writer) const;
+
+			// Write changes since scene file was last written in full to deltaPath, returns false if it couldn't be written
+			bool WriteDeltaFile(const fs::path& deltaPath) const;
+
+			// Remove delta & recovery files, as scene file has been written in full
+			void RemoveDeltaFiles() const;
+
+			void LoadJson(const nlohmann::json& sceneJson);
+			void LoadBinary();
+
+			// Apply delta file on top of loaded scene, delta is ignored if scene file was changed after it was written
+			void LoadDelta();
+			bool ApplyDeltaFile(const fs::path& deltaPath);
+
+			void LoadNodeJson(const nlohmann::json& nodeJson, std::unordered_map<StringID, uint32_t>& typeStringIDToTypeID);
+
+			// Rebuild node order from root nodes, so parents are before their children
+			void UpdateNodeOrder();
+
+			void SetupEntitiesFromBinary(ecs::EnTTSubsystem* enttSubsystem, enki::TaskScheduler* taskScheduler) const;
+
+			void ClearBinaryComponents();
+
 			fs::path m_path;
 			SceneInfo m_sceneInfo;
+			SceneFileFormat m_fileFormat = SceneFileFormat::Json;
 
 			bool m_hasData = false; // This scene contains a copy of active scene data, either loaded from file or copied from ecs
 
@@ -74,7 +188,18 @@ namespace puffin
 			std::vector<UUID> m_nodeIDs;
 			std::unordered_map<UUID, SerializedNodeData> m_serializedNodeData;
 
+			utility::MappedFile m_mappedFile; // Kept open while component data is read from binary file
+			std::vector<BinaryComponentSection> m_binaryComponentSections;
+
+			// Changes since scene file was last written in full
+			std::unordered_set<UUID> m_deltaEntityIDs;
+			std::unordered_set<UUID> m_deltaRemovedEntityIDs;
+			std::unordered_set<UUID> m_deltaNodeIDs;
+			std::unordered_set<UUID> m_deltaRemovedNodeIDs;
+
 			void SerializeNodeAndChildren(scene::SceneGraphSubsystem* sceneGraph, UUID id);
+			void SerializeNode(const Node* node, SerializedNodeData& serializedNodeData) const;
+			void UpdateDirtyNodeAndChildren(scene::SceneGraphSubsystem* sceneGraph, UUID id, const std::unordered_set<UUID>& dirtyIDs);
 		};
 
 		class SceneSerializationSubsystem : public core::EngineSubsystem
@@ -97,15 +222,74 @@ namespace puffin
 			void Setup() const;
 			void LoadAndSetup() const;
 
+			/*
+			 * Bring current scene data up to date with registry & scene graph, only entities & nodes changed since it was
+			 * last updated are reserialized once scene holds data. Does nothing during play
+			 */
+			void UpdateSceneData();
+
+			/*
+			 * Save current scene on a background task, registry is captured & changed nodes reserialized when called so
+			 * registry & scene graph can keep changing while file is written. Saves made during play write scene as it was
+			 * before play
+			 */
+			void SaveAsync();
+
+			/*
+			 * Save only entities & nodes changed since scene was loaded or last saved in full to a delta file, for frequent
+			 * explicit saves on large scenes. Once delta grows too large scene is written in full with SaveAsync
+			 */
+			void SaveDelta();
+
+			/*
+			 * Autosave, changes since scene was last saved in full are written to a recovery file, see SceneData::SaveRecovery.
+			 * Scene file & delta are never written, scenes which have never been saved are left for an explicit save
+			 */
+			void SaveRecovery();
+
+			// Block until any save started by SaveAsync has finished
+			void WaitForSave() const;
+			[[nodiscard]] bool IsSaving() const;
+
 			std::shared_ptr<SceneData> CreateScene(const fs::path& path, const SceneInfo& sceneInfo);
 
+			// Save task reads current scene, so WaitForSave before modifying it directly
 			std::shared_ptr<SceneData> GetCurrentSceneData();
 
+			// Load prefab file, file is only parsed the first time it is loaded, returns id used to instantiate prefab
+			UUID LoadPrefab(const fs::path& path);
+
+			// Create prefab from subtree starting at rootID, prefab is saved if a path is provided
+			UUID CreatePrefabFromNode(UUID rootID, const fs::path& path = {});
+
+			std::shared_ptr<Prefab> GetPrefab(UUID prefabID);
+
+			/*
+			 * Add a new instance of prefab as a child of parentID (or as a root node if parentID is invalid),
+			 * returns id of instance root node, transform overrides local transform of root node
+			 */
+			UUID InstantiatePrefab(UUID prefabID, UUID parentID = gInvalidID) const;
+			UUID InstantiatePrefab(UUID prefabID, UUID parentID, const Transform2D& transform) const;
+			UUID InstantiatePrefab(UUID prefabID, UUID parentID, const TransformComponent3D& transform) const;
+
 		private:
 
+			Node* InstantiatePrefabInternal(UUID prefabID, UUID parentID) const;
+
+			ecs::RegistrySnapshot m_playSnapshot; // Copy of registry taken at start of play, restored when play ends
+			std::shared_ptr<SceneData> m_playSceneData = nullptr; // Nodes serialized at start of play, restored when play ends
+
+			std::unique_ptr<enki::TaskSet> m_saveTask = nullptr;
+			ecs::RegistrySnapshot m_saveSnapshot; // Copy of registry being written by save task
+			std::shared_ptr<SceneData> m_saveSceneData = nullptr; // Path & scene info being written by save task
+			std::shared_ptr<SceneData> m_saveNodeData = nullptr; // Scene whose nodes are being written by save task
+
 			std::shared_ptr<SceneData> m_currentSceneData = nullptr;
 			std::unordered_map<fs::path, std::shared_ptr<SceneData>> m_sceneData;
 
+			std::unordered_map<UUID, std::shared_ptr<Prefab>> m_prefabs;
+			std::unordered_map<fs::path, UUID> m_prefabPathToID;
+
 		};
 	}
 
@@ -0,0 +1,538 @@
+#include "scene/scene_writer.h"
+
+#include <cassert>
+#include <utility>
+
+#include "node/node.h"
+#include "serialization/component_serialization.h"
+
+namespace puffin::scene
+{
+	SceneWriter::SceneWriter(fs::path path, SceneFileFormat fileFormat)
+		: m_path(std::move(path)), m_fileFormat(fileFormat)
+	{
+	}
+
+	SceneWriter::~SceneWriter()
+	{
+		if (m_stream.is_open())
+			m_stream.close();
+	}
+
+	bool SceneWriter::Begin()
+	{
+		if (m_path.has_parent_path() && !fs::exists(m_path.parent_path()))
+		{
+			fs::create_directories(m_path.parent_path());
+		}
+
+		// Buffer has to be set before file is opened to take effect
+		m_streamBuffer.resize(gSceneWriteBufferSize);
+		m_stream.rdbuf()->pubsetbuf(m_streamBuffer.data(), static_cast<std::streamsize>(m_streamBuffer.size()));
+
+		if (m_fileFormat == SceneFileFormat::Binary)
+		{
+			m_stream.open(m_path, std::ios::out | std::ios::binary);
+
+			if (!m_stream.is_open())
+				return false;
+
+			// Header is rewritten once location of each table is known
+			m_binaryOffset = 0;
+			m_binaryHeader = SceneBinaryHeader();
+			BinaryWrite(&m_binaryHeader, sizeof(SceneBinaryHeader));
+		}
+		else
+		{
+			m_stream.open(m_path, std::ios::out);
+
+			if (!m_stream.is_open())
+				return false;
+
+			m_jsonScopeEmpty.clear();
+			JsonBeginScope('{');
+		}
+
+		return true;
+	}
+
+	void SceneWriter::End()
+	{
+		assert(m_stream.is_open() && "SceneWriter::End - File is not open");
+
+		if (m_fileFormat == SceneFileFormat::Binary)
+		{
+			// Strings, ranges are made relative to file once location of string data is known
+			const SceneBinaryRange stringDataRange = BinaryWriteTable(m_binaryStringData);
+
+			for (auto& range : m_binaryStringRanges)
+			{
+				range.offset += stringDataRange.offset;
+			}
+
+			m_binaryHeader.strings = BinaryWriteTable(m_binaryStringRanges);
+			m_binaryHeader.fileSize = m_binaryOffset;
+
+			m_stream.seekp(0);
+			m_stream.write(reinterpret_cast<const char*>(&m_binaryHeader), sizeof(SceneBinaryHeader));
+		}
+		else
+		{
+			JsonEndScope('}');
+
+			m_stream << std::endl;
+		}
+
+		m_stream.close();
+	}
+
+	void SceneWriter::BeginComponents(const std::vector<UUID>& entityIDs)
+	{
+		m_entityIDs = &entityIDs;
+
+		if (m_fileFormat == SceneFileFormat::Binary)
+		{
+			m_binaryEntityIDToIdx.clear();
+			m_binaryEntityIDToIdx.reserve(entityIDs.size());
+
+			for (uint32_t idx = 0; idx < entityIDs.size(); ++idx)
+			{
+				m_binaryEntityIDToIdx.emplace(entityIDs[idx], idx);
+			}
+
+			m_binaryHeader.entityIDs = BinaryWriteTable(entityIDs);
+			m_binaryComponentSections.clear();
+		}
+		else
+		{
+			JsonKey("components");
+			JsonBeginScope('{');
+		}
+	}
+
+	void SceneWriter::EndComponents()
+	{
+		assert(m_entityIDs && "SceneWriter::EndComponents - BeginComponents was not called");
+
+		if (m_fileFormat == SceneFileFormat::Binary)
+		{
+			m_binaryHeader.components = BinaryWriteTable(m_binaryComponentSections);
+
+			m_binaryEntityIDToIdx.clear();
+		}
+		else
+		{
+			// Written last to keep same key order as files saved from a json document
+			JsonKey("entityIDs");
+			JsonIDs(*m_entityIDs);
+
+			JsonEndScope('}');
+		}
+
+		m_entityIDs = nullptr;
+	}
+
+	void SceneWriter::BeginComponentType(entt::id_type typeID, std::string_view typeString)
+	{
+		m_componentTypeID = typeID;
+		m_componentTypeString = typeString;
+		m_componentTypeStarted = false;
+	}
+
+	void SceneWriter::WriteComponent(UUID id, const nlohmann::json& json)
+	{
+		WriteComponent(id, nullptr, json);
+	}
+
+	void SceneWriter::WriteComponent(UUID id, const void* rawData, const nlohmann::json& json)
+	{
+		if (!m_componentTypeStarted)
+			StartComponentType();
+
+		if (m_fileFormat == SceneFileFormat::Binary)
+		{
+			const auto it = m_binaryEntityIDToIdx.find(id);
+			if (it == m_binaryEntityIDToIdx.end())
+				return;
+
+			m_binaryEntityIndices.push_back(it->second);
+
+			if (m_binarySection.rawSize != 0)
+			{
+				// Raw components are written as they arrive, section data is contiguous as nothing else is written in between
+				if (!rawData)
+				{
+					m_binaryScratch.clear();
+					m_binaryComponentFuncs->jsonToRaw(json, m_binaryScratch);
+
+					rawData = m_binaryScratch.data();
+				}
+
+				BinaryWrite(rawData, m_binarySection.rawSize);
+
+				// Fallback blobs are held until raw data is complete, offsets are relative to fallback data until then
+				SceneBinaryRange range;
+				range.offset = m_binaryFallbackData.size();
+
+				nlohmann::json::to_msgpack(json, m_binaryFallbackData);
+
+				range.size = m_binaryFallbackData.size() - range.offset;
+				m_binaryFallbackRanges.push_back(range);
+			}
+			else
+			{
+				m_binaryBlobRanges.push_back(BinaryWriteBlob(json));
+			}
+		}
+		else
+		{
+			JsonNextElement();
+			JsonBeginScope('{');
+
+			JsonKey("data");
+			JsonValue(json);
+
+			JsonKey("id");
+			m_stream << id;
+
+			JsonEndScope('}');
+		}
+	}
+
+	void SceneWriter::EndComponentType()
+	{
+		if (!m_componentTypeStarted)
+			return;
+
+		if (m_fileFormat == SceneFileFormat::Binary)
+		{
+			m_binarySection.count = static_cast<uint32_t>(m_binaryEntityIndices.size());
+
+			if (m_binarySection.rawSize != 0)
+			{
+				m_binarySection.data.size = m_binaryOffset - m_binarySection.data.offset;
+
+				const uint64_t fallbackDataOffset = m_binaryOffset;
+				BinaryWrite(m_binaryFallbackData.data(), m_binaryFallbackData.size());
+
+				for (auto& range : m_binaryFallbackRanges)
+				{
+					range.offset += fallbackDataOffset;
+				}
+
+				m_binarySection.fallbackData = BinaryWriteTable(m_binaryFallbackRanges);
+			}
+			else
+			{
+				m_binarySection.data = BinaryWriteTable(m_binaryBlobRanges);
+			}
+
+			m_binarySection.entityIndices = BinaryWriteTable(m_binaryEntityIndices);
+
+			m_binaryComponentSections.push_back(m_binarySection);
+		}
+		else
+		{
+			JsonEndScope(']');
+		}
+
+		m_componentTypeStarted = false;
+	}
+
+	void SceneWriter::BeginNodes(const std::vector<UUID>& nodeIDs)
+	{
+		if (m_fileFormat == SceneFileFormat::Binary)
+		{
+			m_binaryNodeIDToIdx.clear();
+			m_binaryNodeIDToIdx.reserve(nodeIDs.size());
+
+			for (uint32_t idx = 0; idx < nodeIDs.size(); ++idx)
+			{
+				m_binaryNodeIDToIdx.emplace(nodeIDs[idx], idx);
+			}
+
+			m_binaryNodes.clear();
+			m_binaryNodes.reserve(nodeIDs.size());
+			m_binaryChildNodes.clear();
+		}
+		else
+		{
+			JsonKey("nodes");
+			JsonBeginScope('{');
+
+			JsonKey("nodes");
+			JsonBeginScope('[');
+		}
+	}
+
+	void SceneWriter::WriteNode(UUID id, StringID nameID, uint32_t nameSuffix, StringID typeStringID, uint32_t typeID,
+		const std::vector<UUID>& childIDs, const nlohmann::json& json)
+	{
+		if (m_fileFormat == SceneFileFormat::Binary)
+		{
+			SceneBinaryNode node;
+			node.id = id;
+			node.typeID = typeID;
+			node.typeStringIdx = BinaryAddString(typeStringID);
+			node.nameIdx = BinaryAddString(nameID);
+			node.nameSuffix = nameSuffix;
+			node.firstChild = static_cast<uint32_t>(m_binaryChildNodes.size());
+
+			for (const auto& childID : childIDs)
+			{
+				if (const auto it = m_binaryNodeIDToIdx.find(childID); it != m_binaryNodeIDToIdx.end())
+					m_binaryChildNodes.push_back(it->second);
+			}
+
+			node.childCount = static_cast<uint32_t>(m_binaryChildNodes.size()) - node.firstChild;
+
+			if (!json.empty())
+				node.data = BinaryWriteBlob(json);
+
+			m_binaryNodes.push_back(node);
+		}
+		else
+		{
+			JsonNextElement();
+			JsonBeginScope('{');
+
+			if (!childIDs.empty())
+			{
+				JsonKey("childIDs");
+				JsonIDs(childIDs);
+			}
+
+			if (!json.empty())
+			{
+				JsonKey("data");
+				JsonValue(json);
+			}
+
+			JsonKey("id");
+			m_stream << id;
+
+			JsonKey("name");
+			JsonValue(Node::BuildName(nameID, nameSuffix));
+
+			JsonKey("type");
+			JsonValue(ResolveString(typeStringID));
+
+			JsonEndScope('}');
+		}
+	}
+
+	void SceneWriter::EndNodes(const std::vector<UUID>& rootNodeIDs)
+	{
+		if (m_fileFormat == SceneFileFormat::Binary)
+		{
+			std::vector<uint32_t> rootNodes;
+			rootNodes.reserve(rootNodeIDs.size());
+
+			for (const auto& id : rootNodeIDs)
+			{
+				if (const auto it = m_binaryNodeIDToIdx.find(id); it != m_binaryNodeIDToIdx.end())
+					rootNodes.push_back(it->second);
+			}
+
+			m_binaryHeader.nodes = BinaryWriteTable(m_binaryNodes);
+			m_binaryHeader.rootNodes = BinaryWriteTable(rootNodes);
+			m_binaryHeader.childNodes = BinaryWriteTable(m_binaryChildNodes);
+
+			m_binaryNodeIDToIdx.clear();
+		}
+		else
+		{
+			JsonEndScope(']');
+
+			JsonKey("rootNodeIDs");
+			JsonIDs(rootNodeIDs);
+
+			JsonEndScope('}');
+		}
+	}
+
+	void SceneWriter::WriteSceneInfo(const SceneInfo& sceneInfo)
+	{
+		if (m_fileFormat == SceneFileFormat::Binary)
+		{
+			BinaryAlign();
+			m_binaryHeader.sceneInfo = BinaryWriteBlob(SerializeSceneInfo(sceneInfo));
+		}
+		else
+		{
+			JsonKey("sceneInfo");
+			JsonValue(SerializeSceneInfo(sceneInfo));
+		}
+	}
+
+	void SceneWriter::StartComponentType()
+	{
+		if (m_fileFormat == SceneFileFormat::Binary)
+		{
+			m_binaryComponentFuncs = serialization::ComponentRegistry::Get()->GetTypeFuncs(m_componentTypeID);
+
+			m_binarySection = SceneBinaryComponentSection();
+			m_binarySection.typeID = m_componentTypeID;
+			m_binarySection.typeStringIdx = BinaryAddString(InternString(m_componentTypeString));
+
+			// Types which can't be converted to raw are stored as blobs
+			if (m_binaryComponentFuncs)
+			{
+				m_binarySection.rawSize = m_binaryComponentFuncs->rawSize;
+				m_binarySection.rawLayoutHash = m_binaryComponentFuncs->rawLayoutHash;
+			}
+
+			if (m_binarySection.rawSize != 0)
+				m_binarySection.data.offset = BinaryAlign();
+
+			m_binaryEntityIndices.clear();
+			m_binaryBlobRanges.clear();
+			m_binaryFallbackRanges.clear();
+			m_binaryFallbackData.clear();
+		}
+		else
+		{
+			JsonKey(m_componentTypeString);
+			JsonBeginScope('[');
+		}
+
+		m_componentTypeStarted = true;
+	}
+
+	void SceneWriter::JsonBeginScope(char open)
+	{
+		m_stream.put(open);
+
+		m_jsonScopeEmpty.push_back(true);
+	}
+
+	void SceneWriter::JsonEndScope(char close)
+	{
+		assert(!m_jsonScopeEmpty.empty() && "SceneWriter::JsonEndScope - No scope is open");
+
+		const bool empty = m_jsonScopeEmpty.back();
+		m_jsonScopeEmpty.pop_back();
+
+		// Empty objects/arrays are written on one line, same as json dump
+		if (!empty)
+		{
+			m_stream.put('\n');
+			JsonIndent(m_jsonScopeEmpty.size());
+		}
+
+		m_stream.put(close);
+	}
+
+	void SceneWriter::JsonNextElement()
+	{
+		if (!m_jsonScopeEmpty.back())
+			m_stream.put(',');
+
+		m_jsonScopeEmpty.back() = false;
+
+		m_stream.put('\n');
+		JsonIndent(m_jsonScopeEmpty.size());
+	}
+
+	void SceneWriter::JsonKey(std::string_view key)
+	{
+		JsonNextElement();
+
+		m_stream << nlohmann::json(key).dump() << ": ";
+	}
+
+	void SceneWriter::JsonValue(const nlohmann::json& value)
+	{
+		// Value is dumped on its own, so its lines have to be indented to current depth
+		const std::string dump = value.dump(4);
+		const size_t depth = m_jsonScopeEmpty.size();
+
+		size_t lineStart = 0;
+		size_t lineEnd = dump.find('\n');
+
+		while (lineEnd != std::string::npos)
+		{
+			m_stream.write(dump.data() + lineStart, static_cast<std::streamsize>(lineEnd - lineStart + 1));
+			JsonIndent(depth);
+
+			lineStart = lineEnd + 1;
+			lineEnd = dump.find('\n', lineStart);
+		}
+
+		m_stream.write(dump.data() + lineStart, static_cast<std::streamsize>(dump.size() - lineStart));
+	}
+
+	void SceneWriter::JsonIDs(const std::vector<UUID>& ids)
+	{
+		JsonBeginScope('[');
+
+		for (const auto& id : ids)
+		{
+			JsonNextElement();
+
+			m_stream << id;
+		}
+
+		JsonEndScope(']');
+	}
+
+	void SceneWriter::JsonIndent(size_t depth)
+	{
+		for (size_t i = 0; i < depth; ++i)
+		{
+			m_stream.write("    ", 4);
+		}
+	}
+
+	void SceneWriter::BinaryWrite(const void* data, size_t size)
+	{
+		m_stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+
+		m_binaryOffset += size;
+	}
+
+	uint64_t SceneWriter::BinaryAlign()
+	{
+		static constexpr char padding[gSceneBinaryAlignment] = {};
+
+		const uint64_t alignedOffset = AlignSceneBinaryOffset(m_binaryOffset);
+
+		BinaryWrite(padding, alignedOffset - m_binaryOffset);
+
+		return m_binaryOffset;
+	}
+
+	SceneBinaryRange SceneWriter::BinaryWriteBlob(const nlohmann::json& json)
+	{
+		m_binaryScratch.clear();
+		nlohmann::json::to_msgpack(json, m_binaryScratch);
+
+		SceneBinaryRange range;
+		range.offset = m_binaryOffset;
+		range.size = m_binaryScratch.size();
+
+		BinaryWrite(m_binaryScratch.data(), m_binaryScratch.size());
+
+		return range;
+	}
+
+	uint32_t SceneWriter::BinaryAddString(StringID stringID)
+	{
+		if (const auto it = m_binaryStringIDToIdx.find(stringID); it != m_binaryStringIDToIdx.end())
+			return it->second;
+
+		const auto& string = ResolveString(stringID);
+
+		SceneBinaryRange range;
+		range.offset = m_binaryStringData.size(); // Relative to string data until table is written
+		range.size = string.size();
+
+		m_binaryStringData.insert(m_binaryStringData.end(), string.begin(), string.end());
+
+		const auto idx = static_cast<uint32_t>(m_binaryStringRanges.size());
+		m_binaryStringRanges.push_back(range);
+		m_binaryStringIDToIdx.emplace(stringID, idx);
+
+		return idx;
+	}
+}
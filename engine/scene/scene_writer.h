@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "entt/core/fwd.hpp"
+
+#include "scene/scene_binary.h"
+#include "scene/scene_info.h"
+#include "types/string_intern.h"
+#include "types/uuid.h"
+
+namespace fs = std::filesystem;
+
+namespace puffin
+{
+	namespace serialization
+	{
+		struct ComponentTypeFuncs;
+	}
+
+	namespace scene
+	{
+		constexpr size_t gSceneWriteBufferSize = 1 << 16; // Size of file stream buffer used when writing scenes
+
+		/*
+		 * Writes a scene file piece by piece straight to a buffered file stream, so a scene can be saved without first
+		 * building a json document or byte buffer holding the whole file
+		 *
+		 * Calls are expected in order Begin, BeginComponents/EndComponents, BeginNodes/EndNodes, WriteSceneInfo, End.
+		 * In json format keys are written in the order they are called, components are expected sorted by type string
+		 * so files stay stable to diff between saves. Binary files only hold on to tables of indices until the section
+		 * they belong to is ended, header is written last once location of every table is known
+		 */
+		class SceneWriter
+		{
+		public:
+
+			SceneWriter(fs::path path, SceneFileFormat fileFormat);
+			~SceneWriter();
+
+			SceneWriter(const SceneWriter&) = delete;
+			SceneWriter& operator=(const SceneWriter&) = delete;
+
+			// Open file for writing, creating its directory if needed, returns false if file could not be opened
+			bool Begin();
+
+			// Finish writing any remaining tables & close file
+			void End();
+
+			// Begin components of entityIDs, ids must remain valid until EndComponents
+			void BeginComponents(const std::vector<UUID>& entityIDs);
+			void EndComponents();
+
+			// Begin section for one component type, types without any components written are left out of file
+			void BeginComponentType(entt::id_type typeID, std::string_view typeString);
+			void WriteComponent(UUID id, const nlohmann::json& json);
+
+			/*
+			 * Raw bytes of component are written as they are to raw binary sections rather than converted from json,
+			 * json is still needed for json files & fallback blobs
+			 */
+			void WriteComponent(UUID id, const void* rawData, const nlohmann::json& json);
+			void EndComponentType();
+
+			// Begin nodes, nodeIDs must be in same order as nodes will be written & remain valid until EndNodes
+			void BeginNodes(const std::vector<UUID>& nodeIDs);
+			void WriteNode(UUID id, StringID nameID, uint32_t nameSuffix, StringID typeStringID, uint32_t typeID,
+				const std::vector<UUID>& childIDs, const nlohmann::json& json);
+			void EndNodes(const std::vector<UUID>& rootNodeIDs);
+
+			void WriteSceneInfo(const SceneInfo& sceneInfo);
+
+		private:
+
+			// Emit key/section of component type once its first component is written
+			void StartComponentType();
+
+			// Json
+			void JsonBeginScope(char open);
+			void JsonEndScope(char close);
+			void JsonNextElement();
+			void JsonKey(std::string_view key);
+			void JsonValue(const nlohmann::json& value);
+			void JsonIDs(const std::vector<UUID>& ids);
+			void JsonIndent(size_t depth);
+
+			// Binary
+			void BinaryWrite(const void* data, size_t size);
+			uint64_t BinaryAlign();
+			SceneBinaryRange BinaryWriteBlob(const nlohmann::json& json);
+			uint32_t BinaryAddString(StringID stringID);
+
+			template<typename T>
+			SceneBinaryRange BinaryWriteTable(const std::vector<T>& table)
+			{
+				SceneBinaryRange range;
+				range.offset = BinaryAlign();
+				range.size = table.size() * sizeof(T);
+
+				BinaryWrite(table.data(), range.size);
+
+				return range;
+			}
+
+			fs::path m_path;
+			SceneFileFormat m_fileFormat = SceneFileFormat::Json;
+
+			std::vector<char> m_streamBuffer;
+			std::ofstream m_stream;
+
+			// Current component type
+			entt::id_type m_componentTypeID = 0;
+			std::string_view m_componentTypeString;
+			bool m_componentTypeStarted = false;
+			const std::vector<UUID>* m_entityIDs = nullptr;
+
+			// Json state, one entry per open object/array, true until first element is written
+			std::vector<bool> m_jsonScopeEmpty;
+
+			// Binary state
+			uint64_t m_binaryOffset = 0;
+			SceneBinaryHeader m_binaryHeader;
+			std::vector<uint8_t> m_binaryScratch; // Reused for msgpack blobs & raw components before they are written
+
+			std::unordered_map<UUID, uint32_t> m_binaryEntityIDToIdx;
+			std::unordered_map<UUID, uint32_t> m_binaryNodeIDToIdx;
+
+			SceneBinaryComponentSection m_binarySection;
+			const serialization::ComponentTypeFuncs* m_binaryComponentFuncs = nullptr;
+			std::vector<uint32_t> m_binaryEntityIndices;
+			std::vector<SceneBinaryRange> m_binaryBlobRanges;
+			std::vector<SceneBinaryRange> m_binaryFallbackRanges; // Msgpack copy of each raw component
+			std::vector<uint8_t> m_binaryFallbackData;
+			std::vector<SceneBinaryComponentSection> m_binaryComponentSections;
+
+			std::vector<SceneBinaryNode> m_binaryNodes;
+			std::vector<uint32_t> m_binaryChildNodes;
+
+			// Strings are deduplicated through their interned ids
+			std::vector<SceneBinaryRange> m_binaryStringRanges;
+			std::vector<uint8_t> m_binaryStringData;
+			std::unordered_map<StringID, uint32_t> m_binaryStringIDToIdx;
+
+		};
+	}
+}
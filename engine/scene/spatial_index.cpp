@@ -0,0 +1,323 @@
+#include "scene/spatial_index.h"
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+#include "math_helpers.h"
+
+namespace puffin::scene
+{
+	namespace
+	{
+		TreeBounds<2> ToTreeBounds(const AABB2D& bounds)
+		{
+			return { { bounds.min.x, bounds.min.y }, { bounds.max.x, bounds.max.y } };
+		}
+
+		TreeBounds<3> ToTreeBounds(const AABB3D& bounds)
+		{
+			return { { bounds.min.x, bounds.min.y, bounds.min.z }, { bounds.max.x, bounds.max.y, bounds.max.z } };
+		}
+
+		template<int Dim>
+		void QueryTree(const DynamicAABBTree<Dim>& tree, const TreeBounds<Dim>& bounds, std::vector<UUID>& ids)
+		{
+			ids.clear();
+
+			tree.Query(bounds, [&](int32_t proxy)
+			{
+				ids.push_back(tree.GetID(proxy));
+				return true;
+			});
+		}
+
+		template<int Dim>
+		void QueryTreeRadius(const DynamicAABBTree<Dim>& tree, const std::array<float, Dim>& center, float radius, std::vector<UUID>& ids)
+		{
+			ids.clear();
+
+			TreeBounds<Dim> bounds;
+			for (int i = 0; i < Dim; ++i)
+			{
+				bounds.min[i] = center[i] - radius;
+				bounds.max[i] = center[i] + radius;
+			}
+
+			const float radiusSq = radius * radius;
+
+			tree.Query(bounds, [&](int32_t proxy)
+			{
+				if (tree.GetBounds(proxy).DistanceSq(center) <= radiusSq)
+					ids.push_back(tree.GetID(proxy));
+
+				return true;
+			});
+		}
+
+		template<int Dim>
+		bool RaycastTree(const DynamicAABBTree<Dim>& tree, std::array<float, Dim> direction, const std::array<float, Dim>& origin,
+			float maxDistance, SpatialRaycastHit& hit)
+		{
+			float lengthSq = 0.0f;
+			for (int i = 0; i < Dim; ++i)
+			{
+				lengthSq += direction[i] * direction[i];
+			}
+
+			if (lengthSq <= 0.0f)
+				return false;
+
+			const float invLength = 1.0f / std::sqrt(lengthSq);
+			for (int i = 0; i < Dim; ++i)
+			{
+				direction[i] *= invLength;
+			}
+
+			hit = {};
+			bool hasHit = false;
+
+			// Clip ray to each hit so only closer nodes are tested afterwards
+			tree.Raycast(origin, direction, maxDistance, [&](int32_t proxy, float distance)
+			{
+				if (!hasHit || distance < hit.distance)
+				{
+					hit.id = tree.GetID(proxy);
+					hit.distance = distance;
+					hasHit = true;
+				}
+
+				// Origin is inside node bounds, nothing can be closer
+				if (distance <= 0.0f)
+					return 0.0f;
+
+				return hit.distance;
+			});
+
+			return hasHit;
+		}
+
+		template<int Dim>
+		void KNearestTree(const DynamicAABBTree<Dim>& tree, const std::array<float, Dim>& point, uint32_t k, std::vector<UUID>& ids)
+		{
+			std::vector<int32_t> proxies;
+			tree.KNearest(point, k, proxies);
+
+			ids.clear();
+			ids.reserve(proxies.size());
+
+			for (const auto proxy : proxies)
+			{
+				ids.push_back(tree.GetID(proxy));
+			}
+		}
+	}
+
+	void SpatialIndex::SetLocalBounds2D(UUID id, const AABB2D& bounds)
+	{
+		auto& entry = mEntries2D[id];
+		entry.hasLocalBounds = true;
+		entry.localBounds = bounds;
+
+		if (entry.proxy != gNullTreeNode)
+			UpdateProxy(mTree2D, id, entry);
+	}
+
+	void SpatialIndex::SetLocalBounds3D(UUID id, const AABB3D& bounds)
+	{
+		auto& entry = mEntries3D[id];
+		entry.hasLocalBounds = true;
+		entry.localBounds = bounds;
+
+		if (entry.proxy != gNullTreeNode)
+			UpdateProxy(mTree3D, id, entry);
+	}
+
+	void SpatialIndex::ClearLocalBounds(UUID id)
+	{
+		if (const auto it = mEntries2D.find(id); it != mEntries2D.end() && it->second.hasLocalBounds)
+		{
+			it->second.hasLocalBounds = false;
+
+			if (it->second.proxy != gNullTreeNode)
+				UpdateProxy(mTree2D, id, it->second);
+		}
+
+		if (const auto it = mEntries3D.find(id); it != mEntries3D.end() && it->second.hasLocalBounds)
+		{
+			it->second.hasLocalBounds = false;
+
+			if (it->second.proxy != gNullTreeNode)
+				UpdateProxy(mTree3D, id, it->second);
+		}
+	}
+
+	void SpatialIndex::QueryAABB(const AABB2D& bounds, std::vector<UUID>& ids) const
+	{
+		QueryTree(mTree2D, ToTreeBounds(bounds), ids);
+	}
+
+	void SpatialIndex::QueryAABB(const AABB3D& bounds, std::vector<UUID>& ids) const
+	{
+		QueryTree(mTree3D, ToTreeBounds(bounds), ids);
+	}
+
+	void SpatialIndex::QueryRadius(const Vector2f& center, float radius, std::vector<UUID>& ids) const
+	{
+		QueryTreeRadius<2>(mTree2D, { center.x, center.y }, radius, ids);
+	}
+
+	void SpatialIndex::QueryRadius(const Vector3f& center, float radius, std::vector<UUID>& ids) const
+	{
+		QueryTreeRadius<3>(mTree3D, { center.x, center.y, center.z }, radius, ids);
+	}
+
+	bool SpatialIndex::Raycast(const Vector2f& origin, const Vector2f& direction, float maxDistance, SpatialRaycastHit& hit) const
+	{
+		return RaycastTree<2>(mTree2D, { direction.x, direction.y }, { origin.x, origin.y }, maxDistance, hit);
+	}
+
+	bool SpatialIndex::Raycast(const Vector3f& origin, const Vector3f& direction, float maxDistance, SpatialRaycastHit& hit) const
+	{
+		return RaycastTree<3>(mTree3D, { direction.x, direction.y, direction.z }, { origin.x, origin.y, origin.z }, maxDistance, hit);
+	}
+
+	void SpatialIndex::KNearest(const Vector2f& point, uint32_t k, std::vector<UUID>& ids) const
+	{
+		KNearestTree<2>(mTree2D, { point.x, point.y }, k, ids);
+	}
+
+	void SpatialIndex::KNearest(const Vector3f& point, uint32_t k, std::vector<UUID>& ids) const
+	{
+		KNearestTree<3>(mTree3D, { point.x, point.y, point.z }, k, ids);
+	}
+
+	uint32_t SpatialIndex::Count2D() const
+	{
+		return mTree2D.Count();
+	}
+
+	uint32_t SpatialIndex::Count3D() const
+	{
+		return mTree3D.Count();
+	}
+
+	void SpatialIndex::Update2D(UUID id, const Transform2D& globalTransform)
+	{
+		auto& entry = mEntries2D[id];
+		entry.globalTransform = globalTransform;
+
+		UpdateProxy(mTree2D, id, entry);
+	}
+
+	void SpatialIndex::Update3D(UUID id, const TransformComponent3D& globalTransform)
+	{
+		auto& entry = mEntries3D[id];
+		entry.globalTransform = globalTransform;
+
+		UpdateProxy(mTree3D, id, entry);
+	}
+
+	void SpatialIndex::Remove(UUID id)
+	{
+		if (const auto it = mEntries2D.find(id); it != mEntries2D.end())
+		{
+			if (it->second.proxy != gNullTreeNode)
+				mTree2D.DestroyProxy(it->second.proxy);
+
+			mEntries2D.erase(it);
+		}
+
+		if (const auto it = mEntries3D.find(id); it != mEntries3D.end())
+		{
+			if (it->second.proxy != gNullTreeNode)
+				mTree3D.DestroyProxy(it->second.proxy);
+
+			mEntries3D.erase(it);
+		}
+	}
+
+	void SpatialIndex::Clear()
+	{
+		mTree2D.Clear();
+		mTree3D.Clear();
+
+		mEntries2D.clear();
+		mEntries3D.clear();
+	}
+
+	TreeBounds<2> SpatialIndex::CalculateBounds(const Entry2D& entry)
+	{
+		const auto& transform = entry.globalTransform;
+		const float x = static_cast<float>(transform.position.x);
+		const float y = static_cast<float>(transform.position.y);
+
+		if (!entry.hasLocalBounds)
+			return { { x, y }, { x, y } };
+
+		// Rotate scaled bounds center & half extents, extents of rotated box are projected back onto axes
+		const float angle = maths::DegToRad(transform.rotation);
+		const float cosAngle = std::cos(angle);
+		const float sinAngle = std::sin(angle);
+
+		const float centerX = (entry.localBounds.min.x + entry.localBounds.max.x) * 0.5f * transform.scale.x;
+		const float centerY = (entry.localBounds.min.y + entry.localBounds.max.y) * 0.5f * transform.scale.y;
+		const float halfX = std::abs((entry.localBounds.max.x - entry.localBounds.min.x) * 0.5f * transform.scale.x);
+		const float halfY = std::abs((entry.localBounds.max.y - entry.localBounds.min.y) * 0.5f * transform.scale.y);
+
+		const float worldCenterX = x + cosAngle * centerX - sinAngle * centerY;
+		const float worldCenterY = y + sinAngle * centerX + cosAngle * centerY;
+		const float worldHalfX = std::abs(cosAngle) * halfX + std::abs(sinAngle) * halfY;
+		const float worldHalfY = std::abs(sinAngle) * halfX + std::abs(cosAngle) * halfY;
+
+		return { { worldCenterX - worldHalfX, worldCenterY - worldHalfY }, { worldCenterX + worldHalfX, worldCenterY + worldHalfY } };
+	}
+
+	TreeBounds<3> SpatialIndex::CalculateBounds(const Entry3D& entry)
+	{
+		const auto& transform = entry.globalTransform;
+		const glm::vec3 position(static_cast<float>(transform.position.x), static_cast<float>(transform.position.y),
+			static_cast<float>(transform.position.z));
+
+		if (!entry.hasLocalBounds)
+			return { { position.x, position.y, position.z }, { position.x, position.y, position.z } };
+
+		const glm::vec3 min(entry.localBounds.min.x, entry.localBounds.min.y, entry.localBounds.min.z);
+		const glm::vec3 max(entry.localBounds.max.x, entry.localBounds.max.y, entry.localBounds.max.z);
+		const glm::vec3 scale(transform.scale.x, transform.scale.y, transform.scale.z);
+
+		const glm::mat3 rotation = glm::mat3_cast(static_cast<glm::quat>(transform.orientationQuat));
+
+		// Extents of rotated box are its half extents multiplied by absolute rotation matrix
+		glm::mat3 absRotation;
+		for (int col = 0; col < 3; ++col)
+		{
+			absRotation[col] = glm::abs(rotation[col]);
+		}
+
+		const glm::vec3 center = position + rotation * ((min + max) * 0.5f * scale);
+		const glm::vec3 half = absRotation * glm::abs((max - min) * 0.5f * scale);
+
+		return { { center.x - half.x, center.y - half.y, center.z - half.z }, { center.x + half.x, center.y + half.y, center.z + half.z } };
+	}
+
+	void SpatialIndex::UpdateProxy(DynamicAABBTree<2>& tree, UUID id, Entry2D& entry)
+	{
+		const auto bounds = CalculateBounds(entry);
+
+		if (entry.proxy == gNullTreeNode)
+			entry.proxy = tree.CreateProxy(bounds, id);
+		else
+			tree.MoveProxy(entry.proxy, bounds);
+	}
+
+	void SpatialIndex::UpdateProxy(DynamicAABBTree<3>& tree, UUID id, Entry3D& entry)
+	{
+		const auto bounds = CalculateBounds(entry);
+
+		if (entry.proxy == gNullTreeNode)
+			entry.proxy = tree.CreateProxy(bounds, id);
+		else
+			tree.MoveProxy(entry.proxy, bounds);
+	}
+}
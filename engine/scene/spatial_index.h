@@ -0,0 +1,107 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "types/aabb.h"
+#include "types/dynamic_aabb_tree.h"
+#include "types/transform2d.h"
+#include "types/uuid.h"
+#include "types/vector2.h"
+#include "types/vector3.h"
+#include "component/transform_component_3d.h"
+
+namespace puffin
+{
+	namespace scene
+	{
+		constexpr float gSpatialIndexMargin = 0.1f; // Amount bounds are enlarged by in index, nodes moving less than this don't modify the index
+
+		struct SpatialRaycastHit
+		{
+			UUID id = gInvalidID;
+			float distance = 0.0f;
+		};
+
+		/*
+		 * Bounding volume hierarchies of 2d & 3d transform nodes, used for region, ray & nearest neighbour queries
+		 *
+		 * Kept up to date by SceneGraphSubsystem from global transforms which changed since last update,
+		 * nodes without local bounds are indexed as a point at their global position
+		 */
+		class SpatialIndex
+		{
+		public:
+
+			SpatialIndex() = default;
+			~SpatialIndex() = default;
+
+			/*
+			 * Set bounds of node relative to its global transform, bounds are scaled/rotated along with node
+			 */
+			void SetLocalBounds2D(UUID id, const AABB2D& bounds);
+			void SetLocalBounds3D(UUID id, const AABB3D& bounds);
+
+			// Go back to indexing node as a point
+			void ClearLocalBounds(UUID id);
+
+			// Get ids of nodes whose bounds overlap bounds
+			void QueryAABB(const AABB2D& bounds, std::vector<UUID>& ids) const;
+			void QueryAABB(const AABB3D& bounds, std::vector<UUID>& ids) const;
+
+			// Get ids of nodes whose bounds are within radius of center
+			void QueryRadius(const Vector2f& center, float radius, std::vector<UUID>& ids) const;
+			void QueryRadius(const Vector3f& center, float radius, std::vector<UUID>& ids) const;
+
+			// Find closest node whose bounds are hit by ray, returns false if nothing was hit
+			bool Raycast(const Vector2f& origin, const Vector2f& direction, float maxDistance, SpatialRaycastHit& hit) const;
+			bool Raycast(const Vector3f& origin, const Vector3f& direction, float maxDistance, SpatialRaycastHit& hit) const;
+
+			// Get ids of up to k nodes closest to point, sorted closest first
+			void KNearest(const Vector2f& point, uint32_t k, std::vector<UUID>& ids) const;
+			void KNearest(const Vector3f& point, uint32_t k, std::vector<UUID>& ids) const;
+
+			[[nodiscard]] uint32_t Count2D() const;
+			[[nodiscard]] uint32_t Count3D() const;
+
+			// Update node bounds from its global transform, node is added to index if it isn't already
+			void Update2D(UUID id, const Transform2D& globalTransform);
+			void Update3D(UUID id, const TransformComponent3D& globalTransform);
+
+			void Remove(UUID id);
+			void Clear();
+
+		private:
+
+			struct Entry2D
+			{
+				int32_t proxy = gNullTreeNode;
+				bool hasLocalBounds = false;
+				AABB2D localBounds;
+				Transform2D globalTransform;
+			};
+
+			struct Entry3D
+			{
+				int32_t proxy = gNullTreeNode;
+				bool hasLocalBounds = false;
+				AABB3D localBounds;
+				TransformComponent3D globalTransform;
+			};
+
+			static TreeBounds<2> CalculateBounds(const Entry2D& entry);
+			static TreeBounds<3> CalculateBounds(const Entry3D& entry);
+
+			static void UpdateProxy(DynamicAABBTree<2>& tree, UUID id, Entry2D& entry);
+			static void UpdateProxy(DynamicAABBTree<3>& tree, UUID id, Entry3D& entry);
+
+			DynamicAABBTree<2> mTree2D = DynamicAABBTree<2>(gSpatialIndexMargin);
+			DynamicAABBTree<3> mTree3D = DynamicAABBTree<3>(gSpatialIndexMargin);
+
+			// Local bounds of nodes which haven't been indexed yet are also stored here, with no proxy
+			std::unordered_map<UUID, Entry2D> mEntries2D;
+			std::unordered_map<UUID, Entry3D> mEntries3D;
+
+		};
+	}
+}
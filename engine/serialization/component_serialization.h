@@ -1,6 +1,15 @@
 ﻿#pragma once
 
-#include <unordered_set>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include <entt/entity/registry.hpp>
 #include "nlohmann/json.hpp"
@@ -10,29 +19,419 @@
 
 namespace puffin::serialization
 {
+	// Called with each entity & its serialized component, json can be moved from
+	using SerializeStorageCallback = std::function<void(entt::entity, nlohmann::json&&)>;
+
+	// Called with each entity, raw bytes of its component in storage & its serialized component
+	using SerializeStorageRawCallback = std::function<void(entt::entity, const void*, nlohmann::json&&)>;
+
+	/*
+	 * Notified whenever a component of a registered type is constructed, replaced/patched or destroyed in a registry
+	 * it was connected to with ComponentTypeFuncs::connectChangeListener
+	 */
+	class IComponentChangeListener
+	{
+	public:
+
+		virtual ~IComponentChangeListener() = default;
+
+		virtual void OnComponentChanged(entt::registry& registry, entt::entity entity) = 0;
+	};
+
+	template<typename CompT>
+	void ConnectChangeListener(entt::registry& registry, IComponentChangeListener& listener)
+	{
+		registry.on_construct<CompT>().template connect<&IComponentChangeListener::OnComponentChanged>(listener);
+		registry.on_update<CompT>().template connect<&IComponentChangeListener::OnComponentChanged>(listener);
+		registry.on_destroy<CompT>().template connect<&IComponentChangeListener::OnComponentChanged>(listener);
+	}
+
 	template<typename CompT>
-	bool HasComponent(std::shared_ptr<entt::registry> registry, entt::entity entity)
+	bool HasComponent(entt::registry& registry, entt::entity entity)
 	{
-		return registry->any_of<CompT>(entity);
+		return registry.any_of<CompT>(entity);
 	}
 
 	template<typename CompT>
-	nlohmann::json SerializeFromRegistry(std::shared_ptr<entt::registry> registry, entt::entity entity)
+	nlohmann::json SerializeFromRegistry(entt::registry& registry, entt::entity entity)
 	{
-		if (registry->any_of<CompT>(entity))
+		if (registry.any_of<CompT>(entity))
 		{
-			return Serialize<CompT>(registry->get<CompT>(entity));
+			return Serialize<CompT>(registry.get<CompT>(entity));
 		}
 
 		return nlohmann::json {};
 	}
 
+	/*
+	 * Serialize every component in storage of type, only entities in filter are serialized when one is provided,
+	 * so cost scales with number of components rather than number of entities
+	 */
+	template<typename CompT>
+	void SerializeStorage(entt::registry& registry, const entt::sparse_set* filter, const SerializeStorageCallback& callback)
+	{
+		for (auto [entity, component] : registry.storage<CompT>().each())
+		{
+			if (filter && !filter->contains(entity))
+				continue;
+
+			callback(entity, Serialize<CompT>(component));
+		}
+	}
+
+	/*
+	 * As SerializeStorage, but raw bytes of each component are passed along with it, so binary scenes can copy
+	 * components straight from storage rather than converting them back from json
+	 */
+	template<typename CompT>
+	void SerializeStorageRaw(entt::registry& registry, const entt::sparse_set* filter, const SerializeStorageRawCallback& callback)
+	{
+		if constexpr (std::is_trivially_copyable_v<CompT>)
+		{
+			for (auto [entity, component] : registry.storage<CompT>().each())
+			{
+				if (filter && !filter->contains(entity))
+					continue;
+
+				callback(entity, &component, Serialize<CompT>(component));
+			}
+		}
+		else
+		{
+			assert(false && "serialization::SerializeStorageRaw - Component is not trivially copyable");
+		}
+	}
+
+	template<typename CompT>
+	void DeserializeToRegistry(entt::registry& registry, entt::entity entity, const nlohmann::json& json)
+	{
+		registry.emplace_or_replace<CompT>(entity, Deserialize<CompT>(json));
+	}
+
+	/*
+	 * Copy component from each source entity which has one to matching destination entity,
+	 * entities are matched by index so one call copies a component type for a whole batch of entities
+	 *
+	 * Components new to destination are gathered & inserted as a single batch, which is a plain memory copy for
+	 * trivially copyable components
+	 */
+	template<typename CompT>
+	void CopyComponents(entt::registry& srcRegistry, const std::vector<entt::entity>& srcEntities,
+		entt::registry& dstRegistry, const std::vector<entt::entity>& dstEntities)
+	{
+		assert(srcEntities.size() == dstEntities.size() && "serialization::CopyComponents - Source and destination entity counts do not match");
+
+		const auto& srcStorage = srcRegistry.storage<CompT>();
+		const auto& dstStorage = dstRegistry.storage<CompT>();
+
+		std::vector<entt::entity> insertEntities;
+		std::vector<CompT> insertComponents;
+
+		insertEntities.reserve(std::min(srcEntities.size(), srcStorage.size()));
+		insertComponents.reserve(insertEntities.capacity());
+
+		for (size_t i = 0; i < srcEntities.size(); ++i)
+		{
+			if (!srcStorage.contains(srcEntities[i]))
+				continue;
+
+			if (dstStorage.contains(dstEntities[i]))
+			{
+				dstRegistry.replace<CompT>(dstEntities[i], srcStorage.get(srcEntities[i]));
+			}
+			else
+			{
+				insertEntities.push_back(dstEntities[i]);
+				insertComponents.push_back(srcStorage.get(srcEntities[i]));
+			}
+		}
+
+		if (!insertEntities.empty())
+			dstRegistry.insert<CompT>(insertEntities.begin(), insertEntities.end(), insertComponents.begin());
+	}
+
+	/*
+	 * Size of component when stored as raw bytes in binary scene files, 0 if component isn't trivially copyable and
+	 * has to be stored as serialized data instead
+	 */
+	template<typename CompT>
+	uint32_t GetRawSize()
+	{
+		if constexpr (std::is_trivially_copyable_v<CompT>)
+			return sizeof(CompT);
+		else
+			return 0;
+	}
+
+	/*
+	 * Specialize & bump when fields of a trivially copyable component are reordered, or change type without changing
+	 * how they serialize, as raw layout hash can't see those changes
+	 */
+	template<typename CompT>
+	uint32_t GetRawLayoutVersion()
+	{
+		return 0;
+	}
+
+	inline void HashRawLayoutBytes(uint64_t& hash, const void* data, size_t size)
+	{
+		// FNV-1a
+		constexpr uint64_t fnvPrime = 1099511628211ull;
+
+		for (size_t idx = 0; idx < size; ++idx)
+		{
+			hash ^= static_cast<const uint8_t*>(data)[idx];
+			hash *= fnvPrime;
+		}
+	}
+
+	// Hash keys & value types of json, but not values themselves
+	inline void HashJsonLayout(uint64_t& hash, const nlohmann::json& json)
+	{
+		const auto type = static_cast<uint8_t>(json.type());
+		HashRawLayoutBytes(hash, &type, sizeof(type));
+
+		if (json.is_object())
+		{
+			// Object keys are iterated in sorted order, so hash doesn't depend on order fields were serialized in
+			for (auto it = json.begin(); it != json.end(); ++it)
+			{
+				HashRawLayoutBytes(hash, it.key().data(), it.key().size());
+				HashJsonLayout(hash, it.value());
+			}
+		}
+		else if (json.is_array())
+		{
+			const uint64_t size = json.size();
+			HashRawLayoutBytes(hash, &size, sizeof(size));
+
+			for (const auto& value : json)
+			{
+				HashJsonLayout(hash, value);
+			}
+		}
+	}
+
+	/*
+	 * Hash of component's raw layout, stored alongside raw components in binary scene files so components whose
+	 * layout has changed since file was written are never read as raw bytes. Built from size, alignment, layout version
+	 * & the fields component serializes to, 0 if component isn't stored raw
+	 */
+	template<typename CompT>
+	uint64_t GetRawLayoutHash()
+	{
+		if constexpr (std::is_trivially_copyable_v<CompT>)
+		{
+			uint64_t hash = 14695981039346656037ull;
+
+			const uint64_t layout[] = { sizeof(CompT), alignof(CompT), GetRawLayoutVersion<CompT>() };
+			HashRawLayoutBytes(hash, layout, sizeof(layout));
+
+			HashJsonLayout(hash, Serialize<CompT>(CompT()));
+
+			return hash;
+		}
+		else
+		{
+			return 0;
+		}
+	}
+
+	// Append raw bytes of component deserialized from json to buffer
+	template<typename CompT>
+	void JsonToRaw(const nlohmann::json& json, std::vector<uint8_t>& buffer)
+	{
+		if constexpr (std::is_trivially_copyable_v<CompT>)
+		{
+			const CompT component = Deserialize<CompT>(json);
+			const auto* bytes = reinterpret_cast<const uint8_t*>(&component);
+
+			buffer.insert(buffer.end(), bytes, bytes + sizeof(CompT));
+		}
+		else
+		{
+			assert(false && "serialization::JsonToRaw - Component is not trivially copyable");
+		}
+	}
+
+	template<typename CompT>
+	nlohmann::json RawToJson(const void* data)
+	{
+		if constexpr (std::is_trivially_copyable_v<CompT>)
+		{
+			CompT component;
+			std::memcpy(&component, data, sizeof(CompT));
+
+			return Serialize<CompT>(component);
+		}
+		else
+		{
+			assert(false && "serialization::RawToJson - Component is not trivially copyable");
+
+			return nlohmann::json {};
+		}
+	}
+
+	/*
+	 * Add components stored contiguously as raw bytes to entities, one component per entity in order,
+	 * data is inserted straight from buffer when it is suitably aligned. As with InsertBatchToRegistry, components
+	 * already added (i.e. by construction signals of other components) are replaced & the rest inserted as one batch
+	 */
+	template<typename CompT>
+	void InsertRawToRegistry(entt::registry& registry, const std::vector<entt::entity>& entities, const void* data)
+	{
+		if constexpr (std::is_trivially_copyable_v<CompT>)
+		{
+			const auto& storage = registry.storage<CompT>();
+
+			const bool anyExisting = !storage.empty() && std::any_of(entities.begin(), entities.end(), [&](entt::entity entity)
+			{
+				return storage.contains(entity);
+			});
+
+			if (!anyExisting && reinterpret_cast<uintptr_t>(data) % alignof(CompT) == 0)
+			{
+				const auto* components = static_cast<const CompT*>(data);
+
+				registry.insert<CompT>(entities.begin(), entities.end(), components);
+				return;
+			}
+
+			std::vector<CompT> components(entities.size());
+			std::memcpy(components.data(), data, entities.size() * sizeof(CompT));
+
+			if (!anyExisting)
+			{
+				registry.insert<CompT>(entities.begin(), entities.end(), components.begin());
+				return;
+			}
+
+			std::vector<entt::entity> insertEntities;
+			insertEntities.reserve(entities.size());
+
+			size_t insertCount = 0;
+
+			for (size_t idx = 0; idx < entities.size(); ++idx)
+			{
+				if (storage.contains(entities[idx]))
+				{
+					registry.replace<CompT>(entities[idx], components[idx]);
+				}
+				else
+				{
+					insertEntities.push_back(entities[idx]);
+					components[insertCount++] = components[idx];
+				}
+			}
+
+			registry.insert<CompT>(insertEntities.begin(), insertEntities.end(), components.begin());
+		}
+		else
+		{
+			assert(false && "serialization::InsertRawToRegistry - Component is not trivially copyable");
+		}
+	}
+
+	/*
+	 * Components of one type decoded from json, components are held type erased until they are inserted into registry
+	 *
+	 * Batches are decoded in ranges so a batch can be split across worker threads, only insertion has to be done
+	 * on one thread
+	 */
+	struct ComponentBatch
+	{
+		entt::id_type typeID = 0;
+		std::vector<entt::entity> entities;
+		std::vector<const nlohmann::json*> jsons; // Json of component for entity at same index, nullptr if component couldn't be read & is skipped
+		std::shared_ptr<void> components = nullptr; // std::vector<CompT>, allocated by PrepareBatch
+	};
+
 	template<typename CompT>
-	CompT& DeserializeToRegistry(std::shared_ptr<entt::registry> registry, entt::entity entity, const nlohmann::json& json)
+	void PrepareBatch(ComponentBatch& batch)
 	{
-		return registry->emplace_or_replace<CompT>(entity, Deserialize<CompT>(json));
+		batch.components = std::make_shared<std::vector<CompT>>(batch.jsons.size());
 	}
 
+	// Decode components in range [begin, end), safe to call for separate ranges of a prepared batch concurrently
+	template<typename CompT>
+	void DeserializeBatchRange(ComponentBatch& batch, size_t begin, size_t end)
+	{
+		auto& components = *static_cast<std::vector<CompT>*>(batch.components.get());
+
+		for (size_t idx = begin; idx < end; ++idx)
+		{
+			if (batch.jsons[idx])
+				components[idx] = Deserialize<CompT>(*batch.jsons[idx]);
+		}
+	}
+
+	/*
+	 * Add decoded components to their entities, components new to entities are inserted as one batch, components
+	 * already added (i.e. by construction signals of other components) are replaced
+	 */
+	template<typename CompT>
+	void InsertBatchToRegistry(entt::registry& registry, ComponentBatch& batch)
+	{
+		auto& components = *static_cast<std::vector<CompT>*>(batch.components.get());
+		const auto& storage = registry.storage<CompT>();
+
+		size_t insertCount = 0;
+
+		for (size_t idx = 0; idx < batch.entities.size(); ++idx)
+		{
+			if (!batch.jsons[idx])
+				continue;
+
+			if (storage.contains(batch.entities[idx]))
+			{
+				registry.replace<CompT>(batch.entities[idx], std::move(components[idx]));
+			}
+			else
+			{
+				if (insertCount != idx)
+				{
+					batch.entities[insertCount] = batch.entities[idx];
+					components[insertCount] = std::move(components[idx]);
+				}
+
+				++insertCount;
+			}
+		}
+
+		registry.insert<CompT>(batch.entities.begin(), batch.entities.begin() + insertCount, components.begin());
+
+		batch.components = nullptr;
+	}
+
+	/*
+	 * Serialization functions of a registered component type, resolved once when type is registered so they can be
+	 * called directly instead of being looked up & invoked through entt::meta for every entity
+	 */
+	struct ComponentTypeFuncs
+	{
+		entt::id_type typeID = 0;
+		std::string_view typeString;
+		uint32_t rawSize = 0; // Size of component in binary scene files, 0 if stored as serialized data
+		uint64_t rawLayoutHash = 0;
+
+		bool (*hasComponent)(entt::registry&, entt::entity) = nullptr;
+		nlohmann::json (*serializeFromRegistry)(entt::registry&, entt::entity) = nullptr;
+		void (*serializeStorage)(entt::registry&, const entt::sparse_set*, const SerializeStorageCallback&) = nullptr;
+		void (*serializeStorageRaw)(entt::registry&, const entt::sparse_set*, const SerializeStorageRawCallback&) = nullptr; // Only for types with a raw size
+		void (*deserializeToRegistry)(entt::registry&, entt::entity, const nlohmann::json&) = nullptr;
+		void (*copyComponents)(entt::registry&, const std::vector<entt::entity>&, entt::registry&, const std::vector<entt::entity>&) = nullptr;
+
+		void (*jsonToRaw)(const nlohmann::json&, std::vector<uint8_t>&) = nullptr;
+		nlohmann::json (*rawToJson)(const void*) = nullptr;
+		void (*insertRawToRegistry)(entt::registry&, const std::vector<entt::entity>&, const void*) = nullptr;
+
+		void (*prepareBatch)(ComponentBatch&) = nullptr;
+		void (*deserializeBatchRange)(ComponentBatch&, size_t, size_t) = nullptr;
+		void (*insertBatchToRegistry)(entt::registry&, ComponentBatch&) = nullptr;
+
+		void (*connectChangeListener)(entt::registry&, IComponentChangeListener&) = nullptr;
+	};
+
 	class ComponentRegistry
 	{
 		static ComponentRegistry* sInstance;
@@ -57,11 +456,35 @@ namespace puffin::serialization
 			auto type = entt::resolve<CompT>();
 			auto typeID = type.id();
 
-			if (mRegisteredTypes.find(typeID) == mRegisteredTypes.end())
-			{
-				mRegisteredTypes.insert(typeID);
-				mRegisteredTypesVector.push_back(typeID);
-			}
+			if (mTypeIDToIdx.find(typeID) != mTypeIDToIdx.end())
+				return;
+
+			ComponentTypeFuncs funcs;
+			funcs.typeID = typeID;
+			funcs.typeString = reflection::GetTypeString<CompT>();
+			funcs.rawSize = GetRawSize<CompT>();
+			funcs.rawLayoutHash = GetRawLayoutHash<CompT>();
+
+			funcs.hasComponent = &HasComponent<CompT>;
+			funcs.serializeFromRegistry = &SerializeFromRegistry<CompT>;
+			funcs.serializeStorage = &SerializeStorage<CompT>;
+			funcs.serializeStorageRaw = &SerializeStorageRaw<CompT>;
+			funcs.deserializeToRegistry = &DeserializeToRegistry<CompT>;
+			funcs.copyComponents = &CopyComponents<CompT>;
+
+			funcs.jsonToRaw = &JsonToRaw<CompT>;
+			funcs.rawToJson = &RawToJson<CompT>;
+			funcs.insertRawToRegistry = &InsertRawToRegistry<CompT>;
+
+			funcs.prepareBatch = &PrepareBatch<CompT>;
+			funcs.deserializeBatchRange = &DeserializeBatchRange<CompT>;
+			funcs.insertBatchToRegistry = &InsertBatchToRegistry<CompT>;
+
+			funcs.connectChangeListener = &ConnectChangeListener<CompT>;
+
+			mTypeIDToIdx.emplace(typeID, mTypeFuncs.size());
+			mTypeFuncs.push_back(funcs);
+			mRegisteredTypesVector.push_back(typeID);
 		}
 
 		[[nodiscard]] const std::vector<entt::id_type>& GetRegisteredTypesVector() const
@@ -69,10 +492,25 @@ namespace puffin::serialization
 			return mRegisteredTypesVector;
 		}
 
+		// Functions of each registered type, in registration order
+		[[nodiscard]] const std::deque<ComponentTypeFuncs>& GetTypeFuncs() const
+		{
+			return mTypeFuncs;
+		}
+
+		// Functions of type, nullptr if type hasn't been registered
+		[[nodiscard]] const ComponentTypeFuncs* GetTypeFuncs(entt::id_type typeID) const
+		{
+			const auto it = mTypeIDToIdx.find(typeID);
+
+			return it != mTypeIDToIdx.end() ? &mTypeFuncs[it->second] : nullptr;
+		}
+
 	private:
 
-		std::unordered_set<entt::id_type> mRegisteredTypes;
+		std::unordered_map<entt::id_type, size_t> mTypeIDToIdx;
 		std::vector<entt::id_type> mRegisteredTypesVector;
+		std::deque<ComponentTypeFuncs> mTypeFuncs; // Deque so pointers to funcs stay valid as more types are registered
 
 	};
 
@@ -82,10 +520,6 @@ namespace puffin::serialization
 	template<typename CompT>
 	void RegisterComponentSerializationTypeDefaults(entt::meta_factory<CompT>& meta)
 	{
-		meta.func<&serialization::HasComponent<CompT>>(entt::hs("HasComponent"));
-		meta.func<&serialization::SerializeFromRegistry<CompT>>(entt::hs("SerializeFromRegistry"));
-		meta.func<&serialization::DeserializeToRegistry<CompT>>(entt::hs("DeserializeToRegistry"));
-
 		auto* registry = ComponentRegistry::Get();
 		registry->Register<CompT>();
 	}
@@ -0,0 +1,615 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <vector>
+
+#include "types/uuid.h"
+
+namespace puffin
+{
+	constexpr int32_t gNullTreeNode = -1;
+
+	/*
+	 * Axis aligned bounds used by DynamicAABBTree, Dim is 2 or 3
+	 */
+	template<int Dim>
+	struct TreeBounds
+	{
+		std::array<float, Dim> min = {};
+		std::array<float, Dim> max = {};
+
+		[[nodiscard]] bool Contains(const TreeBounds& other) const
+		{
+			for (int i = 0; i < Dim; ++i)
+			{
+				if (other.min[i] < min[i] || other.max[i] > max[i])
+					return false;
+			}
+
+			return true;
+		}
+
+		[[nodiscard]] bool Overlaps(const TreeBounds& other) const
+		{
+			for (int i = 0; i < Dim; ++i)
+			{
+				if (other.max[i] < min[i] || other.min[i] > max[i])
+					return false;
+			}
+
+			return true;
+		}
+
+		// Perimeter in 2d, surface area in 3d, used as insertion cost
+		[[nodiscard]] float Cost() const
+		{
+			if constexpr (Dim == 2)
+			{
+				return 2.0f * ((max[0] - min[0]) + (max[1] - min[1]));
+			}
+			else
+			{
+				const float x = max[0] - min[0];
+				const float y = max[1] - min[1];
+				const float z = max[2] - min[2];
+
+				return 2.0f * (x * y + y * z + z * x);
+			}
+		}
+
+		// Squared distance from point to closest point on bounds, 0 if point is inside
+		[[nodiscard]] float DistanceSq(const std::array<float, Dim>& point) const
+		{
+			float distanceSq = 0.0f;
+
+			for (int i = 0; i < Dim; ++i)
+			{
+				const float d = std::max({ min[i] - point[i], 0.0f, point[i] - max[i] });
+				distanceSq += d * d;
+			}
+
+			return distanceSq;
+		}
+
+		/*
+		 * Test ray against bounds, direction should be normalized
+		 * Returns true if ray enters bounds within maxDistance, distance is set to entry distance (0 if origin is inside)
+		 */
+		bool Raycast(const std::array<float, Dim>& origin, const std::array<float, Dim>& direction, float maxDistance, float& distance) const
+		{
+			float tMin = 0.0f;
+			float tMax = maxDistance;
+
+			for (int i = 0; i < Dim; ++i)
+			{
+				if (std::abs(direction[i]) < std::numeric_limits<float>::epsilon())
+				{
+					if (origin[i] < min[i] || origin[i] > max[i])
+						return false;
+
+					continue;
+				}
+
+				const float invDirection = 1.0f / direction[i];
+				float t1 = (min[i] - origin[i]) * invDirection;
+				float t2 = (max[i] - origin[i]) * invDirection;
+
+				if (t1 > t2)
+					std::swap(t1, t2);
+
+				tMin = std::max(tMin, t1);
+				tMax = std::min(tMax, t2);
+
+				if (tMin > tMax)
+					return false;
+			}
+
+			distance = tMin;
+
+			return true;
+		}
+
+		static TreeBounds Union(const TreeBounds& a, const TreeBounds& b)
+		{
+			TreeBounds bounds;
+
+			for (int i = 0; i < Dim; ++i)
+			{
+				bounds.min[i] = std::min(a.min[i], b.min[i]);
+				bounds.max[i] = std::max(a.max[i], b.max[i]);
+			}
+
+			return bounds;
+		}
+
+		static TreeBounds Expanded(const TreeBounds& a, float margin)
+		{
+			TreeBounds bounds;
+
+			for (int i = 0; i < Dim; ++i)
+			{
+				bounds.min[i] = a.min[i] - margin;
+				bounds.max[i] = a.max[i] + margin;
+			}
+
+			return bounds;
+		}
+	};
+
+	/*
+	 * Bounding volume hierarchy of proxies, each proxy stores an id & its bounds
+	 *
+	 * Leaves are stored with enlarged (fat) bounds so small movements don't require the tree to be modified,
+	 * tree is kept balanced with rotations as proxies are inserted/removed
+	 */
+	template<int Dim>
+	class DynamicAABBTree
+	{
+	public:
+
+		using Bounds = TreeBounds<Dim>;
+		using Point = std::array<float, Dim>;
+
+		explicit DynamicAABBTree(float margin = 0.1f) : mMargin(margin)
+		{
+		}
+
+		int32_t CreateProxy(const Bounds& bounds, UUID id)
+		{
+			const int32_t proxy = AllocateNode();
+
+			auto& node = mNodes[proxy];
+			node.tight = bounds;
+			node.fat = Bounds::Expanded(bounds, mMargin);
+			node.id = id;
+			node.height = 0;
+
+			InsertLeaf(proxy);
+
+			++mProxyCount;
+
+			return proxy;
+		}
+
+		void DestroyProxy(int32_t proxy)
+		{
+			assert(IsLeaf(proxy) && "DynamicAABBTree::DestroyProxy - Proxy is not a leaf");
+
+			RemoveLeaf(proxy);
+			FreeNode(proxy);
+
+			--mProxyCount;
+		}
+
+		// Update proxy bounds, returns true if proxy had to be reinserted as bounds moved outside of its fat bounds
+		bool MoveProxy(int32_t proxy, const Bounds& bounds)
+		{
+			assert(IsLeaf(proxy) && "DynamicAABBTree::MoveProxy - Proxy is not a leaf");
+
+			mNodes[proxy].tight = bounds;
+
+			if (mNodes[proxy].fat.Contains(bounds))
+				return false;
+
+			RemoveLeaf(proxy);
+
+			mNodes[proxy].fat = Bounds::Expanded(bounds, mMargin);
+
+			InsertLeaf(proxy);
+
+			return true;
+		}
+
+		[[nodiscard]] const Bounds& GetBounds(int32_t proxy) const
+		{
+			return mNodes[proxy].tight;
+		}
+
+		[[nodiscard]] UUID GetID(int32_t proxy) const
+		{
+			return mNodes[proxy].id;
+		}
+
+		/*
+		 * Call func(proxy) for each proxy whose bounds overlap bounds, return false from func to stop query
+		 */
+		template<typename Func>
+		void Query(const Bounds& bounds, const Func& func) const
+		{
+			if (mRoot == gNullTreeNode)
+				return;
+
+			std::vector<int32_t> stack;
+			stack.push_back(mRoot);
+
+			while (!stack.empty())
+			{
+				const int32_t idx = stack.back();
+				stack.pop_back();
+
+				const auto& node = mNodes[idx];
+
+				if (node.IsLeaf())
+				{
+					if (node.tight.Overlaps(bounds) && !func(idx))
+						return;
+				}
+				else if (node.fat.Overlaps(bounds))
+				{
+					stack.push_back(node.child1);
+					stack.push_back(node.child2);
+				}
+			}
+		}
+
+		/*
+		 * Call func(proxy, distance) for each proxy whose bounds are hit by ray, direction should be normalized
+		 * func returns max distance for rest of raycast, return distance to only look for closer hits or 0 to stop raycast
+		 */
+		template<typename Func>
+		void Raycast(const Point& origin, const Point& direction, float maxDistance, const Func& func) const
+		{
+			if (mRoot == gNullTreeNode)
+				return;
+
+			std::vector<int32_t> stack;
+			stack.push_back(mRoot);
+
+			while (!stack.empty())
+			{
+				const int32_t idx = stack.back();
+				stack.pop_back();
+
+				const auto& node = mNodes[idx];
+				float distance = 0.0f;
+
+				if (node.IsLeaf())
+				{
+					if (!node.tight.Raycast(origin, direction, maxDistance, distance))
+						continue;
+
+					maxDistance = func(idx, distance);
+
+					if (maxDistance <= 0.0f)
+						return;
+				}
+				else if (node.fat.Raycast(origin, direction, maxDistance, distance))
+				{
+					stack.push_back(node.child1);
+					stack.push_back(node.child2);
+				}
+			}
+		}
+
+		/*
+		 * Find up to k proxies closest to point, proxies are sorted by distance, closest first
+		 */
+		void KNearest(const Point& point, uint32_t k, std::vector<int32_t>& proxies) const
+		{
+			proxies.clear();
+
+			if (mRoot == gNullTreeNode || k == 0)
+				return;
+
+			using QueueEntry = std::pair<float, int32_t>;
+
+			// Nodes are visited closest first, fat bounds of internal nodes are a lower bound for all of their leaves
+			// so once a leaf reaches front of queue no unvisited proxy can be closer
+			std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+			queue.emplace(mNodes[mRoot].IsLeaf() ? mNodes[mRoot].tight.DistanceSq(point) : mNodes[mRoot].fat.DistanceSq(point), mRoot);
+
+			while (!queue.empty() && proxies.size() < k)
+			{
+				const int32_t idx = queue.top().second;
+				queue.pop();
+
+				const auto& node = mNodes[idx];
+
+				if (node.IsLeaf())
+				{
+					proxies.push_back(idx);
+					continue;
+				}
+
+				for (const int32_t childIdx : { node.child1, node.child2 })
+				{
+					const auto& child = mNodes[childIdx];
+
+					queue.emplace(child.IsLeaf() ? child.tight.DistanceSq(point) : child.fat.DistanceSq(point), childIdx);
+				}
+			}
+		}
+
+		void Clear()
+		{
+			mNodes.clear();
+			mRoot = gNullTreeNode;
+			mFreeList = gNullTreeNode;
+			mProxyCount = 0;
+		}
+
+		[[nodiscard]] uint32_t Count() const
+		{
+			return mProxyCount;
+		}
+
+		// Height of tree, 0 if tree only contains a single proxy, -1 if tree is empty
+		[[nodiscard]] int32_t GetHeight() const
+		{
+			return mRoot != gNullTreeNode ? mNodes[mRoot].height : -1;
+		}
+
+	private:
+
+		struct TreeNode
+		{
+			Bounds fat; // Bounds of leaf enlarged by margin, or union of children bounds
+			Bounds tight; // Actual bounds of leaf
+
+			UUID id = gInvalidID;
+
+			int32_t parent = gNullTreeNode; // Next node in free list when node is unused
+			int32_t child1 = gNullTreeNode;
+			int32_t child2 = gNullTreeNode;
+			int32_t height = -1; // 0 for leaves, -1 for unused nodes
+
+			[[nodiscard]] bool IsLeaf() const
+			{
+				return child1 == gNullTreeNode;
+			}
+		};
+
+		[[nodiscard]] bool IsLeaf(int32_t idx) const
+		{
+			return idx >= 0 && idx < static_cast<int32_t>(mNodes.size()) && mNodes[idx].height == 0;
+		}
+
+		int32_t AllocateNode()
+		{
+			int32_t idx;
+
+			if (mFreeList != gNullTreeNode)
+			{
+				idx = mFreeList;
+				mFreeList = mNodes[idx].parent;
+			}
+			else
+			{
+				idx = static_cast<int32_t>(mNodes.size());
+				mNodes.emplace_back();
+			}
+
+			mNodes[idx] = TreeNode();
+
+			return idx;
+		}
+
+		void FreeNode(int32_t idx)
+		{
+			mNodes[idx].parent = mFreeList;
+			mNodes[idx].height = -1;
+			mNodes[idx].id = gInvalidID;
+
+			mFreeList = idx;
+		}
+
+		void InsertLeaf(int32_t leaf)
+		{
+			if (mRoot == gNullTreeNode)
+			{
+				mRoot = leaf;
+				mNodes[leaf].parent = gNullTreeNode;
+				return;
+			}
+
+			// Find best sibling for leaf, descending while it's cheaper to push leaf further down
+			const Bounds leafBounds = mNodes[leaf].fat;
+			int32_t idx = mRoot;
+
+			while (!mNodes[idx].IsLeaf())
+			{
+				const int32_t child1 = mNodes[idx].child1;
+				const int32_t child2 = mNodes[idx].child2;
+
+				const float cost = mNodes[idx].fat.Cost();
+				const float combinedCost = Bounds::Union(mNodes[idx].fat, leafBounds).Cost();
+
+				// Cost of creating a new parent for this node and the new leaf
+				const float siblingCost = 2.0f * combinedCost;
+
+				// Minimum cost of pushing leaf further down the tree
+				const float inheritanceCost = 2.0f * (combinedCost - cost);
+
+				const float cost1 = DescendCost(child1, leafBounds) + inheritanceCost;
+				const float cost2 = DescendCost(child2, leafBounds) + inheritanceCost;
+
+				if (siblingCost < cost1 && siblingCost < cost2)
+					break;
+
+				idx = cost1 < cost2 ? child1 : child2;
+			}
+
+			const int32_t sibling = idx;
+
+			// Create new parent for leaf & sibling
+			const int32_t oldParent = mNodes[sibling].parent;
+			const int32_t newParent = AllocateNode();
+
+			mNodes[newParent].parent = oldParent;
+			mNodes[newParent].fat = Bounds::Union(leafBounds, mNodes[sibling].fat);
+			mNodes[newParent].height = mNodes[sibling].height + 1;
+			mNodes[newParent].child1 = sibling;
+			mNodes[newParent].child2 = leaf;
+
+			if (oldParent != gNullTreeNode)
+			{
+				if (mNodes[oldParent].child1 == sibling)
+					mNodes[oldParent].child1 = newParent;
+				else
+					mNodes[oldParent].child2 = newParent;
+			}
+			else
+			{
+				mRoot = newParent;
+			}
+
+			mNodes[sibling].parent = newParent;
+			mNodes[leaf].parent = newParent;
+
+			RefitAncestors(mNodes[leaf].parent);
+		}
+
+		void RemoveLeaf(int32_t leaf)
+		{
+			if (leaf == mRoot)
+			{
+				mRoot = gNullTreeNode;
+				return;
+			}
+
+			const int32_t parent = mNodes[leaf].parent;
+			const int32_t grandParent = mNodes[parent].parent;
+			const int32_t sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+			// Replace parent with sibling
+			if (grandParent != gNullTreeNode)
+			{
+				if (mNodes[grandParent].child1 == parent)
+					mNodes[grandParent].child1 = sibling;
+				else
+					mNodes[grandParent].child2 = sibling;
+
+				mNodes[sibling].parent = grandParent;
+				FreeNode(parent);
+
+				RefitAncestors(grandParent);
+			}
+			else
+			{
+				mRoot = sibling;
+				mNodes[sibling].parent = gNullTreeNode;
+				FreeNode(parent);
+			}
+
+			mNodes[leaf].parent = gNullTreeNode;
+		}
+
+		[[nodiscard]] float DescendCost(int32_t idx, const Bounds& leafBounds) const
+		{
+			const float combinedCost = Bounds::Union(leafBounds, mNodes[idx].fat).Cost();
+
+			if (mNodes[idx].IsLeaf())
+				return combinedCost;
+
+			return combinedCost - mNodes[idx].fat.Cost();
+		}
+
+		// Walk up from idx, rebalancing and recalculating bounds/height of each node
+		void RefitAncestors(int32_t idx)
+		{
+			while (idx != gNullTreeNode)
+			{
+				idx = Balance(idx);
+
+				auto& node = mNodes[idx];
+				const auto& child1 = mNodes[node.child1];
+				const auto& child2 = mNodes[node.child2];
+
+				node.height = 1 + std::max(child1.height, child2.height);
+				node.fat = Bounds::Union(child1.fat, child2.fat);
+
+				idx = node.parent;
+			}
+		}
+
+		// Rotate idx if its children heights differ by more than 1, returns index of node now at position of idx
+		int32_t Balance(int32_t idxA)
+		{
+			if (mNodes[idxA].IsLeaf() || mNodes[idxA].height < 2)
+				return idxA;
+
+			const int32_t idxB = mNodes[idxA].child1;
+			const int32_t idxC = mNodes[idxA].child2;
+
+			const int32_t balance = mNodes[idxC].height - mNodes[idxB].height;
+
+			// Rotate C up
+			if (balance > 1)
+			{
+				RotateUp(idxA, idxC, idxB, false);
+				return idxC;
+			}
+
+			// Rotate B up
+			if (balance < -1)
+			{
+				RotateUp(idxA, idxB, idxC, true);
+				return idxB;
+			}
+
+			return idxA;
+		}
+
+		/*
+		 * Rotate child up to replace A, the shallower of child's children is given to A in place of child
+		 * isChild1 - Whether child is A's first child
+		 */
+		void RotateUp(int32_t idxA, int32_t idxChild, int32_t idxOther, bool isChild1)
+		{
+			const int32_t idxF = mNodes[idxChild].child1;
+			const int32_t idxG = mNodes[idxChild].child2;
+
+			// Swap A and child
+			mNodes[idxChild].child1 = idxA;
+			mNodes[idxChild].parent = mNodes[idxA].parent;
+			mNodes[idxA].parent = idxChild;
+
+			const int32_t parent = mNodes[idxChild].parent;
+
+			if (parent != gNullTreeNode)
+			{
+				if (mNodes[parent].child1 == idxA)
+					mNodes[parent].child1 = idxChild;
+				else
+					mNodes[parent].child2 = idxChild;
+			}
+			else
+			{
+				mRoot = idxChild;
+			}
+
+			// Deeper grandchild stays with child, shallower one replaces child under A
+			const bool keepF = mNodes[idxF].height > mNodes[idxG].height;
+			const int32_t idxKept = keepF ? idxF : idxG;
+			const int32_t idxMoved = keepF ? idxG : idxF;
+
+			mNodes[idxChild].child2 = idxKept;
+
+			if (isChild1)
+				mNodes[idxA].child1 = idxMoved;
+			else
+				mNodes[idxA].child2 = idxMoved;
+
+			mNodes[idxMoved].parent = idxA;
+
+			mNodes[idxA].fat = Bounds::Union(mNodes[idxOther].fat, mNodes[idxMoved].fat);
+			mNodes[idxA].height = 1 + std::max(mNodes[idxOther].height, mNodes[idxMoved].height);
+
+			mNodes[idxChild].fat = Bounds::Union(mNodes[idxA].fat, mNodes[idxKept].fat);
+			mNodes[idxChild].height = 1 + std::max(mNodes[idxA].height, mNodes[idxKept].height);
+		}
+
+		std::vector<TreeNode> mNodes;
+		int32_t mRoot = gNullTreeNode;
+		int32_t mFreeList = gNullTreeNode;
+		uint32_t mProxyCount = 0;
+		float mMargin = 0.1f;
+
+	};
+}
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace puffin
+{
+	/*
+	 * Pool of objects stored in fixed size chunks, objects never move once constructed
+	 * so pointers to them stay valid until they are freed
+	 *
+	 * Each object is addressed by a slot index (chunk index * ChunkSize + offset in chunk),
+	 * chunks are allocated on demand and released once all of their objects have been freed
+	 */
+	template<typename T, uint32_t ChunkSize = 256>
+	class ChunkedPool
+	{
+	public:
+
+		ChunkedPool() = default;
+
+		~ChunkedPool()
+		{
+			Clear();
+		}
+
+		ChunkedPool(const ChunkedPool&) = delete;
+		ChunkedPool& operator=(const ChunkedPool&) = delete;
+
+		// Construct a new object in a free slot, returns slot index of object
+		template<typename... Args>
+		uint32_t Emplace(Args&&... args)
+		{
+			if (mChunksWithSpace.empty())
+				AllocateChunk();
+
+			const uint32_t chunkIdx = mChunksWithSpace.back();
+			Chunk& chunk = *mChunks[chunkIdx];
+
+			const uint32_t offset = chunk.freeOffsets.back();
+			chunk.freeOffsets.pop_back();
+
+			new (chunk.Raw(offset)) T(std::forward<Args>(args)...);
+			chunk.alive[offset] = true;
+
+			if (chunk.freeOffsets.empty())
+				mChunksWithSpace.pop_back();
+
+			++mCount;
+
+			return chunkIdx * ChunkSize + offset;
+		}
+
+		// Destroy object in slot, chunk is released if it is empty and another chunk still has space
+		void Erase(uint32_t slot)
+		{
+			assert(IsAlive(slot) && "ChunkedPool::Erase - Slot does not contain an object");
+
+			const uint32_t chunkIdx = slot / ChunkSize;
+			const uint32_t offset = slot % ChunkSize;
+			Chunk& chunk = *mChunks[chunkIdx];
+
+			chunk.Ptr(offset)->~T();
+			chunk.alive[offset] = false;
+
+			if (chunk.freeOffsets.empty())
+				mChunksWithSpace.push_back(chunkIdx);
+
+			chunk.freeOffsets.push_back(offset);
+
+			--mCount;
+
+			// Keep one empty chunk around so spawning/destroying a single object doesn't allocate every time
+			if (chunk.freeOffsets.size() == ChunkSize && mChunksWithSpace.size() > 1)
+				ReleaseChunk(chunkIdx);
+		}
+
+		[[nodiscard]] bool IsAlive(uint32_t slot) const
+		{
+			const uint32_t chunkIdx = slot / ChunkSize;
+
+			return chunkIdx < mChunks.size() && mChunks[chunkIdx] && mChunks[chunkIdx]->alive[slot % ChunkSize];
+		}
+
+		T& At(uint32_t slot)
+		{
+			assert(IsAlive(slot) && "ChunkedPool::At - Slot does not contain an object");
+
+			return *mChunks[slot / ChunkSize]->Ptr(slot % ChunkSize);
+		}
+
+		const T& At(uint32_t slot) const
+		{
+			assert(IsAlive(slot) && "ChunkedPool::At - Slot does not contain an object");
+
+			return *mChunks[slot / ChunkSize]->Ptr(slot % ChunkSize);
+		}
+
+		// Make sure there are enough free slots to emplace count objects without allocating
+		void Reserve(uint32_t count)
+		{
+			uint32_t freeSlots = 0;
+
+			for (const auto chunkIdx : mChunksWithSpace)
+			{
+				freeSlots += static_cast<uint32_t>(mChunks[chunkIdx]->freeOffsets.size());
+			}
+
+			while (freeSlots < count)
+			{
+				AllocateChunk();
+
+				freeSlots += ChunkSize;
+			}
+		}
+
+		/*
+		 * Call func(T&) for each object in slot range [start, end), slots without an object are skipped
+		 * Chunks are looked up on each call so objects emplaced by func don't invalidate iteration
+		 */
+		template<typename Func>
+		void ForEach(uint32_t start, uint32_t end, const Func& func)
+		{
+			for (uint32_t slot = start; slot < end; ++slot)
+			{
+				const uint32_t chunkIdx = slot / ChunkSize;
+
+				if (!mChunks[chunkIdx])
+				{
+					// Skip to start of next chunk
+					slot = (chunkIdx + 1) * ChunkSize - 1;
+					continue;
+				}
+
+				Chunk& chunk = *mChunks[chunkIdx];
+				const uint32_t offset = slot % ChunkSize;
+
+				if (chunk.alive[offset])
+					func(*chunk.Ptr(offset));
+			}
+		}
+
+		template<typename Func>
+		void ForEach(const Func& func)
+		{
+			ForEach(0, SlotCount(), func);
+		}
+
+		// Destroy all objects, allocated chunks are kept for reuse
+		void Reset()
+		{
+			mChunksWithSpace.clear();
+
+			for (uint32_t chunkIdx = 0; chunkIdx < mChunks.size(); ++chunkIdx)
+			{
+				if (mChunks[chunkIdx])
+				{
+					mChunks[chunkIdx]->DestroyAll();
+
+					mChunksWithSpace.push_back(chunkIdx);
+				}
+			}
+
+			mCount = 0;
+		}
+
+		// Destroy all objects and release all chunks
+		void Clear()
+		{
+			for (auto& chunk : mChunks)
+			{
+				if (chunk)
+					chunk->DestroyAll();
+			}
+
+			mChunks.clear();
+			mChunksWithSpace.clear();
+			mReleasedChunks.clear();
+
+			mCount = 0;
+		}
+
+		// Number of live objects
+		[[nodiscard]] uint32_t Count() const
+		{
+			return mCount;
+		}
+
+		// Number of addressable slots, slot indices of live objects are always less than this
+		[[nodiscard]] uint32_t SlotCount() const
+		{
+			return static_cast<uint32_t>(mChunks.size()) * ChunkSize;
+		}
+
+		// Number of chunks currently allocated
+		[[nodiscard]] uint32_t ChunkCount() const
+		{
+			return static_cast<uint32_t>(mChunks.size() - mReleasedChunks.size());
+		}
+
+	private:
+
+		struct Chunk
+		{
+			Chunk()
+			{
+				freeOffsets.reserve(ChunkSize);
+
+				// Stored in reverse so lower offsets are used first
+				for (uint32_t i = ChunkSize; i > 0; --i)
+				{
+					freeOffsets.push_back(i - 1);
+				}
+			}
+
+			~Chunk()
+			{
+				DestroyAll();
+			}
+
+			void* Raw(uint32_t offset)
+			{
+				return storage + sizeof(T) * offset;
+			}
+
+			T* Ptr(uint32_t offset)
+			{
+				return std::launder(reinterpret_cast<T*>(Raw(offset)));
+			}
+
+			void DestroyAll()
+			{
+				freeOffsets.clear();
+
+				for (uint32_t i = ChunkSize; i > 0; --i)
+				{
+					if (alive[i - 1])
+					{
+						Ptr(i - 1)->~T();
+						alive[i - 1] = false;
+					}
+
+					freeOffsets.push_back(i - 1);
+				}
+			}
+
+			alignas(T) unsigned char storage[sizeof(T) * ChunkSize];
+			bool alive[ChunkSize] = {};
+			std::vector<uint32_t> freeOffsets; // Stack of unused offsets in this chunk
+		};
+
+		void AllocateChunk()
+		{
+			uint32_t chunkIdx;
+
+			// Reuse index of a released chunk so slot range doesn't keep growing under churn
+			if (!mReleasedChunks.empty())
+			{
+				chunkIdx = mReleasedChunks.back();
+				mReleasedChunks.pop_back();
+			}
+			else
+			{
+				chunkIdx = static_cast<uint32_t>(mChunks.size());
+				mChunks.emplace_back();
+			}
+
+			mChunks[chunkIdx] = std::make_unique<Chunk>();
+			mChunksWithSpace.push_back(chunkIdx);
+		}
+
+		void ReleaseChunk(uint32_t chunkIdx)
+		{
+			for (auto it = mChunksWithSpace.begin(); it != mChunksWithSpace.end(); ++it)
+			{
+				if (*it == chunkIdx)
+				{
+					mChunksWithSpace.erase(it);
+					break;
+				}
+			}
+
+			mChunks[chunkIdx].reset();
+			mReleasedChunks.push_back(chunkIdx);
+		}
+
+		std::vector<std::unique_ptr<Chunk>> mChunks; // Released chunks are left as nullptr so slot indices stay valid
+		std::vector<uint32_t> mChunksWithSpace; // Indices of allocated chunks with at least one free slot
+		std::vector<uint32_t> mReleasedChunks; // Indices of released chunks, reused before growing mChunks
+		uint32_t mCount = 0;
+
+	};
+}
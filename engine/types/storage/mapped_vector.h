@@ -114,10 +114,12 @@ namespace puffin
 			mData.resize(newSize);
 		}
 
-		// Reserve space in internal vector
+		// Reserve space in internal vector & key/index maps
 		void Reserve(const size_t newSize)
 		{
 			mData.reserve(newSize);
+			mKeyToIdx.reserve(newSize);
+			mIdxToKey.reserve(newSize);
 		}
 
 		// Shrink internal vector capacity to match size
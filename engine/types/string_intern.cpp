@@ -0,0 +1,60 @@
+#include "types/string_intern.h"
+
+#include <cassert>
+#include <mutex>
+
+namespace puffin
+{
+	StringInternTable::StringInternTable()
+	{
+		mStrings.emplace_back();
+		mStringToID.emplace(mStrings.back(), gEmptyStringID);
+	}
+
+	StringInternTable* StringInternTable::Get()
+	{
+		// Function local static, so first use from several threads at once only creates one table
+		static StringInternTable* instance = new StringInternTable();
+
+		return instance;
+	}
+
+	StringID StringInternTable::Intern(std::string_view string)
+	{
+		{
+			std::shared_lock lock(mMutex);
+
+			if (const auto it = mStringToID.find(string); it != mStringToID.end())
+				return it->second;
+		}
+
+		std::unique_lock lock(mMutex);
+
+		// String may have been interned by another thread while lock was released
+		if (const auto it = mStringToID.find(string); it != mStringToID.end())
+			return it->second;
+
+		const auto id = static_cast<StringID>(mStrings.size());
+
+		mStrings.emplace_back(string);
+		mStringToID.emplace(mStrings.back(), id);
+
+		return id;
+	}
+
+	const std::string& StringInternTable::Resolve(StringID id) const
+	{
+		std::shared_lock lock(mMutex);
+
+		assert(id < mStrings.size() && "StringInternTable::Resolve - Invalid string id");
+
+		return mStrings[id];
+	}
+
+	uint32_t StringInternTable::Count() const
+	{
+		std::shared_lock lock(mMutex);
+
+		return static_cast<uint32_t>(mStrings.size());
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace puffin
+{
+	using StringID = uint32_t;
+
+	constexpr StringID gEmptyStringID = 0; // Handle of empty string, always present in table
+
+	/*
+	 * Global table of interned strings, each unique string is stored once and referred to by a 32 bit handle
+	 * Strings are never removed, so references returned by Resolve stay valid for lifetime of program
+	 *
+	 * Safe to intern/resolve from multiple threads
+	 */
+	class StringInternTable
+	{
+		StringInternTable();
+
+	public:
+
+		~StringInternTable() = default;
+
+		// Table is created on first use & never destroyed, so resolved strings outlive any static that refers to them
+		static StringInternTable* Get();
+
+		// Get handle of string, adding it to table if it isn't already interned
+		StringID Intern(std::string_view string);
+
+		[[nodiscard]] const std::string& Resolve(StringID id) const;
+
+		[[nodiscard]] uint32_t Count() const;
+
+	private:
+
+		mutable std::shared_mutex mMutex;
+
+		std::deque<std::string> mStrings; // Deque so stored strings never move as table grows
+		std::unordered_map<std::string_view, StringID> mStringToID; // Keys view strings in mStrings
+
+	};
+
+	inline StringID InternString(std::string_view string)
+	{
+		return StringInternTable::Get()->Intern(string);
+	}
+
+	inline const std::string& ResolveString(StringID id)
+	{
+		return StringInternTable::Get()->Resolve(id);
+	}
+}
@@ -5,9 +5,9 @@
 
 namespace puffin
 {
-	static std::random_device randomDevice;
-	static std::mt19937_64 randEngine(randomDevice());
-	static std::uniform_int_distribution<uint64_t> uniformDistribution;
+	// Thread local so ids can be generated from worker threads
+	static thread_local std::mt19937_64 randEngine(std::random_device{}());
+	static thread_local std::uniform_int_distribution<uint64_t> uniformDistribution;
 
     using UUID = uint_least64_t;
 	constexpr static UUID gInvalidID = 0;
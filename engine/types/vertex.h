@@ -66,13 +66,14 @@ namespace puffin::rendering
 		Vector3f normal = { 0.0f, 0.0f, 0.0f };
 		float uvY;
 		Vector3f tangent = { 0.0f, 0.0f, 0.0f };
-		float pad0;
+		float tangentSign = 1.0f; // Handedness of tangent space, bitangent = cross(normal, tangent) * tangentSign
 
 		bool operator==(const VertexPNTV32& other) const
 		{
 			return pos == other.pos
 				&& normal == other.normal
 				&& tangent == other.tangent
+				&& tangentSign == other.tangentSign
 				&& uvX == other.uvX
 				&& uvY == other.uvY;
 		}
@@ -162,6 +163,7 @@ namespace std
 			return (hash<puffin::Vector3f>()(vertex.pos) ^
 				(hash<puffin::Vector3f>()(vertex.normal) << 1) ^
 				(hash<puffin::Vector3f>()(vertex.tangent) << 1) ^
+				(hash<float>()(vertex.tangentSign) << 1) ^
 				(hash<puffin::Vector2f>()(vertex.uvX) << 1) ^
 				(hash<puffin::Vector2f>()(vertex.uvY) << 1) >> 1);
 		}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace puffin::utility
+{
+    /*
+     * Read only memory mapping of a file, file is unmapped when object is destroyed
+     */
+    class MappedFile
+    {
+    public:
+
+        MappedFile() = default;
+        explicit MappedFile(const fs::path& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        // Map file, closing any previously mapped file, returns false if file could not be mapped
+        bool Open(const fs::path& path);
+        void Close();
+
+        [[nodiscard]] bool IsOpen() const;
+        [[nodiscard]] const uint8_t* Data() const;
+        [[nodiscard]] size_t Size() const;
+
+    private:
+
+        void Swap(MappedFile& other) noexcept;
+
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+
+#ifdef _WIN32
+        void* m_fileHandle = nullptr;
+        void* m_mappingHandle = nullptr;
+#endif
+
+    };
+}
@@ -42,8 +42,12 @@ namespace puffin::rendering
 
 		subsystemManager->CreateAndInitializeSubsystem<core::SettingsManager>();
 		subsystemManager->CreateAndInitializeSubsystem<core::SignalSubsystem>();
+		auto enttSubsystem = subsystemManager->CreateAndInitializeSubsystem<ecs::EnTTSubsystem>();
 
 		InitSettingsAndSignals();
+
+		// Sprites own their storage, transforms are owned by physics backends so are only fetched
+		enttSubsystem->RegisterGroup<SpriteComponent2D>(entt::get<TransformComponent2D>);
 	}
 
 	void Raylib2DRenderSubsystem::Deinitialize()
@@ -240,9 +244,9 @@ namespace puffin::rendering
 		const auto enttSubsystem = m_engine->GetSubsystem<ecs::EnTTSubsystem>();
 		const auto registry = enttSubsystem->GetRegistry();
 
-		const auto& spriteView = registry->view<const TransformComponent2D, const SpriteComponent2D>();
+		const auto spriteGroup = registry->group<SpriteComponent2D>(entt::get<TransformComponent2D>);
 
-		for (auto& [entity, transform, sprite] : spriteView.each())
+		for (const auto& [entity, sprite, transform] : spriteGroup.each())
 		{
 			raylib::Color colour(std::round(sprite.colour.x * 255),
 				std::round(sprite.colour.y * 255),
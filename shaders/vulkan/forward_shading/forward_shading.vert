@@ -25,6 +25,7 @@ struct Vertex
 	vec3 normal;
 	float uvY;
 	vec3 tangent;
+	float tangentSign;
 };
 
 layout(buffer_reference, std430) readonly buffer VertexBuffer{ 
@@ -19,6 +19,7 @@ struct Vertex
 	vec3 normal;
 	float uvY;
 	vec3 tangent;
+	float tangentSign;
 };
 
 layout(buffer_reference, std430) readonly buffer VertexBuffer{ 